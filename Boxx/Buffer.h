@@ -6,6 +6,8 @@
 #include "List.h"
 #include "Array.h"
 #include "Error.h"
+#include "Compression.h"
+#include "Hash.h"
 
 ///[Settings] block: indent
 
@@ -41,6 +43,13 @@ namespace Boxx {
 		/// Creates a buffer with a specific capacity.
 		explicit Buffer(const UInt capacity);
 
+		/// Creates a buffer that uses an array as its data.
+		///[para] The array is shared with the buffer and is not copied.
+		///[Arg] data: The array to use as the data of the buffer.
+		/// The capacity of the buffer is the length of the array.
+		///[Arg] size: The number of bytes at the start of the array that contain data.
+		explicit Buffer(const Array<UByte>& data, const UInt size);
+
 		Buffer(const Buffer& buffer);
 		Buffer(Buffer&& buffer) noexcept;
 		~Buffer();
@@ -73,10 +82,29 @@ namespace Boxx {
 		///[Arg] bytes: The number of bytes to read from the buffer as a string.
 		///[Error] BufferReadError: Thrown if the buffer does not contain enough bytes to read.
 		String ReadString(const UInt bytes);
+
+		/// Writes raw bytes to the current position of the buffer and advances the position to the next byte after the written bytes.
+		///[Arg] data: The bytes to write to the buffer.
+		///[Arg] size: The number of bytes to write.
+		void WriteBytes(const UByte* const data, const UInt size);
+
+		/// Compresses the entire buffer to an LZ4 frame.
+		///[Arg] level: The compression level.
+		///[Returns] Buffer: A new buffer with the compressed data.
+		Buffer Compress(const CompressionLevel level = CompressionLevel::Fast) const;
+
+		/// Decompresses the entire buffer from one or more LZ4 frames.
+		///[Returns] Buffer: A new buffer with the decompressed data.
+		///[Error] CompressionError: Thrown if the buffer does not contain valid compressed data.
+		Buffer Decompress() const;
 		
 		/// Converts the entire binary buffer data to a string.
 		String ToString() const;
 
+		/// Gets a pointer to the binary data of the buffer.
+		///[para] The pointer is invalidated if the buffer grows.
+		const UByte* Data() const;
+
 		/// Returns the size of the buffer in bytes.
 		UInt Size() const;
 
@@ -151,6 +179,17 @@ namespace Boxx {
 		data = Array<UByte>(capacity);
 	}
 
+	inline Buffer::Buffer(const Array<UByte>& data, const UInt size) {
+		if (data.Length() > 0) {
+			this->data = data;
+			this->size = size < data.Length() ? size : data.Length();
+			capacity = data.Length();
+		}
+		else {
+			this->data = Array<UByte>(capacity);
+		}
+	}
+
 	inline Buffer::Buffer(const Buffer& buffer) {
 		size = buffer.size;
 		capacity = buffer.capacity;
@@ -227,7 +266,7 @@ namespace Boxx {
 	}
 
 	inline String Buffer::ReadString(const UInt bytes) {
-		if (currentPos + bytes > size)
+		if (bytes > size - currentPos)
 			throw BufferReadError("Not enough bytes to read");
 
 		String s = String(&(((const char*)(const UByte*)data)[currentPos]), bytes);
@@ -235,10 +274,54 @@ namespace Boxx {
 		return s;
 	}
 
+	inline void Buffer::WriteBytes(const UByte* const data, const UInt size) {
+		while (size + currentPos > capacity) {
+			Grow();
+		}
+
+		if (size > 0) {
+			std::memcpy(&this->data[currentPos], data, size);
+		}
+
+		currentPos += size;
+		if (currentPos > this->size) this->size = currentPos;
+	}
+
+	inline Buffer Buffer::Compress(const CompressionLevel level) const {
+		CompressionEncoder encoder(level);
+		Buffer buffer = Buffer(encoder.FrameBound(size));
+
+		const auto output = [&buffer](const UByte* const data, const UInt size) {
+			buffer.WriteBytes(data, size);
+		};
+
+		encoder.Write(Data(), size, output);
+		encoder.Finish(output);
+		buffer.SetPos(0);
+		return buffer;
+	}
+
+	inline Buffer Buffer::Decompress() const {
+		CompressionDecoder decoder;
+		Buffer buffer = Buffer(size > 0 ? size * 2 : 16);
+
+		decoder.Write(Data(), size, [&buffer](const UByte* const data, const UInt size) {
+			buffer.WriteBytes(data, size);
+		});
+
+		decoder.Finish();
+		buffer.SetPos(0);
+		return buffer;
+	}
+
 	inline String Buffer::ToString() const {
 		return String((const char*)(const UByte*)data, size);
 	}
 
+	inline const UByte* Buffer::Data() const {
+		return (const UByte*)data;
+	}
+
 	inline UInt Buffer::Size() const {
 		return size;
 	}
@@ -272,7 +355,7 @@ namespace Boxx {
 	}
 
 	inline void Buffer::Grow() {
-		capacity *= 2;
+		capacity = capacity > 0 ? capacity * 2 : 16;
 		Array<UByte> newData = Array<UByte>(capacity);
 		std::memcpy((UByte*)newData, (const UByte*)data, sizeof(char) * size);
 		data = newData;
@@ -287,6 +370,30 @@ namespace Boxx {
 
 		return source != target;
 	}
+
+	inline UInt Hash::CRC32C(const Buffer& buffer, const UInt crc) {
+		return CRC32C(buffer.Data(), buffer.Size(), crc);
+	}
+
+	inline UInt Hash::XXH32(const Buffer& buffer, const UInt seed) {
+		return XXH32(buffer.Data(), buffer.Size(), seed);
+	}
+
+	inline ULong Hash::XXH64(const Buffer& buffer, const ULong seed) {
+		return XXH64(buffer.Data(), buffer.Size(), seed);
+	}
+
+	inline void CRC32CHasher::Update(const Buffer& buffer) {
+		Update(buffer.Data(), buffer.Size());
+	}
+
+	inline void XXH32Hasher::Update(const Buffer& buffer) {
+		Update(buffer.Data(), buffer.Size());
+	}
+
+	inline void XXH64Hasher::Update(const Buffer& buffer) {
+		Update(buffer.Data(), buffer.Size());
+	}
 }
 
 #endif
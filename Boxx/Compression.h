@@ -0,0 +1,853 @@
+#ifndef _BOXX_COMPRESSION_HEADER
+#define _BOXX_COMPRESSION_HEADER
+
+#include <cstring>
+#include <vector>
+#include <algorithm>
+
+#include "Types.h"
+#include "String.h"
+#include "Array.h"
+#include "Error.h"
+#include "Hash.h"
+
+///[Settings] block: indent
+
+///[Namespace] Boxx
+namespace Boxx {
+	///[Heading] Compression
+
+	///[Title] CompressionLevel
+	/// The compression level to use.
+	///[Block] CompressionLevel
+	enum class CompressionLevel : UByte {
+		/// Compresses as fast as possible.
+		Fast,
+
+		/// Searches more match candidates for a better compression ratio.
+		/// Compression is several times slower but decompression is just as fast.
+		High
+	};
+
+	///[Title] Compression
+	/// Static class for LZ4 compatible block compression.
+	///[para] Use {CompressionEncoder} and {CompressionDecoder} to work with the LZ4 frame format.
+	///[Block] Compression
+	class Compression final {
+	public:
+		Compression() = delete;
+
+		///[Heading] Static Functions
+
+		/// Gets the maximum size of a compressed block.
+		static UInt CompressBound(const UInt size);
+
+		/// Compresses a block of data in the LZ4 block format.
+		///[Arg] data: The data to compress.
+		///[Arg] size: The size of the data in bytes.
+		///[Arg] output: The array to write the compressed data to.
+		///[Arg] capacity: The size of the output array in bytes.
+		///[Arg] level: The compression level.
+		///[Returns] UInt: The size of the compressed data.
+		/// {0} if the compressed data does not fit in the output array.
+		static UInt CompressBlock(const UByte* const data, const UInt size, UByte* const output, const UInt capacity, const CompressionLevel level = CompressionLevel::Fast);
+
+		/// Decompresses a block of data in the LZ4 block format.
+		///[Arg] data: The compressed data.
+		///[Arg] size: The size of the compressed data in bytes.
+		///[Arg] output: The array to write the decompressed data to.
+		///[Arg] capacity: The size of the output array in bytes.
+		///[Returns] UInt: The size of the decompressed data.
+		///[Error] CompressionError: Thrown if the data is invalid or does not fit in the output array.
+		static UInt DecompressBlock(const UByte* const data, const UInt size, UByte* const output, const UInt capacity);
+
+	private:
+		friend class CompressionEncoder;
+		friend class CompressionDecoder;
+
+		static const UInt minMatch = 4;
+		static const UInt lastLiterals = 5;
+		static const UInt matchLimit = 12;
+		static const UInt maxOffset = 0xFFFF;
+
+		static const UInt fastHashLog = 12;
+		static const UInt highHashLog = 15;
+		static const UInt highAttempts = 256;
+
+		static UInt CompressFast(const UByte* const data, const UInt size, UByte* const output, const UInt capacity);
+		static UInt CompressHigh(const UByte* const data, const UInt size, UByte* const output, const UInt capacity);
+
+		static bool WriteSequence(UByte*& op, const UByte* const end, const UByte* const literals, const UInt literalCount, const UInt offset, const UInt matchLength);
+		static bool WriteLiterals(UByte*& op, const UByte* const end, const UByte* const literals, const UInt literalCount);
+		static UInt MatchLength(const UByte* a, const UByte* b, const UByte* const end);
+
+		static UInt Read32(const UByte* const data) {
+			UInt value;
+			std::memcpy(&value, data, sizeof(UInt));
+			return value;
+		}
+
+		static UInt ReadLE32(const UByte* const data) {
+			return (UInt)data[0] | ((UInt)data[1] << 8) | ((UInt)data[2] << 16) | ((UInt)data[3] << 24);
+		}
+
+		static void WriteLE32(UByte* const data, const UInt value) {
+			data[0] = (UByte)value;
+			data[1] = (UByte)(value >> 8);
+			data[2] = (UByte)(value >> 16);
+			data[3] = (UByte)(value >> 24);
+		}
+
+		static UInt HashPosition(const UInt value, const UInt bits) {
+			return (value * 2654435761U) >> (32 - bits);
+		}
+	};
+
+	///[Title] CompressionEncoder
+	/// Compresses a stream of data to the LZ4 frame format.
+	/// The output can be decompressed by {CompressionDecoder} or by any LZ4 implementation.
+	///[para] The compressed data is passed to a function that takes a {const UByte*} and a {UInt} size.
+	///[Block] CompressionEncoder
+	class CompressionEncoder final {
+	public:
+		///[Heading] Constructors
+
+		/// Creates an encoder.
+		///[Arg] level: The compression level.
+		///[Arg] blockSize: The maximum size of the compressed blocks.
+		/// Must be 64 KB, 256 KB, 1 MB or 4 MB.
+		explicit CompressionEncoder(const CompressionLevel level = CompressionLevel::Fast, const UInt blockSize = defaultBlockSize);
+
+		CompressionEncoder(const CompressionEncoder& encoder) = delete;
+		~CompressionEncoder();
+
+		///[Heading] Methods
+
+		/// Adds data to the stream.
+		/// Complete blocks are compressed and passed to {output}.
+		///M
+		template <class F>
+		void Write(const UByte* const data, const UInt size, const F& output);
+		///M
+
+		/// Compresses the remaining data and ends the frame.
+		/// The encoder can be used for a new frame after this.
+		///M
+		template <class F>
+		void Finish(const F& output);
+		///M
+
+		/// Gets the maximum size of a frame containing {size} bytes of data.
+		UInt FrameBound(const UInt size) const;
+
+		void operator=(const CompressionEncoder& encoder) = delete;
+
+		/// The default size of the compressed blocks.
+		static const UInt defaultBlockSize = 1 << 16;
+
+	private:
+		CompressionLevel level;
+		UInt blockSize;
+		Array<UByte> block;
+		Array<UByte> compressed;
+		UInt blockFill = 0;
+		bool started = false;
+		XXH32Hasher checksum;
+
+		template <class F>
+		void WriteHeader(const F& output);
+
+		template <class F>
+		void WriteBlock(const F& output);
+	};
+
+	///[Title] CompressionDecoder
+	/// Decompresses a stream of data in the LZ4 frame format.
+	/// The input can be split up in any way.
+	///[para] The decompressed data is passed to a function that takes a {const UByte*} and a {UInt} size.
+	///[Block] CompressionDecoder
+	class CompressionDecoder final {
+	public:
+		///[Heading] Constructors
+
+		/// Creates a decoder.
+		CompressionDecoder();
+
+		CompressionDecoder(const CompressionDecoder& decoder) = delete;
+		~CompressionDecoder();
+
+		///[Heading] Methods
+
+		/// Adds compressed data to the stream.
+		/// Decompressed blocks are passed to {output}.
+		///[Error] CompressionError: Thrown if the data is invalid.
+		///M
+		template <class F>
+		void Write(const UByte* data, UInt size, const F& output);
+		///M
+
+		/// Checks that the stream ended at the end of a frame.
+		///[Error] CompressionError: Thrown if the stream ended in the middle of a frame.
+		void Finish() const;
+
+		void operator=(const CompressionDecoder& decoder) = delete;
+
+	private:
+		enum class Stage : UByte {
+			Magic,
+			Descriptor,
+			SkipSize,
+			Skip,
+			BlockSize,
+			Block,
+			ContentChecksum
+		};
+
+		Stage stage = Stage::Magic;
+		std::vector<UByte> input;
+		UInt need = 4;
+		UInt skip = 0;
+		UInt frames = 0;
+
+		UInt blockMaxSize = 0;
+		UInt blockSize = 0;
+		bool blockCompressed = false;
+		bool blockChecksum = false;
+		bool contentChecksum = false;
+		bool hasContentSize = false;
+		ULong contentSize = 0;
+		ULong decodedSize = 0;
+
+		Array<UByte> block;
+		XXH32Hasher checksum;
+
+		template <class F>
+		void Process(const F& output);
+	};
+
+	///[Title] CompressionError
+	/// Used if compressed data is invalid.
+	///[Block] CompressionError: Error
+	class CompressionError : public Error {
+	public:
+		CompressionError() : Error() {}
+		CompressionError(const char* const msg) : Error(msg) {}
+
+		virtual String Name() const override {
+			return "CompressionError";
+		}
+	};
+
+	inline UInt Compression::CompressBound(const UInt size) {
+		return size + size / 255 + 16;
+	}
+
+	inline UInt Compression::CompressBlock(const UByte* const data, const UInt size, UByte* const output, const UInt capacity, const CompressionLevel level) {
+		if (level == CompressionLevel::High) {
+			return CompressHigh(data, size, output, capacity);
+		}
+
+		return CompressFast(data, size, output, capacity);
+	}
+
+	inline UInt Compression::DecompressBlock(const UByte* const data, const UInt size, UByte* const output, const UInt capacity) {
+		const UByte* ip = data;
+		const UByte* const ipEnd = data + size;
+		UByte* op = output;
+		UByte* const opEnd = output + capacity;
+
+		if (size == 0) {
+			throw CompressionError("Empty compressed block");
+		}
+
+		while (true) {
+			const UInt token = *ip++;
+			UInt literalCount = token >> 4;
+
+			if (literalCount == 15) {
+				UByte b;
+
+				do {
+					if (ip >= ipEnd) throw CompressionError("Compressed block is truncated");
+					b = *ip++;
+					literalCount += b;
+				}
+				while (b == 255);
+			}
+
+			if ((UInt)(ipEnd - ip) < literalCount) throw CompressionError("Compressed block is truncated");
+			if ((UInt)(opEnd - op) < literalCount) throw CompressionError("Decompressed data is too large");
+
+			std::memcpy(op, ip, literalCount);
+			ip += literalCount;
+			op += literalCount;
+
+			// The last sequence only contains literals
+			if (ip == ipEnd) break;
+
+			if (ipEnd - ip < 2) throw CompressionError("Compressed block is truncated");
+
+			const UInt offset = (UInt)ip[0] | ((UInt)ip[1] << 8);
+			ip += 2;
+
+			if (offset == 0 || offset > (UInt)(op - output)) throw CompressionError("Invalid match offset");
+
+			UInt matchLength = token & 15;
+
+			if (matchLength == 15) {
+				UByte b;
+
+				do {
+					if (ip >= ipEnd) throw CompressionError("Compressed block is truncated");
+					b = *ip++;
+					matchLength += b;
+				}
+				while (b == 255);
+			}
+
+			matchLength += minMatch;
+
+			if ((UInt)(opEnd - op) < matchLength) throw CompressionError("Decompressed data is too large");
+
+			const UByte* match = op - offset;
+
+			if (offset >= matchLength) {
+				std::memcpy(op, match, matchLength);
+				op += matchLength;
+			}
+			else {
+				// Overlapping matches repeat the last bytes
+				for (UInt i = 0; i < matchLength; i++) {
+					*op++ = *match++;
+				}
+			}
+		}
+
+		return (UInt)(op - output);
+	}
+
+	inline UInt Compression::CompressFast(const UByte* const data, const UInt size, UByte* const output, const UInt capacity) {
+		UByte* op = output;
+		const UByte* const opEnd = output + capacity;
+
+		if (size < matchLimit + 1) {
+			if (!WriteLiterals(op, opEnd, data, size)) return 0;
+			return (UInt)(op - output);
+		}
+
+		UInt table[1 << fastHashLog] = {};
+
+		const UByte* const end = data + size;
+		const UByte* const limit = end - matchLimit;
+		const UByte* const matchEnd = end - lastLiterals;
+		const UByte* anchor = data;
+		const UByte* ip = data + 1;
+
+		table[HashPosition(Read32(data), fastHashLog)] = 0;
+
+		while (ip < limit) {
+			const UInt hash = HashPosition(Read32(ip), fastHashLog);
+			const UByte* match = data + table[hash];
+			table[hash] = (UInt)(ip - data);
+
+			if (match >= ip || (UInt)(ip - match) > maxOffset || Read32(match) != Read32(ip)) {
+				// Skips faster through data that does not compress
+				ip += 1 + ((UInt)(ip - anchor) >> 6);
+				continue;
+			}
+
+			while (ip > anchor && match > data && ip[-1] == match[-1]) {
+				ip--;
+				match--;
+			}
+
+			const UInt length = minMatch + MatchLength(ip + minMatch, match + minMatch, matchEnd);
+
+			if (!WriteSequence(op, opEnd, anchor, (UInt)(ip - anchor), (UInt)(ip - match), length)) return 0;
+
+			ip += length;
+			anchor = ip;
+
+			if (ip < limit) {
+				table[HashPosition(Read32(ip - 2), fastHashLog)] = (UInt)(ip - 2 - data);
+			}
+		}
+
+		if (!WriteLiterals(op, opEnd, anchor, (UInt)(end - anchor))) return 0;
+		return (UInt)(op - output);
+	}
+
+	inline UInt Compression::CompressHigh(const UByte* const data, const UInt size, UByte* const output, const UInt capacity) {
+		UByte* op = output;
+		const UByte* const opEnd = output + capacity;
+
+		if (size < matchLimit + 1) {
+			if (!WriteLiterals(op, opEnd, data, size)) return 0;
+			return (UInt)(op - output);
+		}
+
+		std::vector<Int> head = std::vector<Int>(1 << highHashLog, -1);
+		std::vector<UShort> chain = std::vector<UShort>(maxOffset + 1, 0);
+
+		const UByte* const end = data + size;
+		const UByte* const limit = end - matchLimit;
+		const UByte* const matchEnd = end - lastLiterals;
+		const UByte* anchor = data;
+		UInt inserted = 0;
+
+		auto insert = [&](const UInt position) {
+			while (inserted < position) {
+				const UInt hash = HashPosition(Read32(data + inserted), highHashLog);
+				const Int previous = head[hash];
+				const UInt delta = previous >= 0 ? inserted - (UInt)previous : 0;
+				chain[inserted & maxOffset] = (UShort)(delta > maxOffset ? 0 : delta);
+				head[hash] = (Int)inserted;
+				inserted++;
+			}
+		};
+
+		// Finds the longest match for a position in the hash chain
+		auto find = [&](const UByte* const ip, const UByte*& best) -> UInt {
+			const UInt position = (UInt)(ip - data);
+			insert(position);
+
+			UInt bestLength = 0;
+			Int candidate = head[HashPosition(Read32(ip), highHashLog)];
+
+			for (UInt attempts = highAttempts; candidate >= 0 && attempts > 0; attempts--) {
+				const UInt distance = position - (UInt)candidate;
+				if (distance == 0 || distance > maxOffset) break;
+
+				const UByte* const match = data + candidate;
+
+				if (match[bestLength] == ip[bestLength] && Read32(match) == Read32(ip)) {
+					const UInt length = minMatch + MatchLength(ip + minMatch, match + minMatch, matchEnd);
+
+					if (length > bestLength) {
+						bestLength = length;
+						best = match;
+						if (ip + length >= matchEnd) break;
+					}
+				}
+
+				const UShort delta = chain[(UInt)candidate & maxOffset];
+				if (delta == 0) break;
+				candidate -= delta;
+			}
+
+			return bestLength;
+		};
+
+		const UByte* ip = data;
+
+		while (ip < limit) {
+			const UByte* match = nullptr;
+			UInt length = find(ip, match);
+
+			if (length < minMatch) {
+				ip++;
+				continue;
+			}
+
+			// Moves the match forward if the next position has a longer match
+			while (ip + 1 < limit) {
+				const UByte* nextMatch = nullptr;
+				const UInt nextLength = find(ip + 1, nextMatch);
+
+				if (nextLength <= length + 1) break;
+
+				ip++;
+				match = nextMatch;
+				length = nextLength;
+			}
+
+			if (!WriteSequence(op, opEnd, anchor, (UInt)(ip - anchor), (UInt)(ip - match), length)) return 0;
+
+			ip += length;
+			anchor = ip;
+		}
+
+		if (!WriteLiterals(op, opEnd, anchor, (UInt)(end - anchor))) return 0;
+		return (UInt)(op - output);
+	}
+
+	inline bool Compression::WriteSequence(UByte*& op, const UByte* const end, const UByte* const literals, const UInt literalCount, const UInt offset, const UInt matchLength) {
+		const UInt matchCode = matchLength - minMatch;
+
+		if ((UInt)(end - op) < 1 + literalCount + literalCount / 255 + 1 + 2 + matchCode / 255 + 1) return false;
+
+		UByte* const token = op++;
+		*token = (UByte)((literalCount >= 15 ? 15 : literalCount) << 4);
+
+		if (literalCount >= 15) {
+			UInt count = literalCount - 15;
+
+			for (; count >= 255; count -= 255) {
+				*op++ = 255;
+			}
+
+			*op++ = (UByte)count;
+		}
+
+		std::memcpy(op, literals, literalCount);
+		op += literalCount;
+
+		*op++ = (UByte)offset;
+		*op++ = (UByte)(offset >> 8);
+
+		*token |= (UByte)(matchCode >= 15 ? 15 : matchCode);
+
+		if (matchCode >= 15) {
+			UInt count = matchCode - 15;
+
+			for (; count >= 255; count -= 255) {
+				*op++ = 255;
+			}
+
+			*op++ = (UByte)count;
+		}
+
+		return true;
+	}
+
+	inline bool Compression::WriteLiterals(UByte*& op, const UByte* const end, const UByte* const literals, const UInt literalCount) {
+		if ((UInt)(end - op) < 1 + literalCount + literalCount / 255 + 1) return false;
+
+		*op++ = (UByte)((literalCount >= 15 ? 15 : literalCount) << 4);
+
+		if (literalCount >= 15) {
+			UInt count = literalCount - 15;
+
+			for (; count >= 255; count -= 255) {
+				*op++ = 255;
+			}
+
+			*op++ = (UByte)count;
+		}
+
+		if (literalCount > 0) {
+			std::memcpy(op, literals, literalCount);
+			op += literalCount;
+		}
+
+		return true;
+	}
+
+	inline UInt Compression::MatchLength(const UByte* a, const UByte* b, const UByte* const end) {
+		const UByte* const start = a;
+
+		while (a + sizeof(ULong) <= end) {
+			ULong x, y;
+			std::memcpy(&x, a, sizeof(ULong));
+			std::memcpy(&y, b, sizeof(ULong));
+
+			if (x != y) {
+				ULong diff = x ^ y;
+				UInt bytes = 0;
+
+				// The data is compared in little endian byte order
+				while ((diff & 0xFF) == 0) {
+					diff >>= 8;
+					bytes++;
+				}
+
+				return (UInt)(a - start) + bytes;
+			}
+
+			a += sizeof(ULong);
+			b += sizeof(ULong);
+		}
+
+		while (a < end && *a == *b) {
+			a++;
+			b++;
+		}
+
+		return (UInt)(a - start);
+	}
+
+	inline CompressionEncoder::CompressionEncoder(const CompressionLevel level, const UInt blockSize) {
+		this->level = level;
+
+		if (blockSize <= 1 << 16) this->blockSize = 1 << 16;
+		else if (blockSize <= 1 << 18) this->blockSize = 1 << 18;
+		else if (blockSize <= 1 << 20) this->blockSize = 1 << 20;
+		else this->blockSize = 1 << 22;
+
+		block = Array<UByte>(this->blockSize);
+		compressed = Array<UByte>(Compression::CompressBound(this->blockSize));
+	}
+
+	inline CompressionEncoder::~CompressionEncoder() {
+
+	}
+
+	template <class F>
+	inline void CompressionEncoder::Write(const UByte* const data, const UInt size, const F& output) {
+		if (!started) WriteHeader(output);
+
+		UInt position = 0;
+
+		while (position < size) {
+			const UInt count = std::min(size - position, blockSize - blockFill);
+			std::memcpy((UByte*)block + blockFill, data + position, count);
+			blockFill += count;
+			position += count;
+
+			if (blockFill == blockSize) {
+				WriteBlock(output);
+			}
+		}
+	}
+
+	template <class F>
+	inline void CompressionEncoder::Finish(const F& output) {
+		if (!started) WriteHeader(output);
+		if (blockFill > 0) WriteBlock(output);
+
+		UByte end[8];
+		Compression::WriteLE32(end, 0);
+		Compression::WriteLE32(end + 4, checksum.Digest());
+		output((const UByte*)end, 8);
+
+		started = false;
+		checksum.Reset();
+	}
+
+	inline UInt CompressionEncoder::FrameBound(const UInt size) const {
+		const UInt blocks = (size + blockSize - 1) / blockSize;
+		return 7 + blocks * (4 + blockSize) + 8;
+	}
+
+	template <class F>
+	inline void CompressionEncoder::WriteHeader(const F& output) {
+		UByte header[7];
+		Compression::WriteLE32(header, 0x184D2204);
+
+		// Version 1 with independent blocks and a content checksum
+		header[4] = 0x40 | 0x20 | 0x04;
+
+		switch (blockSize) {
+			case 1 << 16: header[5] = 4 << 4; break;
+			case 1 << 18: header[5] = 5 << 4; break;
+			case 1 << 20: header[5] = 6 << 4; break;
+			default:      header[5] = 7 << 4; break;
+		}
+
+		header[6] = (UByte)(Hash::XXH32(header + 4, 2) >> 8);
+		output((const UByte*)header, 7);
+		started = true;
+	}
+
+	template <class F>
+	inline void CompressionEncoder::WriteBlock(const F& output) {
+		const UByte* const data = (const UByte*)block;
+		checksum.Update(data, blockFill);
+
+		UByte size[4];
+		const UInt compressedSize = Compression::CompressBlock(data, blockFill, (UByte*)compressed, blockFill, level);
+
+		// Blocks that do not compress are stored as they are
+		if (compressedSize == 0) {
+			Compression::WriteLE32(size, blockFill | 0x80000000);
+			output((const UByte*)size, 4);
+			output(data, blockFill);
+		}
+		else {
+			Compression::WriteLE32(size, compressedSize);
+			output((const UByte*)size, 4);
+			output((const UByte*)compressed, compressedSize);
+		}
+
+		blockFill = 0;
+	}
+
+	inline CompressionDecoder::CompressionDecoder() {
+
+	}
+
+	inline CompressionDecoder::~CompressionDecoder() {
+
+	}
+
+	template <class F>
+	inline void CompressionDecoder::Write(const UByte* data, UInt size, const F& output) {
+		while (size > 0) {
+			// Skippable frames are not buffered
+			if (stage == Stage::Skip) {
+				const UInt count = std::min(skip, size);
+				data += count;
+				size -= count;
+				skip -= count;
+
+				if (skip == 0) {
+					stage = Stage::Magic;
+					need = 4;
+				}
+
+				continue;
+			}
+
+			const UInt count = std::min(need - (UInt)input.size(), size);
+			input.insert(input.end(), data, data + count);
+			data += count;
+			size -= count;
+
+			if (input.size() == need) {
+				Process(output);
+			}
+		}
+	}
+
+	inline void CompressionDecoder::Finish() const {
+		if (frames == 0 || stage != Stage::Magic || !input.empty()) {
+			throw CompressionError("Compressed data ended in the middle of a frame");
+		}
+	}
+
+	template <class F>
+	inline void CompressionDecoder::Process(const F& output) {
+		const UByte* const data = input.data();
+
+		switch (stage) {
+			case Stage::Magic: {
+				const UInt magic = Compression::ReadLE32(data);
+
+				if ((magic & 0xFFFFFFF0) == 0x184D2A50) {
+					stage = Stage::SkipSize;
+					need = 4;
+				}
+				else if (magic == 0x184D2204) {
+					stage = Stage::Descriptor;
+					need = 2;
+				}
+				else {
+					throw CompressionError("Invalid frame magic number");
+				}
+
+				break;
+			}
+
+			case Stage::Descriptor: {
+				const UByte flags = data[0];
+
+				if ((flags >> 6) != 1) throw CompressionError("Unsupported frame version");
+				if (flags & 0x01) throw CompressionError("Dictionaries are not supported");
+
+				const UInt size = 3 + ((flags & 0x08) ? 8 : 0);
+
+				// Reads the optional fields before processing the descriptor
+				if (need < size) {
+					need = size;
+					return;
+				}
+
+				const UInt blockId = (data[1] >> 4) & 7;
+				if (blockId < 4) throw CompressionError("Invalid block size");
+
+				if ((UByte)(Hash::XXH32(data, size - 1) >> 8) != data[size - 1]) {
+					throw CompressionError("Invalid frame header checksum");
+				}
+
+				blockMaxSize = 1 << (8 + 2 * blockId);
+				blockChecksum = (flags & 0x10) != 0;
+				contentChecksum = (flags & 0x04) != 0;
+				hasContentSize = (flags & 0x08) != 0;
+				contentSize = 0;
+				decodedSize = 0;
+
+				if (hasContentSize) {
+					contentSize = (ULong)Compression::ReadLE32(data + 2) | ((ULong)Compression::ReadLE32(data + 6) << 32);
+				}
+
+				if (block.Length() < blockMaxSize) {
+					block = Array<UByte>(blockMaxSize);
+				}
+
+				checksum.Reset();
+				stage = Stage::BlockSize;
+				need = 4;
+				break;
+			}
+
+			case Stage::SkipSize: {
+				skip = Compression::ReadLE32(data);
+				stage = skip > 0 ? Stage::Skip : Stage::Magic;
+				need = 4;
+				break;
+			}
+
+			case Stage::Skip: {
+				break;
+			}
+
+			case Stage::BlockSize: {
+				const UInt value = Compression::ReadLE32(data);
+
+				if (value == 0) {
+					if (hasContentSize && decodedSize != contentSize) {
+						throw CompressionError("Invalid content size");
+					}
+
+					if (contentChecksum) {
+						stage = Stage::ContentChecksum;
+						need = 4;
+					}
+					else {
+						frames++;
+						stage = Stage::Magic;
+						need = 4;
+					}
+
+					break;
+				}
+
+				blockSize = value & 0x7FFFFFFF;
+				blockCompressed = (value & 0x80000000) == 0;
+
+				if (blockSize > blockMaxSize) throw CompressionError("Invalid block size");
+
+				stage = Stage::Block;
+				need = blockSize + (blockChecksum ? 4 : 0);
+				break;
+			}
+
+			case Stage::Block: {
+				if (blockChecksum && Hash::XXH32(data, blockSize) != Compression::ReadLE32(data + blockSize)) {
+					throw CompressionError("Invalid block checksum");
+				}
+
+				const UByte* decoded = data;
+				UInt decodedCount = blockSize;
+
+				if (blockCompressed) {
+					decodedCount = Compression::DecompressBlock(data, blockSize, (UByte*)block, blockMaxSize);
+					decoded = (const UByte*)block;
+				}
+
+				if (contentChecksum) checksum.Update(decoded, decodedCount);
+				decodedSize += decodedCount;
+				output(decoded, decodedCount);
+
+				stage = Stage::BlockSize;
+				need = 4;
+				break;
+			}
+
+			case Stage::ContentChecksum: {
+				if (checksum.Digest() != Compression::ReadLE32(data)) {
+					throw CompressionError("Invalid content checksum");
+				}
+
+				frames++;
+				stage = Stage::Magic;
+				need = 4;
+				break;
+			}
+		}
+
+		input.clear();
+	}
+}
+
+#endif
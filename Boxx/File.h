@@ -4,12 +4,32 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <future>
 
 #include "Types.h"
 #include "Error.h"
 #include "String.h"
+#include "StringView.h"
+#include "Array.h"
 #include "Buffer.h"
+#include "Compression.h"
 #include "Pointer.h"
+#include "ThreadPool.h"
+
+#if defined(BOXX_LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define _BOXX_IO_URING
+
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <atomic>
+#endif
+#endif
 
 ///[Settings] block: indent 
 
@@ -52,6 +72,20 @@ namespace Boxx {
 		///[Error] EndOfFileError: Thrown if the end of file has been reached.
 		String ReadLine();
 
+		/// Reads a line from the file without allocating a new string.
+		/// The file is read in large blocks and {line} is set to a view of the line inside the current block.
+		///[para] The view is only valid until the next read from the file.
+		///[Error] FileClosedError: Thrown if the file is closed.
+		///[Returns] bool: {false} if the end of file has been reached.
+		bool ReadLine(StringView& line);
+
+		/// Reads the next block of the file without allocating a new string.
+		/// {block} is set to a view of the bytes that have been read from the file but not returned by another read.
+		///[para] The view is only valid until the next read from the file.
+		///[Error] FileClosedError: Thrown if the file is closed.
+		///[Returns] bool: {false} if the end of file has been reached.
+		bool ReadBlock(StringView& block);
+
 		/// Reads the remaining contents of the file.
 		///[Error] FileClosedError: Thrown if the file is closed.
 		///[Error] EndOfFileError: Thrown if the end of file has been reached.
@@ -76,17 +110,18 @@ namespace Boxx {
 			LineIterator(FileReader* const file);
 			~LineIterator() {}
 
-			String operator*();
-			LineIterator operator++();
-			bool operator!=(const LineIterator& iterator);
+			StringView operator*() const;
+			LineIterator& operator++();
+			bool operator!=(const LineIterator& iterator) const;
 
 		private:
 			FileReader* file;
-			String next;
+			StringView line;
 		};
 
 		/// Iterates over all lines of the file.
-		///[Code] for (String line : file)
+		///[para] Each line is a view that is only valid until the next line is read.
+		///[Code] for (StringView line : file)
 		LineIterator begin();
 		LineIterator end();
 
@@ -103,9 +138,29 @@ namespace Boxx {
 		///[Error] FileNotFoundError: Thrown if the file was not found.
 		static Buffer ReadBuffer(const String& filename, const FileMode mode = FileMode::None);
 
+		/// Reads the contents of the specified file as a buffer without blocking the calling thread.
+		///[para] The file is read with io_uring on Linux if the kernel supports it.
+		/// Otherwise, or if the ring is full, the file is read by the {ThreadPool::IO()} thread pool.
+		///[Returns] std::future<Buffer>: Contains the contents of the file when the read is done.
+		///[Error] FileNotFoundError: Thrown by the future if the file was not found.
+		static std::future<Buffer> ReadAsync(const String& filename, const FileMode mode = FileMode::None);
+
 	private:
+		struct BlockBuffer {
+			Array<char> data;
+			UInt start = 0;
+			UInt end = 0;
+			bool eof = false;
+		};
+
+		static const UInt blockSize = 1 << 16;
+
 		Pointer<std::ifstream> file;
+		Pointer<BlockBuffer> buffer;
 		bool done = false;
+
+		bool FillBuffer();
+		void TakeBuffered(std::ostream& stream);
 	};
 
 	///[Title] FileWriter
@@ -116,8 +171,10 @@ namespace Boxx {
 		FileWriter();
 
 		/// Opens a file for writing.
+		///[Arg] bufferSize: The size of the write buffer in bytes.
+		/// Writes are collected in the buffer and written to the file when the buffer is full.
 		///[Error] FileOpenError: Thrown if the file can not be opened.
-		explicit FileWriter(const char* const filename, const FileMode mode = FileMode::None);
+		explicit FileWriter(const char* const filename, const FileMode mode = FileMode::None, const UInt bufferSize = defaultBufferSize);
 
 		FileWriter(const FileWriter& file);
 		FileWriter(FileWriter&& file) noexcept;
@@ -133,7 +190,25 @@ namespace Boxx {
 		///[Error] FileClosedError: Thrown if the file is closed.
 		void Write(const Buffer& data);
 
+		/// Writes several strings, string views or buffers to the file as one write.
+		///[para] The data is gathered in the write buffer and is only split up if it does not fit in the buffer.
+		///[Error] FileClosedError: Thrown if the file is closed.
+		///M
+		template <class T, class ... Args>
+		void WriteV(const T& data, const Args& ... args);
+		///M
+
+		/// Writes the contents of the write buffer to the file.
+		///[Error] FileClosedError: Thrown if the file is closed.
+		void Flush();
+
+		/// Sets the size of the write buffer in bytes.
+		///[para] The current contents of the buffer are written to the file first.
+		///[Error] FileClosedError: Thrown if the file is closed.
+		void SetBufferSize(const UInt bufferSize);
+
 		/// Close the file.
+		///[para] The contents of the write buffer are written to the file before it is closed.
 		///[Error] FileClosedError: Thrown if the file is already closed.
 		void Close();
 
@@ -153,8 +228,187 @@ namespace Boxx {
 		///[Error] FileOpenError: Thrown if the file can not be opened.
 		static void WriteBuffer(const String& filename, const Buffer& buffer, const FileMode mode = FileMode::None);
 
+		/// Writes text to the specified file without blocking the calling thread.
+		///[para] The text is copied before the function returns.
+		/// The file is written with io_uring on Linux if the kernel supports it.
+		/// Otherwise, or if the ring is full, the file is written by the {ThreadPool::IO()} thread pool.
+		///[Returns] std::future<void>: Becomes ready when the write is done.
+		///[Error] FileOpenError: Thrown by the future if the file can not be opened.
+		static std::future<void> WriteAsync(const String& filename, const String& text, const FileMode mode = FileMode::None);
+
+		/// Writes the contents of a buffer to the specified file without blocking the calling thread.
+		///[para] The contents of the buffer are copied before the function returns.
+		/// The file is written with io_uring on Linux if the kernel supports it.
+		/// Otherwise, or if the ring is full, the file is written by the {ThreadPool::IO()} thread pool.
+		///[Returns] std::future<void>: Becomes ready when the write is done.
+		///[Error] FileOpenError: Thrown by the future if the file can not be opened.
+		static std::future<void> WriteAsync(const String& filename, const Buffer& buffer, const FileMode mode = FileMode::None);
+
+		/// The default size of the write buffer in bytes.
+		static const UInt defaultBufferSize = 1 << 16;
+
+	private:
+		struct Stream {
+			std::ofstream file;
+			Array<char> buffer;
+			UInt size = 0;
+
+			~Stream() {
+				if (size > 0 && file.is_open()) {
+					file.write((const char*)buffer, size);
+				}
+			}
+		};
+
+		Pointer<Stream> stream;
+
+		static std::future<void> WriteAsync(const String& filename, Array<char>&& data, const FileMode mode);
+
+		void WriteData(const char* const data, const UInt size);
+		void WriteSegments(const StringView* const segments, const UInt count);
+
+		static StringView Segment(const StringView& data) {
+			return data;
+		}
+
+		static StringView Segment(const Buffer& data) {
+			return StringView((const char*)data.Data(), data.Size());
+		}
+	};
+
+	///[Title] CompressedFileReader
+	/// Used to read a file compressed with {CompressedFileWriter} or any LZ4 frame compressor.
+	///[Block] CompressedFileReader
+	class CompressedFileReader {
+	public:
+		CompressedFileReader();
+
+		/// Opens a compressed file for reading.
+		///[Error] FileNotFoundError: Thrown if the file was not found.
+		explicit CompressedFileReader(const char* const filename);
+
+		CompressedFileReader(const CompressedFileReader& file);
+		CompressedFileReader(CompressedFileReader&& file) noexcept;
+		~CompressedFileReader();
+
+		///[Heading] Methods
+
+		/// Decompresses the remaining contents of the file.
+		///[Error] FileClosedError: Thrown if the file is closed.
+		///[Error] EndOfFileError: Thrown if the end of file has been reached.
+		///[Error] CompressionError: Thrown if the file does not contain valid compressed data.
+		String ReadAll();
+
+		/// Decompresses the remaining contents of the file to a buffer.
+		///[Error] FileClosedError: Thrown if the file is closed.
+		///[Error] EndOfFileError: Thrown if the end of file has been reached.
+		///[Error] CompressionError: Thrown if the file does not contain valid compressed data.
+		Buffer ReadToBuffer();
+
+		/// Close the file.
+		void Close();
+
+		/// Checks if the file is open.
+		bool IsOpen();
+
+		void operator=(const CompressedFileReader& file);
+		void operator=(CompressedFileReader&& file) noexcept;
+
+		///[Heading] Static Functions
+
+		/// Reads and decompresses the text from the specified file.
+		///[Error] FileNotFoundError: Thrown if the file was not found.
+		///[Error] CompressionError: Thrown if the file does not contain valid compressed data.
+		static String ReadText(const String& filename);
+
+		/// Reads and decompresses the contents of the specified file as a buffer.
+		///[Error] FileNotFoundError: Thrown if the file was not found.
+		///[Error] CompressionError: Thrown if the file does not contain valid compressed data.
+		static Buffer ReadBuffer(const String& filename);
+
+	private:
+		static const UInt blockSize = 1 << 16;
+
+		Pointer<std::ifstream> file;
+		bool done = false;
+	};
+
+	///[Title] CompressedFileWriter
+	/// Used to write a file compressed in the LZ4 frame format.
+	///[para] The data is compressed in blocks as it is written.
+	/// The file is only complete after {Close()} has been called or the writer has been destroyed.
+	///[Block] CompressedFileWriter
+	class CompressedFileWriter {
+	public:
+		CompressedFileWriter();
+
+		/// Opens a file for writing compressed data.
+		///[Arg] level: The compression level.
+		///[Error] FileOpenError: Thrown if the file can not be opened.
+		explicit CompressedFileWriter(const char* const filename, const CompressionLevel level = CompressionLevel::Fast);
+
+		CompressedFileWriter(const CompressedFileWriter& file);
+		CompressedFileWriter(CompressedFileWriter&& file) noexcept;
+		~CompressedFileWriter();
+
+		///[Heading] Methods
+
+		/// Compresses a string and writes it to the file.
+		///[Error] FileClosedError: Thrown if the file is closed.
+		void Write(const String& text);
+
+		/// Compresses the contents of a buffer and writes it to the file.
+		///[Error] FileClosedError: Thrown if the file is closed.
+		void Write(const Buffer& data);
+
+		/// Compresses the remaining data and closes the file.
+		///[Error] FileClosedError: Thrown if the file is already closed.
+		void Close();
+
+		/// Checks if the file is open.
+		bool IsOpen() const;
+
+		void operator=(const CompressedFileWriter& file);
+		void operator=(CompressedFileWriter&& file) noexcept;
+
+		///[Heading] Static Functions
+
+		/// Compresses text and writes it to the specified file.
+		///[Error] FileOpenError: Thrown if the file can not be opened.
+		static void WriteText(const String& filename, const String& text, const CompressionLevel level = CompressionLevel::Fast);
+
+		/// Compresses the contents of a buffer and writes it to the specified file.
+		///[Error] FileOpenError: Thrown if the file can not be opened.
+		static void WriteBuffer(const String& filename, const Buffer& buffer, const CompressionLevel level = CompressionLevel::Fast);
+
 	private:
-		Pointer<std::ofstream> file;
+		struct Stream {
+			FileWriter file;
+			CompressionEncoder encoder;
+
+			Stream(const char* const filename, const CompressionLevel level) : file(filename, FileMode::Binary), encoder(level) {}
+
+			~Stream() {
+				if (file.IsOpen()) {
+					Finish();
+					file.Close();
+				}
+			}
+
+			void Write(const UByte* const data, const UInt size) {
+				encoder.Write(data, size, [this](const UByte* const data, const UInt size) {
+					file.WriteV(StringView((const char*)data, size));
+				});
+			}
+
+			void Finish() {
+				encoder.Finish([this](const UByte* const data, const UInt size) {
+					file.WriteV(StringView((const char*)data, size));
+				});
+			}
+		};
+
+		Pointer<Stream> stream;
 	};
 
 	///[Title] FileError
@@ -223,6 +477,101 @@ namespace Boxx {
 		}
 	};
 
+#ifdef _BOXX_IO_URING
+	class FileRing final {
+	public:
+		struct Request {
+			virtual ~Request() {}
+
+			// Returns true if the request is done and can be deleted
+			virtual bool Complete(FileRing& ring, const int result) = 0;
+		};
+
+		FileRing();
+		FileRing(const FileRing& ring) = delete;
+
+		// Waits for all submitted requests to complete before the thread is stopped
+		~FileRing();
+
+		// Reserves room for a request and returns false if the ring is full
+		// The requests of a full ring could overflow the completion queue so the caller has to run the request without the ring
+		bool Reserve();
+
+		// Submits the next operation of a reserved request
+		// Completes the request with the error and deletes it if the request can not be submitted
+		void Submit(io_uring_sqe sqe, Request* const request);
+
+		void operator=(const FileRing& ring) = delete;
+
+		// Gets the shared ring or nullptr if io_uring is not supported
+		static FileRing* Get();
+
+	private:
+		int fd = -1;
+
+		void* sqRing = MAP_FAILED;
+		void* cqRing = MAP_FAILED;
+		io_uring_sqe* sqes = (io_uring_sqe*)MAP_FAILED;
+		size_t sqRingSize = 0;
+		size_t cqRingSize = 0;
+		size_t sqesSize = 0;
+
+		unsigned* sqHead;
+		unsigned* sqTail;
+		unsigned* sqMask;
+		unsigned* sqEntries;
+		unsigned* sqArray;
+		unsigned* cqHead;
+		unsigned* cqTail;
+		unsigned* cqMask;
+		io_uring_cqe* cqes;
+
+		std::mutex mutex;
+		std::thread thread;
+
+		// The number of reserved requests that are not done and the max number of them
+		// One completion is kept free for the request that stops the thread
+		std::atomic<UInt> pending{0};
+		UInt capacity = 0;
+		std::atomic<bool> stopping{false};
+
+		void Run();
+	};
+
+	class FileRingRead final : public FileRing::Request {
+	public:
+		FileRingRead(const String& filename);
+		virtual bool Complete(FileRing& ring, const int result) override;
+
+		String filename;
+		std::promise<Buffer> promise;
+
+	private:
+		int fd = -1;
+		Array<UByte> data;
+		UInt size = 0;
+		bool knownSize = false;
+
+		void SubmitRead(FileRing& ring);
+	};
+
+	class FileRingWrite final : public FileRing::Request {
+	public:
+		FileRingWrite(const String& filename, Array<char>&& data);
+		virtual bool Complete(FileRing& ring, const int result) override;
+
+		String filename;
+		std::promise<void> promise;
+
+	private:
+		int fd = -1;
+		Array<char> data;
+		UInt written = 0;
+
+		void SubmitWrite(FileRing& ring);
+	};
+#endif
+
 	inline FileReader::FileReader() {
 
 	}
@@ -241,11 +590,13 @@ namespace Boxx {
 	inline FileReader::FileReader(const FileReader& file) {
 		done = file.done;
 		this->file = file.file;
+		buffer = file.buffer;
 	}
 
 	inline FileReader::FileReader(FileReader&& file) noexcept {
 		done = file.done;
 		this->file = std::move(file.file);
+		buffer = std::move(file.buffer);
 	}
 
 	inline FileReader::~FileReader() {
@@ -258,12 +609,76 @@ namespace Boxx {
 		else if (done)
 			throw EndOfFileError("End of file reached");
 
-		std::string str;
+		StringView line;
+
+		if (ReadLine(line)) {
+			return line;
+		}
+
+		return "";
+	}
+
+	inline bool FileReader::ReadLine(StringView& line) {
+		if (!IsOpen())
+			throw FileClosedError("File is closed");
+		else if (done)
+			return false;
+
+		if (buffer == nullptr) {
+			buffer = new BlockBuffer();
+			buffer->data = Array<char>(blockSize);
+		}
+
+		UInt searchStart = buffer->start;
+
+		while (true) {
+			const char* const data = (const char*)buffer->data;
+
+			if (const char* const newLine = (const char*)std::memchr(data + searchStart, '\n', buffer->end - searchStart)) {
+				const UInt lineEnd = (UInt)(newLine - data);
+				line = StringView(data + buffer->start, lineEnd - buffer->start);
+				buffer->start = lineEnd + 1;
+				return true;
+			}
+
+			const UInt searched = buffer->end - buffer->start;
+
+			if (!FillBuffer()) {
+				break;
+			}
+
+			searchStart = buffer->start + searched;
+		}
+
+		if (buffer->start < buffer->end) {
+			line = StringView((const char*)buffer->data + buffer->start, buffer->end - buffer->start);
+			buffer->start = buffer->end;
+			return true;
+		}
+
+		done = true;
+		return false;
+	}
+
+	inline bool FileReader::ReadBlock(StringView& block) {
+		if (!IsOpen())
+			throw FileClosedError("File is closed");
+		else if (done)
+			return false;
 
-		if (!std::getline(*file, str))
+		if (buffer == nullptr) {
+			buffer = new BlockBuffer();
+			buffer->data = Array<char>(blockSize);
+		}
+
+		if (buffer->start >= buffer->end && !FillBuffer()) {
 			done = true;
+			return false;
+		}
 
-		return str;
+		block = StringView((const char*)buffer->data + buffer->start, buffer->end - buffer->start);
+		buffer->start = buffer->end;
+		return true;
 	}
 
 	inline String FileReader::ReadAll() {
@@ -273,6 +688,8 @@ namespace Boxx {
 			throw EndOfFileError("End of file reached");
 
 		std::stringstream ss;
+
+		TakeBuffered(ss);
 		ss << file->rdbuf();
 		done = true;
 		return String(ss.str().c_str(), (unsigned int)ss.str().size());
@@ -285,6 +702,8 @@ namespace Boxx {
 			throw EndOfFileError("End of file reached");
 
 		std::stringstream ss;
+
+		TakeBuffered(ss);
 		ss << file->rdbuf();
 		done = true;
 
@@ -315,11 +734,51 @@ namespace Boxx {
 	inline void FileReader::operator=(const FileReader& file) {
 		done = file.done;
 		this->file = file.file;
+		buffer = file.buffer;
 	}
 
 	inline void FileReader::operator=(FileReader&& file) noexcept {
 		done = file.done;
 		this->file = std::move(file.file);
+		buffer = std::move(file.buffer);
+	}
+
+	inline bool FileReader::FillBuffer() {
+		if (buffer->eof) return false;
+
+		char* const data = (char*)buffer->data;
+		const UInt remaining = buffer->end - buffer->start;
+
+		if (buffer->start > 0) {
+			std::memmove(data, data + buffer->start, remaining);
+			buffer->start = 0;
+			buffer->end = remaining;
+		}
+
+		if (buffer->end >= buffer->data.Length()) {
+			Array<char> grown = Array<char>(buffer->data.Length() * 2);
+			std::memcpy((char*)grown, (const char*)buffer->data, buffer->end);
+			buffer->data = grown;
+		}
+
+		const UInt space = buffer->data.Length() - buffer->end;
+		file->read((char*)buffer->data + buffer->end, space);
+
+		const UInt count = (UInt)file->gcount();
+		buffer->end += count;
+
+		if (count < space) {
+			buffer->eof = true;
+		}
+
+		return count > 0;
+	}
+
+	inline void FileReader::TakeBuffered(std::ostream& stream) {
+		if (buffer == nullptr) return;
+
+		stream.write((const char*)buffer->data + buffer->start, buffer->end - buffer->start);
+		buffer->start = buffer->end;
 	}
 
 	inline FileReader::LineIterator::LineIterator() {
@@ -327,27 +786,25 @@ namespace Boxx {
 	}
 
 	inline FileReader::LineIterator::LineIterator(FileReader* const file) : file(file) {
-		next = file->ReadLine();
+		if (!file->ReadLine(line)) {
+			this->file = nullptr;
+		}
 	}
 
-	inline FileReader::LineIterator FileReader::LineIterator::operator++() {
+	inline FileReader::LineIterator& FileReader::LineIterator::operator++() {
+		if (!file->ReadLine(line)) {
+			file = nullptr;
+		}
+
 		return *this;
 	}
 
-	inline String FileReader::LineIterator::operator*() {
-		try {
-			const String line = next;
-			next = file->ReadLine();
-			return line;
-		}
-		catch (EndOfFileError) {
-			file->done = true;
-			return "";
-		}
+	inline StringView FileReader::LineIterator::operator*() const {
+		return line;
 	}
 
-	inline bool FileReader::LineIterator::operator!=(const LineIterator& iterator) {
-		return !file->done;
+	inline bool FileReader::LineIterator::operator!=(const LineIterator& iterator) const {
+		return file != iterator.file;
 	}
 
 	inline String FileReader::ReadText(const String& filename, const FileMode mode) {
@@ -364,27 +821,57 @@ namespace Boxx {
 		return buffer;
 	}
 
+	inline std::future<Buffer> FileReader::ReadAsync(const String& filename, const FileMode mode) {
+#ifdef _BOXX_IO_URING
+		FileRing* const ring = FileRing::Get();
+
+		if (ring && ring->Reserve()) {
+			FileRingRead* const request = new FileRingRead(filename);
+			std::future<Buffer> future = request->promise.get_future();
+
+			io_uring_sqe sqe = {};
+			sqe.opcode = IORING_OP_OPENAT;
+			sqe.fd = AT_FDCWD;
+			sqe.addr = (__u64)(const char*)request->filename;
+			sqe.open_flags = O_RDONLY | O_CLOEXEC;
+
+			ring->Submit(sqe, request);
+			return future;
+		}
+#endif
+
+		return ThreadPool::IO().Run([filename, mode]() {
+			return ReadBuffer(filename, mode);
+		});
+	}
+
 	inline FileWriter::FileWriter() {
 
 	}
 
-	inline FileWriter::FileWriter(const char* const filename, const FileMode mode) {
+	inline FileWriter::FileWriter(const char* const filename, const FileMode mode, const UInt bufferSize) {
+		stream = new Stream();
+		stream->buffer = Array<char>(bufferSize);
+
+		// The write buffer replaces the stream buffer
+		stream->file.rdbuf()->pubsetbuf(nullptr, 0);
+
 		if ((mode & FileMode::Binary) != FileMode::None)
-			file = new std::ofstream(filename, std::fstream::binary);
+			stream->file.open(filename, std::fstream::binary);
 		else
-			file = new std::ofstream(filename);
+			stream->file.open(filename);
 
-		if (!file->is_open()) {
+		if (!stream->file.is_open()) {
 			throw FileOpenError("Could not open file: " + String(filename));
 		}
 	}
 
 	inline FileWriter::FileWriter(const FileWriter& file) {
-		this->file = file.file;
+		stream = file.stream;
 	}
 
 	inline FileWriter::FileWriter(FileWriter&& file) noexcept {
-		this->file = std::move(file.file);
+		stream = std::move(file.stream);
 	}
 
 	inline FileWriter::~FileWriter() {
@@ -395,31 +882,108 @@ namespace Boxx {
 		if (!IsOpen())
 			throw FileClosedError("File is closed");
 
-		file->write(text, text.Length());
+		WriteData(text, text.Length());
 	}
 
 	inline void FileWriter::Write(const Buffer& data) {
 		if (!IsOpen())
 			throw FileClosedError("File is closed");
 
-		String text = data.ToString();
-		file->write(text, text.Length());
+		WriteData((const char*)data.Data(), data.Size());
+	}
+
+	template <class T, class ... Args>
+	inline void FileWriter::WriteV(const T& data, const Args& ... args) {
+		if (!IsOpen())
+			throw FileClosedError("File is closed");
+
+		const StringView segments[] = {Segment(data), Segment(args)...};
+		WriteSegments(segments, 1 + sizeof...(Args));
+	}
+
+	inline void FileWriter::Flush() {
+		if (!IsOpen())
+			throw FileClosedError("File is closed");
+
+		if (stream->size > 0) {
+			stream->file.write((const char*)stream->buffer, stream->size);
+			stream->size = 0;
+		}
+	}
+
+	inline void FileWriter::SetBufferSize(const UInt bufferSize) {
+		Flush();
+		stream->buffer = Array<char>(bufferSize);
 	}
 
 	inline void FileWriter::Close() {
-		if (IsOpen()) file->close();
+		if (IsOpen()) {
+			Flush();
+			stream->file.close();
+		}
 	}
 
 	inline bool FileWriter::IsOpen() const {
-		return file != nullptr && file->is_open();
+		return stream != nullptr && stream->file.is_open();
 	}
 
 	inline void FileWriter::operator=(const FileWriter& file) {
-		this->file = file.file;
+		stream = file.stream;
 	}
 
 	inline void FileWriter::operator=(FileWriter&& file) noexcept {
-		this->file = std::move(file.file);
+		stream = std::move(file.stream);
+	}
+
+	inline void FileWriter::WriteData(const char* const data, const UInt size) {
+		if (size == 0) return;
+
+		const UInt capacity = stream->buffer.Length();
+
+		if (stream->size + size > capacity) {
+			Flush();
+
+			if (size >= capacity) {
+				stream->file.write(data, size);
+				return;
+			}
+		}
+
+		std::memcpy((char*)stream->buffer + stream->size, data, size);
+		stream->size += size;
+	}
+
+	inline void FileWriter::WriteSegments(const StringView* const segments, const UInt count) {
+		const UInt capacity = stream->buffer.Length();
+
+		for (UInt i = 0; i < count; i++) {
+			const char* data = segments[i].Data();
+			UInt size = segments[i].Length();
+
+			if (size == 0) continue;
+
+			if (stream->size + size > capacity) {
+				const UInt space = capacity - stream->size;
+
+				if (space > 0) {
+					std::memcpy((char*)stream->buffer + stream->size, data, space);
+					stream->size = capacity;
+				}
+
+				Flush();
+
+				data += space;
+				size -= space;
+
+				if (size >= capacity) {
+					stream->file.write(data, size);
+					continue;
+				}
+			}
+
+			std::memcpy((char*)stream->buffer + stream->size, data, size);
+			stream->size += size;
+		}
 	}
 
 	inline void FileWriter::WriteText(const String& filename, const String& text, const FileMode mode) {
@@ -433,6 +997,465 @@ namespace Boxx {
 		writer.Write(buffer);
 		writer.Close();
 	}
+
+	inline std::future<void> FileWriter::WriteAsync(const String& filename, const String& text, const FileMode mode) {
+		Array<char> data = Array<char>(text.Length());
+		if (text.Length() > 0) std::memcpy((char*)data, (const char*)text, text.Length());
+		return WriteAsync(filename, std::move(data), mode);
+	}
+
+	inline std::future<void> FileWriter::WriteAsync(const String& filename, const Buffer& buffer, const FileMode mode) {
+		Array<char> data = Array<char>(buffer.Size());
+		if (buffer.Size() > 0) std::memcpy((char*)data, (const char*)buffer.Data(), buffer.Size());
+		return WriteAsync(filename, std::move(data), mode);
+	}
+
+	inline std::future<void> FileWriter::WriteAsync(const String& filename, Array<char>&& data, const FileMode mode) {
+#ifdef _BOXX_IO_URING
+		FileRing* const ring = FileRing::Get();
+
+		if (ring && ring->Reserve()) {
+			FileRingWrite* const request = new FileRingWrite(filename, std::move(data));
+			std::future<void> future = request->promise.get_future();
+
+			io_uring_sqe sqe = {};
+			sqe.opcode = IORING_OP_OPENAT;
+			sqe.fd = AT_FDCWD;
+			sqe.addr = (__u64)(const char*)request->filename;
+			sqe.len = 0666;
+			sqe.open_flags = O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC;
+
+			ring->Submit(sqe, request);
+			return future;
+		}
+#endif
+
+		// The array is moved into the task so only the I/O thread holds a reference to it
+		std::shared_ptr<Array<char>> shared = std::make_shared<Array<char>>(std::move(data));
+
+		return ThreadPool::IO().Run([filename, shared, mode]() {
+			FileWriter writer = FileWriter(filename, mode);
+			writer.WriteV(StringView((const char*)*shared, shared->Length()));
+			writer.Close();
+		});
+	}
+
+	inline CompressedFileReader::CompressedFileReader() {
+
+	}
+
+	inline CompressedFileReader::CompressedFileReader(const char* const filename) {
+		file = new std::ifstream(filename, std::fstream::binary);
+
+		if (!file->is_open()) {
+			throw FileNotFoundError("Could not find file: " + String(filename));
+		}
+	}
+
+	inline CompressedFileReader::CompressedFileReader(const CompressedFileReader& file) {
+		done = file.done;
+		this->file = file.file;
+	}
+
+	inline CompressedFileReader::CompressedFileReader(CompressedFileReader&& file) noexcept {
+		done = file.done;
+		this->file = std::move(file.file);
+	}
+
+	inline CompressedFileReader::~CompressedFileReader() {
+
+	}
+
+	inline String CompressedFileReader::ReadAll() {
+		return ReadToBuffer().ToString();
+	}
+
+	inline Buffer CompressedFileReader::ReadToBuffer() {
+		if (!IsOpen())
+			throw FileClosedError("File is closed");
+		else if (done)
+			throw EndOfFileError("End of file reached");
+
+		CompressionDecoder decoder;
+		Buffer buffer = Buffer(blockSize);
+		Array<char> block = Array<char>(blockSize);
+
+		const auto output = [&buffer](const UByte* const data, const UInt size) {
+			buffer.WriteBytes(data, size);
+		};
+
+		while (*file) {
+			file->read((char*)block, blockSize);
+			decoder.Write((const UByte*)(const char*)block, (UInt)file->gcount(), output);
+		}
+
+		done = true;
+		decoder.Finish();
+		buffer.SetPos(0);
+		return buffer;
+	}
+
+	inline void CompressedFileReader::Close() {
+		if (IsOpen()) file->close();
+	}
+
+	inline bool CompressedFileReader::IsOpen() {
+		return file != nullptr && file->is_open();
+	}
+
+	inline void CompressedFileReader::operator=(const CompressedFileReader& file) {
+		done = file.done;
+		this->file = file.file;
+	}
+
+	inline void CompressedFileReader::operator=(CompressedFileReader&& file) noexcept {
+		done = file.done;
+		this->file = std::move(file.file);
+	}
+
+	inline String CompressedFileReader::ReadText(const String& filename) {
+		CompressedFileReader reader = CompressedFileReader(filename);
+		String text = reader.ReadAll();
+		reader.Close();
+		return text;
+	}
+
+	inline Buffer CompressedFileReader::ReadBuffer(const String& filename) {
+		CompressedFileReader reader = CompressedFileReader(filename);
+		Buffer buffer = reader.ReadToBuffer();
+		reader.Close();
+		return buffer;
+	}
+
+	inline CompressedFileWriter::CompressedFileWriter() {
+
+	}
+
+	inline CompressedFileWriter::CompressedFileWriter(const char* const filename, const CompressionLevel level) {
+		stream = new Stream(filename, level);
+	}
+
+	inline CompressedFileWriter::CompressedFileWriter(const CompressedFileWriter& file) {
+		stream = file.stream;
+	}
+
+	inline CompressedFileWriter::CompressedFileWriter(CompressedFileWriter&& file) noexcept {
+		stream = std::move(file.stream);
+	}
+
+	inline CompressedFileWriter::~CompressedFileWriter() {
+
+	}
+
+	inline void CompressedFileWriter::Write(const String& text) {
+		if (!IsOpen())
+			throw FileClosedError("File is closed");
+
+		stream->Write((const UByte*)(const char*)text, text.Length());
+	}
+
+	inline void CompressedFileWriter::Write(const Buffer& data) {
+		if (!IsOpen())
+			throw FileClosedError("File is closed");
+
+		stream->Write(data.Data(), data.Size());
+	}
+
+	inline void CompressedFileWriter::Close() {
+		if (!IsOpen())
+			throw FileClosedError("File is closed");
+
+		stream->Finish();
+		stream->file.Close();
+	}
+
+	inline bool CompressedFileWriter::IsOpen() const {
+		return stream != nullptr && stream->file.IsOpen();
+	}
+
+	inline void CompressedFileWriter::operator=(const CompressedFileWriter& file) {
+		stream = file.stream;
+	}
+
+	inline void CompressedFileWriter::operator=(CompressedFileWriter&& file) noexcept {
+		stream = std::move(file.stream);
+	}
+
+	inline void CompressedFileWriter::WriteText(const String& filename, const String& text, const CompressionLevel level) {
+		CompressedFileWriter writer = CompressedFileWriter(filename, level);
+		writer.Write(text);
+		writer.Close();
+	}
+
+	inline void CompressedFileWriter::WriteBuffer(const String& filename, const Buffer& buffer, const CompressionLevel level) {
+		CompressedFileWriter writer = CompressedFileWriter(filename, level);
+		writer.Write(buffer);
+		writer.Close();
+	}
+
+#ifdef _BOXX_IO_URING
+	inline FileRing::FileRing() {
+		io_uring_params params = {};
+		fd = (int)syscall(__NR_io_uring_setup, 64, &params);
+
+		if (fd < 0) return;
+
+		// Opening files and non vectored reads and writes require a kernel with fast poll
+		if ((params.features & IORING_FEAT_FAST_POLL) == 0) {
+			close(fd);
+			fd = -1;
+			return;
+		}
+
+		sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+		cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+		sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+		capacity = params.cq_entries - 1;
+
+		sqRing = mmap(nullptr, sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+		cqRing = mmap(nullptr, cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+		sqes = (io_uring_sqe*)mmap(nullptr, sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+
+		if (sqRing == MAP_FAILED || cqRing == MAP_FAILED || sqes == (io_uring_sqe*)MAP_FAILED) {
+			if (sqRing != MAP_FAILED) munmap(sqRing, sqRingSize);
+			if (cqRing != MAP_FAILED) munmap(cqRing, cqRingSize);
+			if (sqes != (io_uring_sqe*)MAP_FAILED) munmap(sqes, sqesSize);
+			close(fd);
+			fd = -1;
+			return;
+		}
+
+		UByte* const sq = (UByte*)sqRing;
+		sqHead    = (unsigned*)(sq + params.sq_off.head);
+		sqTail    = (unsigned*)(sq + params.sq_off.tail);
+		sqMask    = (unsigned*)(sq + params.sq_off.ring_mask);
+		sqEntries = (unsigned*)(sq + params.sq_off.ring_entries);
+		sqArray   = (unsigned*)(sq + params.sq_off.array);
+
+		UByte* const cq = (UByte*)cqRing;
+		cqHead = (unsigned*)(cq + params.cq_off.head);
+		cqTail = (unsigned*)(cq + params.cq_off.tail);
+		cqMask = (unsigned*)(cq + params.cq_off.ring_mask);
+		cqes   = (io_uring_cqe*)(cq + params.cq_off.cqes);
+
+		thread = std::thread([this]() {
+			Run();
+		});
+	}
+
+	inline FileRing::~FileRing() {
+		if (fd < 0) return;
+
+		// A request without user data wakes the completion thread which stops once all requests are done
+		stopping = true;
+
+		io_uring_sqe sqe = {};
+		sqe.opcode = IORING_OP_NOP;
+		Submit(sqe, nullptr);
+
+		thread.join();
+
+		munmap(sqRing, sqRingSize);
+		munmap(cqRing, cqRingSize);
+		munmap(sqes, sqesSize);
+		close(fd);
+	}
+
+	inline void FileRing::Submit(io_uring_sqe sqe, Request* const request) {
+		sqe.user_data = (__u64)request;
+
+		int error = 0;
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+
+			const unsigned tail = *sqTail;
+			const unsigned index = tail & *sqMask;
+
+			sqes[index] = sqe;
+			sqArray[index] = index;
+			__atomic_store_n(sqTail, tail + 1, __ATOMIC_RELEASE);
+
+			// The completion queue can hold a completion for each request so the kernel consumes the entry before returning
+			while (syscall(__NR_io_uring_enter, fd, 1, 0, 0, nullptr, 0) < 0) {
+				if (errno != EINTR && errno != EAGAIN) {
+					error = errno;
+					break;
+				}
+
+				std::this_thread::yield();
+			}
+
+			// The kernel only reads the queue while it is entered so a rejected entry can be removed
+			if (error != 0) {
+				__atomic_store_n(sqTail, tail, __ATOMIC_RELEASE);
+			}
+		}
+
+		// The error is not a retry error so the request finishes with the error
+		if (error != 0 && request && request->Complete(*this, -error)) {
+			delete request;
+			pending--;
+		}
+	}
+
+	inline bool FileRing::Reserve() {
+		UInt count = pending;
+
+		while (count < capacity) {
+			if (pending.compare_exchange_weak(count, count + 1)) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	inline FileRing* FileRing::Get() {
+		static FileRing ring;
+		return ring.fd >= 0 ? &ring : nullptr;
+	}
+
+	inline void FileRing::Run() {
+		while (true) {
+			const unsigned head = *cqHead;
+
+			if (head == __atomic_load_n(cqTail, __ATOMIC_ACQUIRE)) {
+				if (stopping && pending == 0) return;
+				syscall(__NR_io_uring_enter, fd, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0);
+				continue;
+			}
+
+			const io_uring_cqe cqe = cqes[head & *cqMask];
+			__atomic_store_n(cqHead, head + 1, __ATOMIC_RELEASE);
+
+			if (cqe.user_data == 0) continue;
+
+			Request* const request = (Request*)cqe.user_data;
+
+			// A request that is not done submits its next operation and keeps its reservation
+			if (request->Complete(*this, cqe.res)) {
+				delete request;
+				pending--;
+			}
+		}
+	}
+
+	inline FileRingRead::FileRingRead(const String& filename) {
+		this->filename = filename;
+	}
+
+	inline bool FileRingRead::Complete(FileRing& ring, const int result) {
+		if (fd < 0) {
+			if (result < 0) {
+				promise.set_exception(std::make_exception_ptr(FileNotFoundError("Could not find file: " + filename)));
+				return true;
+			}
+
+			fd = result;
+
+			// Files without a size, like the ones in /proc, are read until the end of file in growing blocks
+			struct stat info;
+			knownSize = fstat(fd, &info) == 0 && info.st_size > 0;
+			data = Array<UByte>(knownSize ? (UInt)info.st_size : 1 << 12);
+
+			SubmitRead(ring);
+			return false;
+		}
+
+		if (result == -EINTR || result == -EAGAIN) {
+			SubmitRead(ring);
+			return false;
+		}
+
+		if (result < 0) {
+			close(fd);
+			promise.set_exception(std::make_exception_ptr(FileError("Could not read file: " + filename)));
+			return true;
+		}
+
+		size += (UInt)result;
+
+		if (result > 0 && size < data.Length()) {
+			SubmitRead(ring);
+			return false;
+		}
+
+		if (result > 0 && !knownSize) {
+			Array<UByte> grown = Array<UByte>(data.Length() * 2);
+			std::memcpy((UByte*)grown, (const UByte*)data, size);
+			data = grown;
+
+			SubmitRead(ring);
+			return false;
+		}
+
+		close(fd);
+
+		// The array is released before the buffer is handed to another thread
+		Buffer buffer = Buffer(data, size);
+		data = Array<UByte>();
+
+		promise.set_value(std::move(buffer));
+		return true;
+	}
+
+	inline void FileRingRead::SubmitRead(FileRing& ring) {
+		io_uring_sqe sqe = {};
+		sqe.opcode = IORING_OP_READ;
+		sqe.fd = fd;
+		sqe.addr = (__u64)((UByte*)data + size);
+		sqe.len = data.Length() - size;
+		sqe.off = size;
+		ring.Submit(sqe, this);
+	}
+
+	inline FileRingWrite::FileRingWrite(const String& filename, Array<char>&& data) {
+		this->filename = filename;
+		this->data = std::move(data);
+	}
+
+	inline bool FileRingWrite::Complete(FileRing& ring, const int result) {
+		if (fd < 0) {
+			if (result < 0) {
+				promise.set_exception(std::make_exception_ptr(FileOpenError("Could not open file: " + filename)));
+				return true;
+			}
+
+			fd = result;
+		}
+		else if (result == -EINTR || result == -EAGAIN) {
+			// Retries the write
+		}
+		else if (result <= 0) {
+			close(fd);
+			promise.set_exception(std::make_exception_ptr(FileError("Could not write to file: " + filename)));
+			return true;
+		}
+		else {
+			written += (UInt)result;
+		}
+
+		if (written < data.Length()) {
+			SubmitWrite(ring);
+			return false;
+		}
+
+		close(fd);
+		promise.set_value();
+		return true;
+	}
+
+	inline void FileRingWrite::SubmitWrite(FileRing& ring) {
+		io_uring_sqe sqe = {};
+		sqe.opcode = IORING_OP_WRITE;
+		sqe.fd = fd;
+		sqe.addr = (__u64)((const char*)data + written);
+		sqe.len = data.Length() - written;
+		sqe.off = written;
+		ring.Submit(sqe, this);
+	}
+#endif
 }
 
 #endif
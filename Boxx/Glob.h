@@ -0,0 +1,950 @@
+#ifndef _BOXX_GLOB_HEADER
+#define _BOXX_GLOB_HEADER
+
+#include <cstring>
+#include <algorithm>
+#include <vector>
+
+#include "Types.h"
+#include "String.h"
+#include "StringView.h"
+#include "List.h"
+#include "Array.h"
+#include "Optional.h"
+
+///[Settings] block: indent
+
+///[Namespace] Boxx
+namespace Boxx {
+	///[Heading] Glob
+
+	///[Title] GlobPattern
+	/// A compiled glob pattern for matching file paths.
+	///[para] The pattern supports these wildcards:
+	///[item] {*}: Matches any number of characters except {/}.
+	///[item] {**}: Matches any number of directories if it is a whole path segment.
+	///[item] {?}: Matches a single character except {/}.
+	///[item] {[abc]}, {[a-z]}: Matches a single character in the set. {[!abc]} or {[^abc]} matches a character not in the set.
+	///[item] {\{a,b\}}: Matches any of the comma separated alternatives. Alternatives can be nested.
+	///[item] {\\}: Escapes the next character.
+	///[para] If the pattern does not contain a {/} it is matched against the file name of the path.
+	/// Both {/} and {\\} are treated as path separators in the matched paths.
+	///[Block] GlobPattern
+	class GlobPattern final {
+	public:
+		///[Heading] Constructors
+
+		/// Creates a pattern that does not match anything.
+		GlobPattern();
+
+		/// Compiles a glob pattern.
+		explicit GlobPattern(const String& pattern);
+
+		GlobPattern(const GlobPattern& pattern);
+		GlobPattern(GlobPattern&& pattern) noexcept;
+		~GlobPattern();
+
+		///[Heading] Methods
+
+		/// Checks if a path matches the pattern.
+		bool Match(const StringView& path) const;
+
+		/// Gets the source of the pattern.
+		String Pattern() const;
+
+		void operator=(const GlobPattern& pattern);
+		void operator=(GlobPattern&& pattern) noexcept;
+
+	private:
+		friend class GlobSet;
+
+		enum class TokenType : UByte {
+			Char,
+			Any,
+			Class,
+			Star,
+			Globstar,
+			GlobstarSlash
+		};
+
+		struct Token {
+			TokenType type;
+			UByte c;
+			ULong set[4];
+		};
+
+		enum class Kind : UByte {
+			Literal,
+			NameLiteral,
+			Suffix,
+			General
+		};
+
+		struct Alternative {
+			List<Token> tokens;
+			Kind kind;
+			String literal;
+		};
+
+		// Bit parallel state machine for a list of token sequences
+		struct Program {
+			UInt states = 0;
+			UInt words = 0;
+			Array<ULong> advance;
+			Array<ULong> loop;
+			Array<ULong> skip;
+			Array<ULong> skipLoop;
+			Array<ULong> start;
+			Array<ULong> accept;
+			Array<UInt> acceptIndex;
+
+			void Build(const List<List<Token>>& sequences, const List<UInt>& indices);
+			bool Run(const StringView& path, ULong* const result) const;
+		};
+
+		String pattern;
+		List<Alternative> alternatives;
+		Program program;
+
+		static void Expand(const String& pattern, const UInt start, List<String>& alternatives);
+		static Optional<UInt> FindBrace(const String& pattern, UInt i);
+		static UInt SkipClass(const String& pattern, const UInt i);
+		static List<Token> Tokenize(const String& pattern);
+		static Alternative Classify(const List<Token>& tokens);
+
+		static bool MatchAlternative(const Alternative& alternative, const StringView& path);
+		static bool EndsWith(const StringView& path, const String& suffix);
+
+		static bool IsSeparator(const char c) {
+			return c == '/' || c == '\\';
+		}
+	};
+
+	///[Title] GlobSet
+	/// A set of glob patterns that are matched against a path in a single pass.
+	///[para] Literal patterns and file extension patterns like {*.cpp} are looked up directly.
+	/// All other patterns are combined into a single state machine.
+	///[Block] GlobSet
+	class GlobSet final {
+	public:
+		///[Heading] Constructors
+
+		/// Creates an empty set.
+		GlobSet();
+
+		/// Compiles a set of glob patterns.
+		explicit GlobSet(const List<String>& patterns);
+
+		GlobSet(const GlobSet& set);
+		GlobSet(GlobSet&& set) noexcept;
+		~GlobSet();
+
+		///[Heading] Methods
+
+		/// Adds a pattern to the set.
+		void Add(const String& pattern);
+
+		/// Checks if any of the patterns match the path.
+		bool Match(const StringView& path) const;
+
+		/// Gets the indices of all patterns that match the path.
+		///[para] The indices are in the order the patterns were added.
+		List<UInt> Matches(const StringView& path) const;
+
+		/// Gets the number of patterns in the set.
+		UInt Count() const;
+
+		/// Checks if the set is empty.
+		bool IsEmpty() const;
+
+		void operator=(const GlobSet& set);
+		void operator=(GlobSet&& set) noexcept;
+
+	private:
+		struct Entry {
+			String key;
+			UInt index;
+		};
+
+		List<GlobPattern> patterns;
+		List<Entry> literals;
+		List<Entry> nameLiterals;
+		List<Entry> extensions;
+		List<Entry> suffixes;
+		GlobPattern::Program program;
+
+		void Build();
+
+		static void Sort(List<Entry>& entries);
+		static void Find(const List<Entry>& entries, const StringView& key, List<UInt>* const found, bool& matched);
+		static String Normalize(const StringView& path);
+		static StringView GetName(const StringView& path);
+		static StringView GetExtension(const StringView& name);
+	};
+
+	inline GlobPattern::GlobPattern() {
+
+	}
+
+	inline GlobPattern::GlobPattern(const String& pattern) {
+		this->pattern = pattern;
+
+		List<String> sources;
+		Expand(pattern, 0, sources);
+
+		List<List<Token>> general;
+		List<UInt> indices;
+
+		for (const String& source : sources) {
+			Alternative alternative = Classify(Tokenize(source));
+
+			if (alternative.kind == Kind::General) {
+				general.Add(alternative.tokens);
+				indices.Add(0);
+			}
+
+			alternatives.Add(alternative);
+		}
+
+		program.Build(general, indices);
+	}
+
+	inline GlobPattern::GlobPattern(const GlobPattern& pattern) {
+		this->pattern = pattern.pattern;
+		alternatives = pattern.alternatives;
+		program = pattern.program;
+	}
+
+	inline GlobPattern::GlobPattern(GlobPattern&& pattern) noexcept {
+		this->pattern = std::move(pattern.pattern);
+		alternatives = std::move(pattern.alternatives);
+		program = std::move(pattern.program);
+	}
+
+	inline GlobPattern::~GlobPattern() {
+
+	}
+
+	inline bool GlobPattern::Match(const StringView& path) const {
+		if (path.Find('\\')) {
+			return Match(StringView(path.ToString().Replace("\\", "/")));
+		}
+
+		for (const Alternative& alternative : alternatives) {
+			if (alternative.kind != Kind::General && MatchAlternative(alternative, path)) {
+				return true;
+			}
+		}
+
+		return program.Run(path, nullptr);
+	}
+
+	inline String GlobPattern::Pattern() const {
+		return pattern;
+	}
+
+	inline void GlobPattern::operator=(const GlobPattern& pattern) {
+		this->pattern = pattern.pattern;
+		alternatives = pattern.alternatives;
+		program = pattern.program;
+	}
+
+	inline void GlobPattern::operator=(GlobPattern&& pattern) noexcept {
+		this->pattern = std::move(pattern.pattern);
+		alternatives = std::move(pattern.alternatives);
+		program = std::move(pattern.program);
+	}
+
+	inline void GlobPattern::Expand(const String& pattern, const UInt start, List<String>& alternatives) {
+		Optional<UInt> open = FindBrace(pattern, start);
+
+		if (!open) {
+			alternatives.Add(pattern);
+			return;
+		}
+
+		const UInt begin = *open;
+		UInt depth = 0;
+		UInt segment = begin + 1;
+		List<UInt> commas;
+		UInt close = begin;
+
+		for (UInt i = begin; i < pattern.Length(); i++) {
+			const char c = pattern[i];
+
+			if (c == '\\') {
+				i++;
+			}
+			else if (c == '[') {
+				i = SkipClass(pattern, i);
+			}
+			else if (c == '{') {
+				depth++;
+			}
+			else if (c == '}') {
+				if (--depth == 0) {
+					close = i;
+					break;
+				}
+			}
+			else if (c == ',' && depth == 1) {
+				commas.Add(i);
+			}
+		}
+
+		commas.Add(close);
+
+		const String before = begin > 0 ? pattern.Sub(0, begin - 1) : String();
+		const String after = pattern.Sub(close + 1);
+
+		for (const UInt comma : commas) {
+			const String alternative = comma > segment ? pattern.Sub(segment, comma - 1) : String();
+			Expand(before + alternative + after, begin, alternatives);
+			segment = comma + 1;
+		}
+	}
+
+	inline Optional<UInt> GlobPattern::FindBrace(const String& pattern, UInt i) {
+		for (; i < pattern.Length(); i++) {
+			const char c = pattern[i];
+
+			if (c == '\\') {
+				i++;
+			}
+			else if (c == '[') {
+				i = SkipClass(pattern, i);
+			}
+			else if (c == '{') {
+				UInt depth = 0;
+
+				// Only braces with a matching closing brace are alternatives
+				for (UInt u = i; u < pattern.Length(); u++) {
+					const char b = pattern[u];
+
+					if (b == '\\') {
+						u++;
+					}
+					else if (b == '[') {
+						u = SkipClass(pattern, u);
+					}
+					else if (b == '{') {
+						depth++;
+					}
+					else if (b == '}' && --depth == 0) {
+						return i;
+					}
+				}
+			}
+		}
+
+		return nullptr;
+	}
+
+	inline UInt GlobPattern::SkipClass(const String& pattern, const UInt i) {
+		UInt u = i + 1;
+
+		if (u < pattern.Length() && (pattern[u] == '!' || pattern[u] == '^')) u++;
+		if (u < pattern.Length() && pattern[u] == ']') u++;
+
+		for (; u < pattern.Length(); u++) {
+			if (pattern[u] == '\\') {
+				u++;
+			}
+			else if (pattern[u] == ']') {
+				return u;
+			}
+		}
+
+		// Not a class if there is no closing bracket
+		return i;
+	}
+
+	inline List<GlobPattern::Token> GlobPattern::Tokenize(const String& pattern) {
+		List<Token> tokens;
+
+		bool hasSeparator = false;
+
+		for (UInt i = 0; i < pattern.Length(); i++) {
+			if (pattern[i] == '\\') {
+				i++;
+			}
+			else if (pattern[i] == '[') {
+				i = SkipClass(pattern, i);
+			}
+			else if (pattern[i] == '/') {
+				hasSeparator = true;
+				break;
+			}
+		}
+
+		Token token = {};
+
+		// Patterns without a separator match the file name in any directory
+		if (!hasSeparator) {
+			token.type = TokenType::GlobstarSlash;
+			tokens.Add(token);
+		}
+
+		const UInt length = pattern.Length();
+
+		for (UInt i = 0; i < length; i++) {
+			const char c = pattern[i];
+			token = {};
+
+			if (c == '\\' && i + 1 < length) {
+				token.type = TokenType::Char;
+				token.c = (UByte)pattern[++i];
+			}
+			else if (c == '*') {
+				UInt end = i;
+				while (end < length && pattern[end] == '*') end++;
+
+				const bool segmentStart = i == 0 || pattern[i - 1] == '/';
+				const bool segmentEnd = end == length || pattern[end] == '/';
+
+				if (end - i >= 2 && segmentStart && segmentEnd) {
+					if (end < length) {
+						token.type = TokenType::GlobstarSlash;
+						end++;
+					}
+					else {
+						token.type = TokenType::Globstar;
+					}
+				}
+				else {
+					token.type = TokenType::Star;
+				}
+
+				i = end - 1;
+			}
+			else if (c == '?') {
+				token.type = TokenType::Any;
+			}
+			else if (c == '[' && SkipClass(pattern, i) != i) {
+				const UInt close = SkipClass(pattern, i);
+				UInt u = i + 1;
+				bool negate = false;
+
+				if (pattern[u] == '!' || pattern[u] == '^') {
+					negate = true;
+					u++;
+				}
+
+				token.type = TokenType::Class;
+				bool first = true;
+
+				for (; u < close; u++) {
+					UByte from = (UByte)pattern[u];
+
+					if (from == ']' && !first) break;
+					first = false;
+
+					if (from == '\\' && u + 1 < close) {
+						from = (UByte)pattern[++u];
+					}
+
+					UByte to = from;
+
+					if (u + 2 < close && pattern[u + 1] == '-') {
+						u += 2;
+						to = (UByte)pattern[u];
+
+						if (to == '\\' && u + 1 < close) {
+							to = (UByte)pattern[++u];
+						}
+					}
+
+					for (UInt b = from; b <= to; b++) {
+						token.set[b / 64] |= 1ULL << (b % 64);
+					}
+				}
+
+				if (negate) {
+					for (UInt w = 0; w < 4; w++) {
+						token.set[w] = ~token.set[w];
+					}
+				}
+
+				token.set['/' / 64] &= ~(1ULL << ('/' % 64));
+				token.set['\\' / 64] &= ~(1ULL << ('\\' % 64));
+				i = close;
+			}
+			else {
+				token.type = TokenType::Char;
+				token.c = (UByte)(c == '\\' ? '/' : c);
+			}
+
+			// Consecutive stars are the same as a single star
+			if (token.type == TokenType::Star && !tokens.IsEmpty() && tokens.Last().type == TokenType::Star) continue;
+
+			tokens.Add(token);
+		}
+
+		return tokens;
+	}
+
+	inline GlobPattern::Alternative GlobPattern::Classify(const List<Token>& tokens) {
+		Alternative alternative;
+		alternative.tokens = tokens;
+		alternative.kind = Kind::General;
+
+		UInt start = 0;
+		Kind kind = Kind::Literal;
+
+		if (tokens.Count() >= 1 && tokens[0].type == TokenType::GlobstarSlash) {
+			start = 1;
+			kind = Kind::NameLiteral;
+
+			if (tokens.Count() >= 2 && tokens[1].type == TokenType::Star) {
+				start = 2;
+				kind = Kind::Suffix;
+			}
+		}
+
+		String literal;
+
+		for (UInt i = start; i < tokens.Count(); i++) {
+			if (tokens[i].type != TokenType::Char) return alternative;
+			if (kind != Kind::Literal && tokens[i].c == '/') return alternative;
+			literal += (char)tokens[i].c;
+		}
+
+		if (kind == Kind::Suffix && literal.Length() == 0) return alternative;
+
+		alternative.kind = kind;
+		alternative.literal = literal;
+		return alternative;
+	}
+
+	inline bool GlobPattern::MatchAlternative(const Alternative& alternative, const StringView& path) {
+		switch (alternative.kind) {
+			case Kind::Literal: {
+				return path == StringView(alternative.literal);
+			}
+
+			case Kind::NameLiteral: {
+				if (!EndsWith(path, alternative.literal)) return false;
+				return path.Length() == alternative.literal.Length() || path[path.Length() - alternative.literal.Length() - 1] == '/';
+			}
+
+			case Kind::Suffix: {
+				return EndsWith(path, alternative.literal);
+			}
+
+			default: {
+				return false;
+			}
+		}
+	}
+
+	inline bool GlobPattern::EndsWith(const StringView& path, const String& suffix) {
+		return path.Length() >= suffix.Length() && std::memcmp(path.Data() + path.Length() - suffix.Length(), (const char*)suffix, suffix.Length()) == 0;
+	}
+
+	inline void GlobPattern::Program::Build(const List<List<Token>>& sequences, const List<UInt>& indices) {
+		states = 0;
+
+		for (const List<Token>& tokens : sequences) {
+			states += tokens.Count() + 1;
+		}
+
+		words = (states + 63) / 64;
+
+		if (words == 0) {
+			advance = Array<ULong>();
+			loop = Array<ULong>();
+			skip = Array<ULong>();
+			skipLoop = Array<ULong>();
+			start = Array<ULong>();
+			accept = Array<ULong>();
+			acceptIndex = Array<UInt>();
+			return;
+		}
+
+		advance = Array<ULong>(256 * words);
+		loop = Array<ULong>(256 * words);
+		skip = Array<ULong>(words);
+		skipLoop = Array<ULong>(words);
+		start = Array<ULong>(words);
+		accept = Array<ULong>(words);
+		acceptIndex = Array<UInt>(states);
+
+		std::memset((ULong*)advance, 0, sizeof(ULong) * 256 * words);
+		std::memset((ULong*)loop, 0, sizeof(ULong) * 256 * words);
+		std::memset((ULong*)skip, 0, sizeof(ULong) * words);
+		std::memset((ULong*)skipLoop, 0, sizeof(ULong) * words);
+		std::memset((ULong*)start, 0, sizeof(ULong) * words);
+		std::memset((ULong*)accept, 0, sizeof(ULong) * words);
+
+		UInt state = 0;
+
+		for (UInt s = 0; s < sequences.Count(); s++) {
+			start[state / 64] |= 1ULL << (state % 64);
+
+			for (const Token& token : sequences[s]) {
+				const UInt word = state / 64;
+				const ULong bit = 1ULL << (state % 64);
+
+				for (UInt c = 0; c < 256; c++) {
+					const bool separator = c == '/';
+					bool advances = false;
+					bool loops = false;
+
+					switch (token.type) {
+						case TokenType::Char:          advances = c == token.c; break;
+						case TokenType::Any:           advances = !separator; break;
+						case TokenType::Class:         advances = (token.set[c / 64] >> (c % 64)) & 1; break;
+						case TokenType::Star:          loops = !separator; break;
+						case TokenType::Globstar:      loops = true; break;
+						case TokenType::GlobstarSlash: loops = true; advances = separator; break;
+					}
+
+					if (advances) advance[c * words + word] |= bit;
+					if (loops) loop[c * words + word] |= bit;
+				}
+
+				// Wildcards can be skipped when they are entered
+				if (token.type == TokenType::Star || token.type == TokenType::Globstar || token.type == TokenType::GlobstarSlash) {
+					skip[word] |= bit;
+				}
+
+				// {**/} can only be left through a separator once it has matched a character
+				if (token.type == TokenType::Star || token.type == TokenType::Globstar) {
+					skipLoop[word] |= bit;
+				}
+
+				state++;
+			}
+
+			accept[state / 64] |= 1ULL << (state % 64);
+			acceptIndex[state] = indices[s];
+			state++;
+		}
+	}
+
+	inline bool GlobPattern::Program::Run(const StringView& path, ULong* const result) const {
+		if (words == 0) return false;
+
+		ULong small[8];
+		std::vector<ULong> large;
+		ULong* current = small;
+
+		if (words > 4) {
+			large.resize(words * 2);
+			current = large.data();
+		}
+
+		ULong* next = current + words;
+
+		const ULong* const skipMask = (const ULong*)skip;
+		const ULong* const skipLoopMask = (const ULong*)skipLoop;
+
+		// Adds the states after the wildcards that can match nothing
+		// Skips only move states forward so a single pass is enough
+		auto close = [this, skipMask](ULong* const set) {
+			ULong carry = 0;
+
+			for (UInt w = 0; w < words; w++) {
+				ULong bits = set[w] | carry;
+
+				if (bits == 0) {
+					carry = 0;
+					continue;
+				}
+
+				ULong added = (bits & skipMask[w]) << 1;
+
+				while ((added & ~bits) != 0) {
+					bits |= added;
+					added = (bits & skipMask[w]) << 1;
+				}
+
+				set[w] = bits;
+				carry = (bits & skipMask[w]) >> 63;
+			}
+		};
+
+		std::memcpy(current, (const ULong*)start, sizeof(ULong) * words);
+		close(current);
+
+		for (UInt i = 0; i < path.Length(); i++) {
+			const UByte c = (UByte)path[i];
+			const ULong* const advanceMask = (const ULong*)advance + c * words;
+			const ULong* const loopMask = (const ULong*)loop + c * words;
+
+			ULong carry = 0;
+			ULong any = 0;
+
+			// Looping states are kept in current while the entered states are collected in next
+			for (UInt w = 0; w < words; w++) {
+				if (current[w] == 0) {
+					next[w] = carry;
+					carry = 0;
+					continue;
+				}
+
+				const ULong looped = current[w] & loopMask[w];
+				const ULong entered = (current[w] & advanceMask[w]) | (looped & skipLoopMask[w]);
+				next[w] = (entered << 1) | carry;
+				carry = entered >> 63;
+				current[w] = looped;
+			}
+
+			close(next);
+
+			for (UInt w = 0; w < words; w++) {
+				next[w] |= current[w];
+				any |= next[w];
+			}
+
+			if (any == 0) return false;
+
+			std::swap(current, next);
+		}
+
+		bool matched = false;
+
+		for (UInt w = 0; w < words; w++) {
+			const ULong accepted = current[w] & accept[w];
+			if (accepted != 0) matched = true;
+			if (result) result[w] = accepted;
+		}
+
+		return matched;
+	}
+
+	inline GlobSet::GlobSet() {
+
+	}
+
+	inline GlobSet::GlobSet(const List<String>& patterns) {
+		for (const String& pattern : patterns) {
+			this->patterns.Add(GlobPattern(pattern));
+		}
+
+		Build();
+	}
+
+	inline GlobSet::GlobSet(const GlobSet& set) {
+		patterns = set.patterns;
+		literals = set.literals;
+		nameLiterals = set.nameLiterals;
+		extensions = set.extensions;
+		suffixes = set.suffixes;
+		program = set.program;
+	}
+
+	inline GlobSet::GlobSet(GlobSet&& set) noexcept {
+		patterns = std::move(set.patterns);
+		literals = std::move(set.literals);
+		nameLiterals = std::move(set.nameLiterals);
+		extensions = std::move(set.extensions);
+		suffixes = std::move(set.suffixes);
+		program = std::move(set.program);
+	}
+
+	inline GlobSet::~GlobSet() {
+
+	}
+
+	inline void GlobSet::Add(const String& pattern) {
+		patterns.Add(GlobPattern(pattern));
+		Build();
+	}
+
+	inline bool GlobSet::Match(const StringView& path) const {
+		if (path.Find('\\')) {
+			return Match(Normalize(path));
+		}
+
+		bool matched = false;
+		const StringView name = GetName(path);
+
+		Find(literals, path, nullptr, matched);
+		if (matched) return true;
+
+		Find(nameLiterals, name, nullptr, matched);
+		if (matched) return true;
+
+		Find(extensions, GetExtension(name), nullptr, matched);
+		if (matched) return true;
+
+		for (const Entry& entry : suffixes) {
+			if (GlobPattern::EndsWith(path, entry.key)) return true;
+		}
+
+		return program.Run(path, nullptr);
+	}
+
+	inline List<UInt> GlobSet::Matches(const StringView& path) const {
+		if (path.Find('\\')) {
+			return Matches(Normalize(path));
+		}
+
+		List<UInt> found;
+		bool matched = false;
+		const StringView name = GetName(path);
+
+		Find(literals, path, &found, matched);
+		Find(nameLiterals, name, &found, matched);
+		Find(extensions, GetExtension(name), &found, matched);
+
+		for (const Entry& entry : suffixes) {
+			if (GlobPattern::EndsWith(path, entry.key)) found.Add(entry.index);
+		}
+
+		std::vector<ULong> result = std::vector<ULong>(program.words);
+
+		if (program.Run(path, result.data())) {
+			for (UInt w = 0; w < program.words; w++) {
+				for (ULong bits = result[w]; bits != 0; bits &= bits - 1) {
+					UInt bit = 0;
+					while (((bits >> bit) & 1) == 0) bit++;
+					found.Add(program.acceptIndex[w * 64 + bit]);
+				}
+			}
+		}
+
+		// Brace alternatives can match the same pattern more than once
+		std::sort(found.begin(), found.end());
+		UInt* const last = std::unique(found.begin(), found.end());
+
+		List<UInt> indices = List<UInt>(found.Count());
+
+		for (UInt* i = found.begin(); i != last; i++) {
+			indices.Add(*i);
+		}
+
+		return indices;
+	}
+
+	inline UInt GlobSet::Count() const {
+		return patterns.Count();
+	}
+
+	inline bool GlobSet::IsEmpty() const {
+		return patterns.IsEmpty();
+	}
+
+	inline void GlobSet::operator=(const GlobSet& set) {
+		patterns = set.patterns;
+		literals = set.literals;
+		nameLiterals = set.nameLiterals;
+		extensions = set.extensions;
+		suffixes = set.suffixes;
+		program = set.program;
+	}
+
+	inline void GlobSet::operator=(GlobSet&& set) noexcept {
+		patterns = std::move(set.patterns);
+		literals = std::move(set.literals);
+		nameLiterals = std::move(set.nameLiterals);
+		extensions = std::move(set.extensions);
+		suffixes = std::move(set.suffixes);
+		program = std::move(set.program);
+	}
+
+	inline void GlobSet::Build() {
+		literals = List<Entry>();
+		nameLiterals = List<Entry>();
+		extensions = List<Entry>();
+		suffixes = List<Entry>();
+
+		List<List<GlobPattern::Token>> general;
+		List<UInt> indices;
+
+		for (UInt i = 0; i < patterns.Count(); i++) {
+			for (const GlobPattern::Alternative& alternative : patterns[i].alternatives) {
+				Entry entry;
+				entry.key = alternative.literal;
+				entry.index = i;
+
+				switch (alternative.kind) {
+					case GlobPattern::Kind::Literal: {
+						literals.Add(entry);
+						break;
+					}
+
+					case GlobPattern::Kind::NameLiteral: {
+						nameLiterals.Add(entry);
+						break;
+					}
+
+					case GlobPattern::Kind::Suffix: {
+						// Suffixes like .cpp are looked up by the extension of the file name
+						if (entry.key[0] == '.' && !entry.key.Sub(1).Find('.')) {
+							entry.key = entry.key.Sub(1);
+							extensions.Add(entry);
+						}
+						else {
+							suffixes.Add(entry);
+						}
+
+						break;
+					}
+
+					default: {
+						general.Add(alternative.tokens);
+						indices.Add(i);
+						break;
+					}
+				}
+			}
+		}
+
+		Sort(literals);
+		Sort(nameLiterals);
+		Sort(extensions);
+
+		program.Build(general, indices);
+	}
+
+	inline void GlobSet::Sort(List<Entry>& entries) {
+		std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+			return std::strcmp(a.key, b.key) < 0;
+		});
+	}
+
+	inline void GlobSet::Find(const List<Entry>& entries, const StringView& key, List<UInt>* const found, bool& matched) {
+		auto compare = [](const StringView& a, const StringView& b) {
+			const Int result = std::memcmp(a.Data(), b.Data(), std::min(a.Length(), b.Length()));
+			return result != 0 ? result < 0 : a.Length() < b.Length();
+		};
+
+		const Entry* const first = std::lower_bound(entries.begin(), entries.end(), key, [&compare](const Entry& entry, const StringView& key) {
+			return compare(StringView(entry.key), key);
+		});
+
+		for (const Entry* entry = first; entry != entries.end() && StringView(entry->key) == key; entry++) {
+			matched = true;
+			if (found) found->Add(entry->index);
+		}
+	}
+
+	inline String GlobSet::Normalize(const StringView& path) {
+		return path.ToString().Replace("\\", "/");
+	}
+
+	inline StringView GlobSet::GetName(const StringView& path) {
+		for (UInt i = path.Length(); i > 0; i--) {
+			if (GlobPattern::IsSeparator(path[i - 1])) {
+				return path.Sub(i);
+			}
+		}
+
+		return path;
+	}
+
+	inline StringView GlobSet::GetExtension(const StringView& name) {
+		for (UInt i = name.Length(); i > 0; i--) {
+			if (name[i - 1] == '.') {
+				return name.Sub(i);
+			}
+		}
+
+		// A name without a dot can not match an extension pattern
+		return StringView("\0", 1);
+	}
+}
+
+#endif
@@ -0,0 +1,675 @@
+#ifndef _BOXX_HASH_HEADER
+#define _BOXX_HASH_HEADER
+
+#include <cstring>
+
+#include "Types.h"
+#include "String.h"
+#include "StringView.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define _BOXX_HASH_X64
+
+#include <nmmintrin.h>
+#include <wmmintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#define _BOXX_HASH_TARGET
+#else
+#define _BOXX_HASH_TARGET __attribute__((target("sse4.2,pclmul")))
+#endif
+#elif defined(__ARM_FEATURE_CRC32)
+#define _BOXX_HASH_ARM
+
+#include <arm_acle.h>
+#endif
+
+///[Settings] block: indent
+
+///[Namespace] Boxx
+namespace Boxx {
+	// The buffer overloads are defined in Buffer.h
+	class Buffer;
+
+	///[Heading] Hashing
+
+	///[Title] Hash
+	/// Static class for checksums and non cryptographic hashes.
+	///[para] The hashes are fast but are not suitable for security purposes.
+	///[Block] Hash
+	class Hash final {
+	public:
+		Hash() = delete;
+
+		///[Heading] Static Functions
+
+		/// Calculates the CRC-32C (Castagnoli) checksum of data.
+		///[para] Uses the SSE 4.2 and PCLMUL instructions or the ARM CRC instructions if they are available.
+		///[Arg] data: The data to calculate the checksum for.
+		///[Arg] size: The size of the data in bytes.
+		///[Arg] crc: The checksum of the previous data to continue from.
+		/// Use {0} to start a new checksum.
+		static UInt CRC32C(const void* const data, const UInt size, const UInt crc = 0);
+
+		/// Calculates the CRC-32C (Castagnoli) checksum of the characters in a string.
+		///[Arg] crc: The checksum of the previous data to continue from.
+		static UInt CRC32C(const StringView& text, const UInt crc = 0);
+
+		/// Calculates the CRC-32C (Castagnoli) checksum of the data in a buffer.
+		///[Arg] crc: The checksum of the previous data to continue from.
+		static UInt CRC32C(const Buffer& buffer, const UInt crc = 0);
+
+		/// Calculates the 32-bit xxHash of data.
+		///[Arg] data: The data to hash.
+		///[Arg] size: The size of the data in bytes.
+		///[Arg] seed: The seed of the hash.
+		static UInt XXH32(const void* const data, const UInt size, const UInt seed = 0);
+
+		/// Calculates the 32-bit xxHash of the characters in a string.
+		static UInt XXH32(const StringView& text, const UInt seed = 0);
+
+		/// Calculates the 32-bit xxHash of the data in a buffer.
+		static UInt XXH32(const Buffer& buffer, const UInt seed = 0);
+
+		/// Calculates the 64-bit xxHash of data.
+		///[Arg] data: The data to hash.
+		///[Arg] size: The size of the data in bytes.
+		///[Arg] seed: The seed of the hash.
+		static ULong XXH64(const void* const data, const UInt size, const ULong seed = 0);
+
+		/// Calculates the 64-bit xxHash of the characters in a string.
+		static ULong XXH64(const StringView& text, const ULong seed = 0);
+
+		/// Calculates the 64-bit xxHash of the data in a buffer.
+		static ULong XXH64(const Buffer& buffer, const ULong seed = 0);
+
+	private:
+		friend class XXH32Hasher;
+		friend class XXH64Hasher;
+
+		struct CRCTables {
+			UInt table[8][256];
+			bool hardware = false;
+
+			// Multipliers that shift a checksum past the parallel streams
+			UInt shortShift[2];
+			UInt longShift[2];
+
+			CRCTables();
+		};
+
+		static const UInt crcPolynomial = 0x82F63B78;
+		static const UInt shortBlock = 256;
+		static const UInt longBlock = 4096;
+
+		static const CRCTables& Tables();
+		static UInt CRCSoftware(UInt crc, const UByte* data, UInt size);
+		static UInt ShiftConstant(const UInt bytes);
+
+#ifdef _BOXX_HASH_X64
+		_BOXX_HASH_TARGET static UInt CRCHardware(UInt crc, const UByte* data, UInt size);
+		_BOXX_HASH_TARGET static ULong CRCStreams(ULong crc, const UByte* data, const UInt block, const UInt* const shift);
+		static bool HasHardware();
+#elif defined(_BOXX_HASH_ARM)
+		static UInt CRCHardware(UInt crc, const UByte* data, UInt size);
+#endif
+
+		static UInt Read32(const UByte* const data) {
+			return (UInt)data[0] | ((UInt)data[1] << 8) | ((UInt)data[2] << 16) | ((UInt)data[3] << 24);
+		}
+
+		static ULong Read64(const UByte* const data) {
+			return (ULong)Read32(data) | ((ULong)Read32(data + 4) << 32);
+		}
+
+		static UInt Rotate(const UInt value, const UInt bits) {
+			return (value << bits) | (value >> (32 - bits));
+		}
+
+		static ULong Rotate(const ULong value, const UInt bits) {
+			return (value << bits) | (value >> (64 - bits));
+		}
+	};
+
+	///[Title] CRC32CHasher
+	/// Calculates a CRC-32C checksum incrementally.
+	///[Block] CRC32CHasher
+	class CRC32CHasher final {
+	public:
+		///[Heading] Constructors
+
+		/// Creates a hasher for a new checksum.
+		CRC32CHasher();
+
+		///[Heading] Methods
+
+		/// Adds data to the checksum.
+		void Update(const void* const data, const UInt size);
+
+		/// Adds the characters of a string to the checksum.
+		void Update(const StringView& text);
+
+		/// Adds the data in a buffer to the checksum.
+		void Update(const Buffer& buffer);
+
+		/// Gets the checksum of all data added so far.
+		UInt Digest() const;
+
+		/// Restarts the checksum.
+		void Reset();
+
+	private:
+		UInt crc = 0;
+	};
+
+	///[Title] XXH32Hasher
+	/// Calculates a 32-bit xxHash incrementally.
+	///[Block] XXH32Hasher
+	class XXH32Hasher final {
+	public:
+		///[Heading] Constructors
+
+		/// Creates a hasher for a new hash.
+		///[Arg] seed: The seed of the hash.
+		explicit XXH32Hasher(const UInt seed = 0);
+
+		///[Heading] Methods
+
+		/// Adds data to the hash.
+		void Update(const void* const data, const UInt size);
+
+		/// Adds the characters of a string to the hash.
+		void Update(const StringView& text);
+
+		/// Adds the data in a buffer to the hash.
+		void Update(const Buffer& buffer);
+
+		/// Gets the hash of all data added so far.
+		UInt Digest() const;
+
+		/// Restarts the hash with a new seed.
+		void Reset(const UInt seed = 0);
+
+	private:
+		UInt seed;
+		UInt v[4];
+		UByte memory[16];
+		UInt memorySize;
+		ULong length;
+
+		static const UInt prime1 = 2654435761U;
+		static const UInt prime2 = 2246822519U;
+		static const UInt prime3 = 3266489917U;
+		static const UInt prime4 = 668265263U;
+		static const UInt prime5 = 374761393U;
+
+		static UInt Round(const UInt acc, const UInt input) {
+			return Hash::Rotate(acc + input * prime2, 13) * prime1;
+		}
+	};
+
+	///[Title] XXH64Hasher
+	/// Calculates a 64-bit xxHash incrementally.
+	///[Block] XXH64Hasher
+	class XXH64Hasher final {
+	public:
+		///[Heading] Constructors
+
+		/// Creates a hasher for a new hash.
+		///[Arg] seed: The seed of the hash.
+		explicit XXH64Hasher(const ULong seed = 0);
+
+		///[Heading] Methods
+
+		/// Adds data to the hash.
+		void Update(const void* const data, const UInt size);
+
+		/// Adds the characters of a string to the hash.
+		void Update(const StringView& text);
+
+		/// Adds the data in a buffer to the hash.
+		void Update(const Buffer& buffer);
+
+		/// Gets the hash of all data added so far.
+		ULong Digest() const;
+
+		/// Restarts the hash with a new seed.
+		void Reset(const ULong seed = 0);
+
+	private:
+		ULong seed;
+		ULong v[4];
+		UByte memory[32];
+		UInt memorySize;
+		ULong length;
+
+		static const ULong prime1 = 0x9E3779B185EBCA87ULL;
+		static const ULong prime2 = 0xC2B2AE3D27D4EB4FULL;
+		static const ULong prime3 = 0x165667B19E3779F9ULL;
+		static const ULong prime4 = 0x85EBCA77C2B2AE63ULL;
+		static const ULong prime5 = 0x27D4EB2F165667C5ULL;
+
+		static ULong Round(const ULong acc, const ULong input) {
+			return Hash::Rotate(acc + input * prime2, 31) * prime1;
+		}
+
+		static ULong Merge(const ULong acc, const ULong value) {
+			return (acc ^ Round(0, value)) * prime1 + prime4;
+		}
+	};
+
+	inline UInt Hash::CRC32C(const void* const data, const UInt size, const UInt crc) {
+		const UByte* const bytes = (const UByte*)data;
+
+#ifdef _BOXX_HASH_X64
+		if (HasHardware()) {
+			return ~CRCHardware(~crc, bytes, size);
+		}
+#elif defined(_BOXX_HASH_ARM)
+		return ~CRCHardware(~crc, bytes, size);
+#endif
+
+		return ~CRCSoftware(~crc, bytes, size);
+	}
+
+	inline UInt Hash::CRC32C(const StringView& text, const UInt crc) {
+		return CRC32C(text.Data(), text.Length(), crc);
+	}
+
+	inline UInt Hash::XXH32(const void* const data, const UInt size, const UInt seed) {
+		XXH32Hasher hasher = XXH32Hasher(seed);
+		hasher.Update(data, size);
+		return hasher.Digest();
+	}
+
+	inline UInt Hash::XXH32(const StringView& text, const UInt seed) {
+		return XXH32(text.Data(), text.Length(), seed);
+	}
+
+	inline ULong Hash::XXH64(const void* const data, const UInt size, const ULong seed) {
+		XXH64Hasher hasher = XXH64Hasher(seed);
+		hasher.Update(data, size);
+		return hasher.Digest();
+	}
+
+	inline ULong Hash::XXH64(const StringView& text, const ULong seed) {
+		return XXH64(text.Data(), text.Length(), seed);
+	}
+
+	inline Hash::CRCTables::CRCTables() {
+		for (UInt i = 0; i < 256; i++) {
+			UInt crc = i;
+
+			for (UInt j = 0; j < 8; j++) {
+				crc = (crc >> 1) ^ ((crc & 1) ? crcPolynomial : 0);
+			}
+
+			table[0][i] = crc;
+		}
+
+		for (UInt i = 0; i < 256; i++) {
+			for (UInt k = 1; k < 8; k++) {
+				table[k][i] = (table[k - 1][i] >> 8) ^ table[0][table[k - 1][i] & 0xFF];
+			}
+		}
+
+		shortShift[0] = ShiftConstant(shortBlock);
+		shortShift[1] = ShiftConstant(shortBlock * 2);
+		longShift[0] = ShiftConstant(longBlock);
+		longShift[1] = ShiftConstant(longBlock * 2);
+
+#ifdef _BOXX_HASH_X64
+#ifdef _MSC_VER
+		int info[4];
+		__cpuid(info, 1);
+		hardware = (info[2] & (1 << 20)) != 0 && (info[2] & (1 << 1)) != 0;
+#else
+		__builtin_cpu_init();
+		hardware = __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("pclmul");
+#endif
+#endif
+	}
+
+	inline const Hash::CRCTables& Hash::Tables() {
+		static const CRCTables tables;
+		return tables;
+	}
+
+	inline UInt Hash::CRCSoftware(UInt crc, const UByte* data, UInt size) {
+		const CRCTables& tables = Tables();
+		const UInt (&t)[8][256] = tables.table;
+
+		while (size >= 8) {
+			const UInt low = Read32(data) ^ crc;
+			const UInt high = Read32(data + 4);
+
+			crc =
+				t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+				t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+
+			data += 8;
+			size -= 8;
+		}
+
+		while (size > 0) {
+			crc = (crc >> 8) ^ t[0][(crc ^ *data) & 0xFF];
+			data++;
+			size--;
+		}
+
+		return crc;
+	}
+
+	inline UInt Hash::ShiftConstant(const UInt bytes) {
+		// Calculates x^(8 * bytes - 33) mod P in reflected bit order
+		UInt value = 0x80000000;
+
+		for (UInt i = 0; i < bytes * 8 - 33; i++) {
+			value = (value >> 1) ^ ((value & 1) ? crcPolynomial : 0);
+		}
+
+		return value;
+	}
+
+#ifdef _BOXX_HASH_X64
+	inline bool Hash::HasHardware() {
+		return Tables().hardware;
+	}
+
+	_BOXX_HASH_TARGET inline UInt Hash::CRCHardware(UInt crc, const UByte* data, UInt size) {
+		ULong value = crc;
+		const CRCTables& tables = Tables();
+
+		// Runs three independent checksums to hide the latency of the crc32 instruction
+		while (size >= longBlock * 3) {
+			value = CRCStreams(value, data, longBlock, tables.longShift);
+			data += longBlock * 3;
+			size -= longBlock * 3;
+		}
+
+		while (size >= shortBlock * 3) {
+			value = CRCStreams(value, data, shortBlock, tables.shortShift);
+			data += shortBlock * 3;
+			size -= shortBlock * 3;
+		}
+
+		while (size >= 8) {
+			ULong block;
+			std::memcpy(&block, data, sizeof(ULong));
+			value = _mm_crc32_u64(value, block);
+			data += 8;
+			size -= 8;
+		}
+
+		while (size > 0) {
+			value = _mm_crc32_u8((UInt)value, *data);
+			data++;
+			size--;
+		}
+
+		return (UInt)value;
+	}
+
+	_BOXX_HASH_TARGET inline ULong Hash::CRCStreams(ULong crc, const UByte* data, const UInt block, const UInt* const shift) {
+		ULong crc1 = 0;
+		ULong crc2 = 0;
+
+		for (const UByte* const end = data + block; data < end; data += 8) {
+			ULong a, b, c;
+			std::memcpy(&a, data, sizeof(ULong));
+			std::memcpy(&b, data + block, sizeof(ULong));
+			std::memcpy(&c, data + block * 2, sizeof(ULong));
+
+			crc = _mm_crc32_u64(crc, a);
+			crc1 = _mm_crc32_u64(crc1, b);
+			crc2 = _mm_crc32_u64(crc2, c);
+		}
+
+		// Shifts the first two checksums past the following blocks with carryless multiplication
+		const __m128i first = _mm_clmulepi64_si128(_mm_cvtsi32_si128((int)crc), _mm_cvtsi32_si128((int)shift[1]), 0);
+		const __m128i second = _mm_clmulepi64_si128(_mm_cvtsi32_si128((int)crc1), _mm_cvtsi32_si128((int)shift[0]), 0);
+		const ULong product = (ULong)_mm_cvtsi128_si64(_mm_xor_si128(first, second));
+
+		return _mm_crc32_u64(0, product) ^ crc2;
+	}
+#elif defined(_BOXX_HASH_ARM)
+	inline UInt Hash::CRCHardware(UInt crc, const UByte* data, UInt size) {
+		while (size >= 8) {
+			ULong block;
+			std::memcpy(&block, data, sizeof(ULong));
+			crc = __crc32cd(crc, block);
+			data += 8;
+			size -= 8;
+		}
+
+		while (size > 0) {
+			crc = __crc32cb(crc, *data);
+			data++;
+			size--;
+		}
+
+		return crc;
+	}
+#endif
+
+	inline CRC32CHasher::CRC32CHasher() {
+
+	}
+
+	inline void CRC32CHasher::Update(const void* const data, const UInt size) {
+		crc = Hash::CRC32C(data, size, crc);
+	}
+
+	inline void CRC32CHasher::Update(const StringView& text) {
+		Update(text.Data(), text.Length());
+	}
+
+	inline UInt CRC32CHasher::Digest() const {
+		return crc;
+	}
+
+	inline void CRC32CHasher::Reset() {
+		crc = 0;
+	}
+
+	inline XXH32Hasher::XXH32Hasher(const UInt seed) {
+		Reset(seed);
+	}
+
+	inline void XXH32Hasher::Update(const void* const data, const UInt size) {
+		const UByte* bytes = (const UByte*)data;
+		UInt remaining = size;
+
+		length += size;
+
+		if (memorySize + remaining < 16) {
+			if (remaining > 0) std::memcpy(memory + memorySize, bytes, remaining);
+			memorySize += remaining;
+			return;
+		}
+
+		if (memorySize > 0) {
+			const UInt fill = 16 - memorySize;
+			std::memcpy(memory + memorySize, bytes, fill);
+			bytes += fill;
+			remaining -= fill;
+
+			for (UInt i = 0; i < 4; i++) {
+				v[i] = Round(v[i], Hash::Read32(memory + i * 4));
+			}
+
+			memorySize = 0;
+		}
+
+		UInt v0 = v[0], v1 = v[1], v2 = v[2], v3 = v[3];
+
+		while (remaining >= 16) {
+			v0 = Round(v0, Hash::Read32(bytes));
+			v1 = Round(v1, Hash::Read32(bytes + 4));
+			v2 = Round(v2, Hash::Read32(bytes + 8));
+			v3 = Round(v3, Hash::Read32(bytes + 12));
+			bytes += 16;
+			remaining -= 16;
+		}
+
+		v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+
+		if (remaining > 0) {
+			std::memcpy(memory, bytes, remaining);
+			memorySize = remaining;
+		}
+	}
+
+	inline void XXH32Hasher::Update(const StringView& text) {
+		Update(text.Data(), text.Length());
+	}
+
+	inline UInt XXH32Hasher::Digest() const {
+		UInt hash;
+
+		if (length >= 16) {
+			hash = Hash::Rotate(v[0], 1) + Hash::Rotate(v[1], 7) + Hash::Rotate(v[2], 12) + Hash::Rotate(v[3], 18);
+		}
+		else {
+			hash = seed + prime5;
+		}
+
+		hash += (UInt)length;
+
+		const UByte* p = memory;
+		const UByte* const end = memory + memorySize;
+
+		for (; p + 4 <= end; p += 4) {
+			hash = Hash::Rotate(hash + Hash::Read32(p) * prime3, 17) * prime4;
+		}
+
+		for (; p < end; p++) {
+			hash = Hash::Rotate(hash + *p * prime5, 11) * prime1;
+		}
+
+		hash ^= hash >> 15;
+		hash *= prime2;
+		hash ^= hash >> 13;
+		hash *= prime3;
+		hash ^= hash >> 16;
+		return hash;
+	}
+
+	inline void XXH32Hasher::Reset(const UInt seed) {
+		this->seed = seed;
+		v[0] = seed + prime1 + prime2;
+		v[1] = seed + prime2;
+		v[2] = seed;
+		v[3] = seed - prime1;
+		memorySize = 0;
+		length = 0;
+	}
+
+	inline XXH64Hasher::XXH64Hasher(const ULong seed) {
+		Reset(seed);
+	}
+
+	inline void XXH64Hasher::Update(const void* const data, const UInt size) {
+		const UByte* bytes = (const UByte*)data;
+		UInt remaining = size;
+
+		length += size;
+
+		if (memorySize + remaining < 32) {
+			if (remaining > 0) std::memcpy(memory + memorySize, bytes, remaining);
+			memorySize += remaining;
+			return;
+		}
+
+		if (memorySize > 0) {
+			const UInt fill = 32 - memorySize;
+			std::memcpy(memory + memorySize, bytes, fill);
+			bytes += fill;
+			remaining -= fill;
+
+			for (UInt i = 0; i < 4; i++) {
+				v[i] = Round(v[i], Hash::Read64(memory + i * 8));
+			}
+
+			memorySize = 0;
+		}
+
+		ULong v0 = v[0], v1 = v[1], v2 = v[2], v3 = v[3];
+
+		while (remaining >= 32) {
+			v0 = Round(v0, Hash::Read64(bytes));
+			v1 = Round(v1, Hash::Read64(bytes + 8));
+			v2 = Round(v2, Hash::Read64(bytes + 16));
+			v3 = Round(v3, Hash::Read64(bytes + 24));
+			bytes += 32;
+			remaining -= 32;
+		}
+
+		v[0] = v0; v[1] = v1; v[2] = v2; v[3] = v3;
+
+		if (remaining > 0) {
+			std::memcpy(memory, bytes, remaining);
+			memorySize = remaining;
+		}
+	}
+
+	inline void XXH64Hasher::Update(const StringView& text) {
+		Update(text.Data(), text.Length());
+	}
+
+	inline ULong XXH64Hasher::Digest() const {
+		ULong hash;
+
+		if (length >= 32) {
+			hash = Hash::Rotate(v[0], 1) + Hash::Rotate(v[1], 7) + Hash::Rotate(v[2], 12) + Hash::Rotate(v[3], 18);
+
+			for (UInt i = 0; i < 4; i++) {
+				hash = Merge(hash, v[i]);
+			}
+		}
+		else {
+			hash = seed + prime5;
+		}
+
+		hash += length;
+
+		const UByte* p = memory;
+		const UByte* const end = memory + memorySize;
+
+		for (; p + 8 <= end; p += 8) {
+			hash ^= Round(0, Hash::Read64(p));
+			hash = Hash::Rotate(hash, 27) * prime1 + prime4;
+		}
+
+		if (p + 4 <= end) {
+			hash ^= (ULong)Hash::Read32(p) * prime1;
+			hash = Hash::Rotate(hash, 23) * prime2 + prime3;
+			p += 4;
+		}
+
+		for (; p < end; p++) {
+			hash ^= *p * prime5;
+			hash = Hash::Rotate(hash, 11) * prime1;
+		}
+
+		hash ^= hash >> 33;
+		hash *= prime2;
+		hash ^= hash >> 29;
+		hash *= prime3;
+		hash ^= hash >> 32;
+		return hash;
+	}
+
+	inline void XXH64Hasher::Reset(const ULong seed) {
+		this->seed = seed;
+		v[0] = seed + prime1 + prime2;
+		v[1] = seed + prime2;
+		v[2] = seed;
+		v[3] = seed - prime1;
+		memorySize = 0;
+		length = 0;
+	}
+}
+
+#endif
@@ -8,6 +8,13 @@
 #include "Array.h"
 #include "Error.h"
 #include "String.h"
+#include "StringView.h"
+#include "Math.h"
+#include "ThreadPool.h"
+
+#include <deque>
+#include <vector>
+#include <cstring>
 
 ///[Settings] block: indent
 
@@ -15,6 +22,64 @@
 namespace Boxx {
 	///[Heading] Lexing
 
+	///[Title] LexerGrammar
+	/// Token patterns that are compiled once and used by multiple calls to {Lexer::Lex}.
+	///[para] The grammar can not be changed after it is created and can be used by multiple threads at the same time.
+	///[Block] LexerGrammar
+	///M
+	template <class T>
+	class LexerGrammar final {
+	///M
+	public:
+		/// Creates an empty grammar.
+		LexerGrammar();
+
+		/// Creates a grammar from token patterns.
+		///[para] Patterns earlier in the list are used if multiple patterns match at the same position.
+		explicit LexerGrammar(const List<TokenPattern<T>>& patterns);
+
+		LexerGrammar(const LexerGrammar<T>& grammar);
+		LexerGrammar(LexerGrammar<T>&& grammar) noexcept;
+		~LexerGrammar();
+
+		///[Heading] Methods
+
+		/// Gets the number of token patterns in the grammar.
+		UInt Count() const;
+
+		/// Gets a token pattern of the grammar.
+		const TokenPattern<T>& operator[](const UInt index) const;
+
+		void operator=(const LexerGrammar<T>& grammar);
+		void operator=(LexerGrammar<T>&& grammar) noexcept;
+
+	private:
+		friend class Lexer;
+
+		List<TokenPattern<T>> patterns;
+		RegexSet set;
+	};
+
+	///[Title] TokenListEdit
+	/// The tokens of a string after an edit returned by {Lexer::Relex}.
+	///[Block] TokenListEdit
+	///M
+	template <class T>
+	struct TokenListEdit {
+	///M
+		/// The tokens of the edited string.
+		TokenList<T> tokens;
+
+		/// The index of the first changed token.
+		UInt start = 0;
+
+		/// The number of tokens in the previous list that were removed at {start}.
+		UInt removed = 0;
+
+		/// The number of tokens in the new list that were inserted at {start}.
+		UInt inserted = 0;
+	};
+
 	///[Title] Lexer
 	/// Static class for finding tokens in a string.
 	///[Block] Lexer
@@ -30,19 +95,203 @@ namespace Boxx {
 		template <class T>
 		static TokenList<T> Lex(const List<TokenPattern<T>>& patterns, const String& str);
 		///M
+
+		/// Get all tokens from a string with a compiled grammar.
+		///[Arg] grammar: The grammar to get tokens with.
+		///[Arg] str: The string to search.
+		///[Error] LexerError: Thrown if the string contains an undefined token.
+		///M
+		template <class T>
+		static TokenList<T> Lex(const LexerGrammar<T>& grammar, const String& str);
+		///M
+
+		/// Get all tokens from a string by lexing parts of the string on multiple threads.
+		///[para] The string is split after line feeds and each part is lexed from its start.
+		/// The tokens of a part are used from the first token the lexer reaches when the parts before it are joined.
+		/// A part that starts inside a token, such as a string or a comment with line feeds, is lexed again from the end of the previous part until it reaches one of its tokens.
+		///[para] Short strings are lexed on the calling thread.
+		///[Arg] grammar: The grammar to get tokens with.
+		///[Arg] str: The string to search.
+		///[Arg] pool: The thread pool to lex the parts with.
+		///[Error] LexerError: Thrown if the string contains an undefined token.
+		///M
+		template <class T>
+		static TokenList<T> Lex(const LexerGrammar<T>& grammar, const String& str, ThreadPool& pool);
+		///M
+
+		/// Updates the tokens of a string after a part of the string is replaced.
+		/// Only the tokens from the edit until the lexer reaches the start of an unchanged token are lexed again.
+		///[para] Lexing restarts at the first token on the line of the last token before the edit.
+		/// Tokens before that are kept and are assumed to not depend on the edited text.
+		/// Use {Lex} for grammars where a token depends on text after the line it ends on.
+		///[Arg] grammar: The grammar the tokens were lexed with.
+		///[Arg] tokens: The tokens of the string before the edit. The tokens have to be created by the lexer.
+		///[Arg] index: The index in the string where the edit starts.
+		///[Arg] length: The number of replaced characters.
+		///[Arg] text: The text that replaces the characters.
+		///[Returns] TokenListEdit<T>: The tokens of the edited string and the range of tokens that changed.
+		///[Error] LexerError: Thrown if the edit is outside the string or if the edited string contains an undefined token.
+		///M
+		template <class T>
+		static TokenListEdit<T> Relex(const LexerGrammar<T>& grammar, const TokenList<T>& tokens, const UInt index, const UInt length, const String& text);
+		///M
 		
 	private:
-		static UInt Lines(const String& str) {
-			UInt lines = 0;
+		template <class T>
+		friend class TokenStream;
+
+		// A position in the lexed string with its line and the position where the line starts
+		struct Cursor {
+			UInt pos = 0;
+			UInt line = 1;
+			UInt lineStart = 0;
+		};
+
+		// The minimum size of a part of a string that is lexed by a thread
+		static const UInt minChunkSize = 1 << 16;
+
+		// Lexes the next token that is not ignored and skips the white space after it
+		template <class T>
+		static bool NextToken(const LexerGrammar<T>& grammar, const StringView& str, Cursor& cursor, MatchContext& context, Token<T>& token);
+
+		// Lexes the token at the cursor and skips the white space after it
+		// The token is only set if the pattern is not ignored
+		template <class T>
+		static const TokenPattern<T>& MatchToken(const LexerGrammar<T>& grammar, const StringView& str, Cursor& cursor, MatchContext& context, Token<T>& token, RegexSet::Scanner* const scanner = nullptr);
+
+		// Gets the position of a token in the string it was lexed from
+		template <class T>
+		static UInt Offset(const Token<T>& token, const char* const data) {
+			return (UInt)(token.rawValue.Data() - data);
+		}
+
+		// Finds the first token that starts or ends at or after a position
+		template <class T>
+		static UInt FindToken(const List<Token<T>>& list, const char* const data, const UInt pos, const bool end);
+
+		// Moves a token to another string with its position shifted
+		template <class T>
+		static Token<T> Rebase(const Token<T>& token, const char* const from, const char* const to, const Long shift);
+
+		static bool IsWhiteSpace(const char c) {
+			return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v';
+		}
+
+		// Moves the cursor forward to a position and counts the lines it passes
+		static void Move(const StringView& str, Cursor& cursor, const UInt pos) {
+			const char* const data = str.Data();
 
-			for (const char c : str) {
-				if (c == '\n') lines++;
+			for (; cursor.pos < pos; cursor.pos++) {
+				if (data[cursor.pos] == '\n') {
+					cursor.line++;
+					cursor.lineStart = cursor.pos + 1;
+				}
 			}
+		}
+
+		// Skips white space and counts the skipped lines
+		static void Skip(const StringView& str, Cursor& cursor) {
+			const char* const data = str.Data();
 
-			return lines;
+			while (cursor.pos < str.Length() && IsWhiteSpace(data[cursor.pos])) {
+				if (data[cursor.pos] == '\n') {
+					cursor.line++;
+					cursor.lineStart = cursor.pos + 1;
+				}
+
+				cursor.pos++;
+			}
 		}
 	};
 
+	///[Title] TokenStream
+	/// A stream of tokens that are lexed from a string when they are requested.
+	///[para] Only the tokens between the oldest kept position and the furthest requested token are stored.
+	/// Parsing can start before the whole string is lexed.
+	///[para] The returned tokens are valid until they are removed from the window.
+	///[Block] TokenStream
+	///M
+	template <class T>
+	class TokenStream final {
+	///M
+	public:
+		/// Creates a stream that lexes a string with a grammar.
+		///[para] The grammar and the string are not copied and have to exist as long as the stream is used.
+		///[Arg] grammar: The grammar to get tokens with.
+		///[Arg] str: The string to lex.
+		///[Arg] window: The number of tokens before the current position that are kept for {PeekPrevious} and {SetPos}.
+		TokenStream(const LexerGrammar<T>& grammar, const StringView& str, const UInt window = 16);
+
+		///[Heading] Methods
+
+		/// Gets the current token.
+		///[Error] TokenListError: Thrown if the current position is after the last token.
+		///[Error] LexerError: Thrown if the string contains an undefined token.
+		const Token<T>& Current();
+
+		/// Advances to the next token.
+		void Advance();
+
+		/// Advances {steps} steps.
+		void Advance(const UInt steps);
+
+		/// Advances to the next token and returns it.
+		///[Error] TokenListError: Thrown if the position is after the last token.
+		///[Error] LexerError: Thrown if the string contains an undefined token.
+		const Token<T>& Next();
+
+		/// Get the next token without advancing.
+		///[Error] TokenListError: Thrown if the position is after the last token.
+		///[Error] LexerError: Thrown if the string contains an undefined token.
+		const Token<T>& PeekNext();
+
+		/// Get the token {steps} steps ahead without advancing.
+		///[Error] TokenListError: Thrown if the position is after the last token.
+		///[Error] LexerError: Thrown if the string contains an undefined token.
+		const Token<T>& PeekNext(const UInt steps);
+
+		/// Gets the previous token.
+		///[Error] TokenListError: Thrown if the position is before the first kept token.
+		const Token<T>& PeekPrevious();
+
+		/// Gets the token {steps} steps back.
+		///[Error] TokenListError: Thrown if the position is before the first kept token.
+		const Token<T>& PeekPrevious(const UInt steps);
+
+		/// Gets the current position in the token stream.
+		UInt GetPos() const;
+
+		/// Sets the position in the token stream.
+		///[Error] TokenListError: Thrown if the position is before the first kept token.
+		void SetPos(const UInt pos);
+
+		/// Checks if the current position is after the last token.
+		///[Error] LexerError: Thrown if the string contains an undefined token.
+		bool AtEnd();
+
+		/// Checks if the current position + {steps} is after the last token.
+		///[Error] LexerError: Thrown if the string contains an undefined token.
+		bool AtEnd(const UInt steps);
+
+	private:
+		const LexerGrammar<T>* grammar;
+		StringView str;
+		MatchContext context;
+
+		// The position of the next token to lex
+		Lexer::Cursor cursor;
+
+		// The kept tokens and the position of the first kept token
+		std::deque<Token<T>> tokens;
+		UInt first = 0;
+
+		UInt pos = 0;
+		UInt window;
+
+		bool Fill(const UInt index);
+		void Trim();
+	};
+
 	///[Title] LexerError
 	/// Used if a lexer is unable to lex a string.
 	///[Block] LexerError: Error
@@ -57,55 +306,471 @@ namespace Boxx {
 	};
 
 	template <class T>
-	static TokenList<T> Lexer::Lex(const List<TokenPattern<T>>& patterns, const String& code) {
-		static Regex whiteSpace = Regex("^%n*");
-		static Regex undefinedToken = Regex("^~%n*");
+	inline LexerGrammar<T>::LexerGrammar() {
+
+	}
+
+	template <class T>
+	inline LexerGrammar<T>::LexerGrammar(const List<TokenPattern<T>>& patterns) {
+		this->patterns = patterns.Copy();
+
+		// Matches all patterns in one pass
+		List<Regex> regexes = List<Regex>(patterns.Count());
+
+		for (const TokenPattern<T>& pattern : patterns) {
+			regexes.Add(pattern.pattern);
+		}
+
+		set = RegexSet(regexes);
+	}
+
+	template <class T>
+	inline LexerGrammar<T>::LexerGrammar(const LexerGrammar<T>& grammar) {
+		patterns = grammar.patterns;
+		set = grammar.set;
+	}
+
+	template <class T>
+	inline LexerGrammar<T>::LexerGrammar(LexerGrammar<T>&& grammar) noexcept {
+		patterns = std::move(grammar.patterns);
+		set = std::move(grammar.set);
+	}
+
+	template <class T>
+	inline LexerGrammar<T>::~LexerGrammar() {
+
+	}
+
+	template <class T>
+	inline UInt LexerGrammar<T>::Count() const {
+		return patterns.Count();
+	}
+
+	template <class T>
+	inline const TokenPattern<T>& LexerGrammar<T>::operator[](const UInt index) const {
+		return patterns[index];
+	}
+
+	template <class T>
+	inline void LexerGrammar<T>::operator=(const LexerGrammar<T>& grammar) {
+		patterns = grammar.patterns;
+		set = grammar.set;
+	}
+
+	template <class T>
+	inline void LexerGrammar<T>::operator=(LexerGrammar<T>&& grammar) noexcept {
+		patterns = std::move(grammar.patterns);
+		set = std::move(grammar.set);
+	}
 
+	template <class T>
+	inline TokenList<T> Lexer::Lex(const List<TokenPattern<T>>& patterns, const String& code) {
 		if (code.Length() == 0) return TokenList<T>();
+		return Lex(LexerGrammar<T>(patterns), code);
+	}
 
-		String match = whiteSpace.Match(code)->match;
-		UInt line = 1 + Lines(match);
-		UInt i = match.Length();
-		List<Token<T>> tokens;
+	template <class T>
+	inline TokenList<T> Lexer::Lex(const LexerGrammar<T>& grammar, const String& code) {
+		if (code.Length() == 0) return TokenList<T>();
 
-		while (i < code.Length()) {
-			bool found = false;
+		// The tokens view a copy of the string that is kept by the list
+		TokenList<T> list;
+		list.source = new String(code);
 
-			for (const TokenPattern<T>& pattern : patterns) {
-				Optional<Match> match = pattern.pattern.Match(code, i);
+		const StringView view = *list.source;
+		MatchContext context;
+		Cursor cursor;
+		Token<T> token;
 
-				if (match) {
-					Match m = *match;
+		Skip(view, cursor);
 
-					i += m.length;
+		while (NextToken(grammar, view, cursor, context, token)) {
+			list.list.Add(token);
+		}
+
+		return list;
+	}
+
+	template <class T>
+	inline TokenList<T> Lexer::Lex(const LexerGrammar<T>& grammar, const String& code, ThreadPool& pool) {
+		const UInt length = code.Length();
+		UInt chunks = Math::Min(pool.ThreadCount() * 4, length / minChunkSize);
+
+		if (chunks < 2) {
+			return Lex(grammar, code);
+		}
+
+		TokenList<T> list;
+		list.source = new String(code);
+
+		const StringView view = *list.source;
+		const char* const data = view.Data();
+		const UInt chunkSize = length / chunks;
+
+		// The string is split after line feeds
+		List<UInt> starts = List<UInt>(chunks + 1);
+		starts.Add(0);
+
+		for (UInt i = 1; i < chunks; i++) {
+			const UInt end = chunkSize * i;
+			const void* const lineFeed = std::memchr(data + end, '\n', length - end);
+			const UInt start = lineFeed ? (UInt)((const char*)lineFeed - data) + 1 : length;
+
+			if (start <= starts.Last() || start >= length) break;
+			starts.Add(start);
+		}
 
-					if (!pattern.ignore) {
-						tokens.Add(Token<T>(pattern.type, m.groups.IsEmpty() ? m.match : m.groups[0], m.match, line));
+		chunks = starts.Count();
+		starts.Add(length);
+
+		// The tokens of a chunk with lines counted from the start of the chunk
+		struct Chunk {
+			List<Token<T>> tokens;
+			Cursor end;
+			bool failed = false;
+		};
+
+		std::vector<std::future<Chunk>> results;
+		results.reserve(chunks);
+
+		for (UInt i = 0; i < chunks; i++) {
+			results.push_back(pool.Run([&grammar, view, &starts, i]() {
+				Chunk chunk;
+				RegexSet::Scanner scanner = RegexSet::Scanner(*grammar.set.engine);
+				MatchContext context;
+				Token<T> token;
+
+				// Each chunk is lexed until the lexer passes the start of the next chunk
+				chunk.end.pos = chunk.end.lineStart = starts[i];
+
+				try {
+					Skip(view, chunk.end);
+
+					while (chunk.end.pos < starts[i + 1]) {
+						if (!MatchToken(grammar, view, chunk.end, context, token, &scanner).ignore) {
+							chunk.tokens.Add(token);
+						}
 					}
+				}
+				catch (LexerError&) {
+					chunk.failed = true;
+				}
+
+				return chunk;
+			}));
+		}
+
+		for (std::future<Chunk>& result : results) {
+			result.wait();
+		}
+
+		// The tokens of a chunk are used from the first token that the lexer reaches from the end of the previous chunk
+		MatchContext context;
+		Cursor cursor;
+		Token<T> token;
+
+		Skip(view, cursor);
+
+		for (UInt i = 0; i < chunks; i++) {
+			Chunk chunk = results[i].get();
+			UInt k = 0;
+
+			while (true) {
+				while (k < chunk.tokens.Count() && Offset(chunk.tokens[k], data) < cursor.pos) {
+					k++;
+				}
 
-					line += Lines(m.match);
+				if (!chunk.failed && (cursor.pos == starts[i] || (k < chunk.tokens.Count() && Offset(chunk.tokens[k], data) == cursor.pos))) {
+					const UInt line = cursor.pos == starts[i] ? 1 : chunk.tokens[k].line;
+					const UInt lines = cursor.line - line;
 
-					found = true;
+					for (; k < chunk.tokens.Count(); k++) {
+						Token<T>& t = chunk.tokens[k];
+						t.line += lines;
+						list.list.Add(t);
+					}
+
+					cursor = chunk.end;
+					cursor.line += lines;
 					break;
 				}
+
+				if (cursor.pos >= starts[i + 1]) break;
+
+				if (!MatchToken(grammar, view, cursor, context, token).ignore) {
+					list.list.Add(token);
+				}
+			}
+		}
+
+		return list;
+	}
+
+	template <class T>
+	inline TokenListEdit<T> Lexer::Relex(const LexerGrammar<T>& grammar, const TokenList<T>& tokens, const UInt index, const UInt length, const String& text) {
+		const List<Token<T>>& list = tokens.list;
+
+		if (!tokens.source && list.Count() > 0) throw LexerError("The tokens were not created by the lexer");
+
+		const char* const oldData = tokens.source ? (const char*)*tokens.source : "";
+		const UInt oldLength = tokens.source ? tokens.source->Length() : 0;
+
+		if (index > oldLength || length > oldLength - index) throw LexerError("The edit is outside the lexed string");
+
+		TokenListEdit<T> edit;
+		edit.tokens.source = new String(String(oldData, index) + text + String(oldData + index + length, oldLength - index - length));
+
+		const StringView str = *edit.tokens.source;
+		const char* const data = str.Data();
+		const UInt end = index + text.Length();
+		const Long shift = (Long)text.Length() - (Long)length;
+
+		const UInt before = FindToken(list, oldData, index, true);
+		UInt restart = 0;
+		Cursor cursor;
+
+		// Restarts at the first token on the line of the last token that ends before the edit
+		if (before > 0) {
+			restart = before - 1;
+
+			while (restart > 0 && list[restart - 1].line == list[before - 1].line) {
+				restart--;
 			}
 
-			if (!found) {
-				Optional<Match> match = undefinedToken.Match(code, i);
+			cursor.pos = Offset(list[restart], oldData);
+			cursor.line = list[restart].line;
+			cursor.lineStart = cursor.pos + 1 - list[restart].column;
+		}
+		else {
+			Skip(str, cursor);
+		}
 
-				if (match) {
-					throw LexerError("Undefined token '" + match->match + "'");
+		for (UInt i = 0; i < restart; i++) {
+			edit.tokens.list.Add(Rebase(list[i], oldData, data, 0));
+		}
+
+		MatchContext context;
+		Token<T> token;
+		UInt next = list.Count();
+
+		// The rest of the tokens are unchanged once the lexer reaches the start of a previous token after the edit
+		while (cursor.pos < str.Length()) {
+			if (cursor.pos > end) {
+				const UInt pos = (UInt)((Long)cursor.pos - shift);
+				const UInt i = FindToken(list, oldData, pos, false);
+
+				if (i < list.Count() && Offset(list[i], oldData) == pos) {
+					next = i;
+					break;
 				}
 			}
 
-			if (i < code.Length()) {
-				const String match = whiteSpace.Match(code, i)->match;
-				i += match.Length();
-				line += Lines(match);
+			if (!MatchToken(grammar, str, cursor, context, token).ignore) {
+				edit.tokens.list.Add(token);
+			}
+		}
+
+		// Lexed tokens before the edit that did not change are not part of the changed range
+		const UInt lexed = edit.tokens.list.Count() - restart;
+		UInt same = 0;
+
+		while (same < lexed && restart + same < next) {
+			const Token<T>& a = edit.tokens.list[restart + same];
+			const Token<T>& b = list[restart + same];
+
+			if (a.type != b.type || Offset(a, data) != Offset(b, oldData) || a.line != b.line || a.column != b.column) break;
+			if (a.rawValue != b.rawValue || a.value.Length() != b.value.Length()) break;
+
+			same++;
+		}
+
+		// Tokens after the edit are shifted and tokens on the same line as the first of them get new columns
+		if (next < list.Count()) {
+			const Token<T>& first = list[next];
+			const Long lines = (Long)cursor.line - (Long)first.line;
+			const Long columns = (Long)(cursor.pos - cursor.lineStart + 1) - (Long)first.column;
+
+			for (UInt i = next; i < list.Count(); i++) {
+				Token<T> shifted = Rebase(list[i], oldData, data, shift);
+
+				if (list[i].line == first.line) {
+					shifted.column = (UInt)((Long)shifted.column + columns);
+				}
+
+				shifted.line = (UInt)((Long)shifted.line + lines);
+				edit.tokens.list.Add(shifted);
 			}
 		}
 
-		return TokenList<T>(tokens);
+		edit.start = restart + same;
+		edit.removed = next - edit.start;
+		edit.inserted = lexed - same;
+		return edit;
+	}
+
+	template <class T>
+	inline TokenStream<T>::TokenStream(const LexerGrammar<T>& grammar, const StringView& str, const UInt window) {
+		this->grammar = &grammar;
+		this->str = str;
+		this->window = window;
+		Lexer::Skip(str, cursor);
+	}
+
+	template <class T>
+	inline const Token<T>& TokenStream<T>::Current() {
+		if (!Fill(pos)) throw TokenListError("Token position out of range");
+		return tokens[pos - first];
+	}
+
+	template <class T>
+	inline void TokenStream<T>::Advance() {
+		pos++;
+		Trim();
+	}
+
+	template <class T>
+	inline void TokenStream<T>::Advance(const UInt steps) {
+		pos += steps;
+		Trim();
+	}
+
+	template <class T>
+	inline const Token<T>& TokenStream<T>::Next() {
+		Advance();
+		return Current();
+	}
+
+	template <class T>
+	inline const Token<T>& TokenStream<T>::PeekNext() {
+		return PeekNext(1);
+	}
+
+	template <class T>
+	inline const Token<T>& TokenStream<T>::PeekNext(const UInt steps) {
+		if (!Fill(pos + steps)) throw TokenListError("Token position out of range");
+		return tokens[pos + steps - first];
+	}
+
+	template <class T>
+	inline const Token<T>& TokenStream<T>::PeekPrevious() {
+		return PeekPrevious(1);
+	}
+
+	template <class T>
+	inline const Token<T>& TokenStream<T>::PeekPrevious(const UInt steps) {
+		if (steps > pos || pos - steps < first || !Fill(pos - steps)) throw TokenListError("Token position out of range");
+		return tokens[pos - steps - first];
+	}
+
+	template <class T>
+	inline UInt TokenStream<T>::GetPos() const {
+		return pos;
+	}
+
+	template <class T>
+	inline void TokenStream<T>::SetPos(const UInt pos) {
+		if (pos < first) throw TokenListError("Token position out of range");
+		this->pos = pos;
+		Trim();
+	}
+
+	template <class T>
+	inline bool TokenStream<T>::AtEnd() {
+		return !Fill(pos);
+	}
+
+	template <class T>
+	inline bool TokenStream<T>::AtEnd(const UInt steps) {
+		return !Fill(pos + steps);
+	}
+
+	template <class T>
+	inline bool TokenStream<T>::Fill(const UInt index) {
+		Token<T> token;
+
+		while (index >= first + tokens.size()) {
+			if (!Lexer::NextToken(*grammar, str, cursor, context, token)) return false;
+			tokens.push_back(token);
+			Trim();
+		}
+
+		return true;
+	}
+
+	template <class T>
+	inline void TokenStream<T>::Trim() {
+		while (!tokens.empty() && first + window < pos) {
+			tokens.pop_front();
+			first++;
+		}
+	}
+
+	template <class T>
+	inline bool Lexer::NextToken(const LexerGrammar<T>& grammar, const StringView& str, Cursor& cursor, MatchContext& context, Token<T>& token) {
+		while (cursor.pos < str.Length()) {
+			if (!MatchToken(grammar, str, cursor, context, token).ignore) {
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	template <class T>
+	inline const TokenPattern<T>& Lexer::MatchToken(const LexerGrammar<T>& grammar, const StringView& str, Cursor& cursor, MatchContext& context, Token<T>& token, RegexSet::Scanner* const scanner) {
+		// Each token is matched by the combined patterns and the white space after it is skipped in the same pass
+		UInt index;
+
+		if (!grammar.set.MatchAt(str, context, index, cursor.pos, RegexSetPolicy::First, scanner)) {
+			UInt end = cursor.pos;
+
+			while (end < str.Length() && !IsWhiteSpace(str[end])) {
+				end++;
+			}
+
+			throw LexerError("Undefined token '" + String(str.Data() + cursor.pos, end - cursor.pos) + "'");
+		}
+
+		const TokenPattern<T>& pattern = grammar.patterns[index];
+		const Cursor start = cursor;
+		const UInt length = context.Length();
+
+		Move(str, cursor, start.pos + length);
+		Skip(str, cursor);
+
+		if (!pattern.ignore) {
+			const StringView match = StringView(str.Data() + start.pos, length);
+			token = Token<T>(pattern.type, context.GroupCount() == 0 ? match : context.GroupView(0), match, start.line, start.pos - start.lineStart + 1);
+		}
+
+		return pattern;
+	}
+
+	template <class T>
+	inline UInt Lexer::FindToken(const List<Token<T>>& list, const char* const data, const UInt pos, const bool end) {
+		UInt low = 0;
+		UInt high = list.Count();
+
+		while (low < high) {
+			const UInt mid = low + (high - low) / 2;
+			const UInt offset = Offset(list[mid], data) + (end ? list[mid].rawValue.Length() : 0);
+
+			if (offset < pos) {
+				low = mid + 1;
+			}
+			else {
+				high = mid;
+			}
+		}
+
+		return low;
+	}
+
+	template <class T>
+	inline Token<T> Lexer::Rebase(const Token<T>& token, const char* const from, const char* const to, const Long shift) {
+		const StringView value = StringView(to + ((Long)(token.value.Data() - from) + shift), token.value.Length());
+		const StringView rawValue = StringView(to + ((Long)(token.rawValue.Data() - from) + shift), token.rawValue.Length());
+		return Token<T>(token.type, value, rawValue, token.line, token.column);
 	}
 }
 
@@ -55,10 +55,12 @@ namespace Boxx {
 		void Warning(const String& str);
 
 		/// Writes an error to the log file and the console.
+		/// The log file is flushed after the error is written.
 		///[Error] LoggerFileError: Thrown if the logger has created a log file and the file is not open.
 		void Error(const String& str);
 
 		/// Writes a fatal error to the log file and the console.
+		/// The log file is flushed before the error is thrown.
 		///[Error] FatalLoggerError: Always thrown.
 		///[Error] LoggerFileError: Thrown if the logger has created a log file and the file is not open.
 		void Fatal(const String& str);
@@ -181,17 +183,19 @@ namespace Boxx {
 	}
 
 	inline void Logger::Write(const String& str) {
-		loggedMessages.Add(Tuple<LogLevel, String>(LogLevel::Write, str + "\n"));
+		const String s = str + "\n";
+		loggedMessages.Add(Tuple<LogLevel, String>(LogLevel::Write, s));
 		if (!file) return;
 		if (!file->IsOpen()) throw LoggerFileError("File is not open");
-		file->Write(str + "\n");
+		file->Write(s);
 	}
 
 	inline void Logger::Log(const String& str) {
-		loggedMessages.Add(Tuple<LogLevel, String>(LogLevel::Log, "log: " + str + "\n"));
+		const String s = "log: " + str + "\n";
+		loggedMessages.Add(Tuple<LogLevel, String>(LogLevel::Log, s));
 		if (!file) return;
 		if (!file->IsOpen()) throw LoggerFileError("File is not open");
-		file->Write("log: " + str + "\n");
+		file->Write(s);
 	}
 
 	inline void Logger::Info(const String& str) {
@@ -228,6 +232,9 @@ namespace Boxx {
 		if (!file) return;
 		if (!file->IsOpen()) throw LoggerFileError("File is not open");
 		file->Write(s);
+
+		// Errors are written to the file right away in case the program stops
+		file->Flush();
 	}
 
 	inline void Logger::Fatal(const String& str) {
@@ -237,6 +244,7 @@ namespace Boxx {
 		if (file) {
 			if (!file->IsOpen()) throw LoggerFileError("File is not open");
 			file->Write(s);
+			file->Flush();
 		}
 		throw FatalLoggerError(str);
 	}
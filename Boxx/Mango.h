@@ -343,6 +343,10 @@ namespace Boxx {
 			ParsingInfo Copy() const;
 		};
 
+		// The token patterns are compiled once and shared by all decode calls
+		static const LexerGrammar<TokenType>& Grammar();
+		static LexerGrammar<TokenType> CreateGrammar();
+
 		static Mango Parse(TokenList<TokenType>& tokens, const MangoMap& variables);
 
 		static Optional<Mango> ParseNone(TokenList<TokenType>& tokens, ParsingInfo& info);
@@ -1049,6 +1053,27 @@ namespace Boxx {
 	}
 
 	inline Mango Mango::Decode(const String& mango, const MangoMap& variables) {
+		try {
+			TokenList<TokenType> tokens = Lexer::Lex(Grammar(), mango);
+			return Parse(tokens, variables);
+		}
+		catch (MangoDecodeError& e) {
+			throw e;
+		}
+		catch (TokenListError&) {
+			throw MangoDecodeError("Unexpected end of string");
+		}
+		catch (LexerError& e) {
+			throw MangoDecodeError(e.Message());
+		}
+	}
+
+	inline const LexerGrammar<Mango::TokenType>& Mango::Grammar() {
+		static const LexerGrammar<TokenType> grammar = CreateGrammar();
+		return grammar;
+	}
+
+	inline LexerGrammar<Mango::TokenType> Mango::CreateGrammar() {
 		List<TokenPattern<TokenType>> patterns;
 		patterns.Add(TokenPattern<TokenType>(TokenType::Comment, "%-%-#{%/+}~{%0%-}*%0%-%-", true, true));
 		patterns.Add(TokenPattern<TokenType>(TokenType::Comment, "%-%-~\n*", true, true));
@@ -1074,19 +1099,7 @@ namespace Boxx {
 		patterns.Add(TokenPattern<TokenType>(TokenType::OpenSq, "%[", true));
 		patterns.Add(TokenPattern<TokenType>(TokenType::CloseSq, "%]", true));
 
-		try {
-			TokenList<TokenType> tokens = Lexer::Lex(patterns, mango);
-			return Parse(tokens, variables);
-		}
-		catch (MangoDecodeError& e) {
-			throw e;
-		}
-		catch (TokenListError&) {
-			throw MangoDecodeError("Unexpected end of string");
-		}
-		catch (LexerError& e) {
-			throw MangoDecodeError(e.Message());
-		}
+		return LexerGrammar<TokenType>(patterns);
 	}
 
 	inline Mango Mango::Parse(TokenList<TokenType>& tokens, const MangoMap& variables) {
@@ -1097,7 +1110,7 @@ namespace Boxx {
 
 		Optional<Mango> mango = ParseLabeledValue(tokens, info);
 
-		if (!tokens.AtEnd()) throw MangoDecodeError("Unexpected token: '" + tokens.Current().rawValue + "'");
+		if (!tokens.AtEnd()) throw MangoDecodeError("Unexpected token: '" + tokens.Current().rawValue.ToString() + "'");
 
 		if (mango) {
 			return *mango;
@@ -1137,7 +1150,7 @@ namespace Boxx {
 	inline Optional<Mango> Mango::ParseNumber(TokenList<TokenType>& tokens, ParsingInfo& info) {
 		if (tokens.Current().type == TokenType::Number) {
 			tokens.Advance();
-			return Mango(tokens.PeekPrevious().value.ToDouble());
+			return Mango(tokens.PeekPrevious().value.ToString().ToDouble());
 		}
 
 		return nullptr;
@@ -1462,7 +1475,7 @@ namespace Boxx {
 	inline Optional<String> Mango::ParseRawString(TokenList<TokenType>& tokens, ParsingInfo& info) {
 		if (tokens.Current().type == TokenType::String) {
 			tokens.Advance();
-			return tokens.PeekPrevious().value.Replace("\\\\", "\\").Replace("\\\"", "\"");
+			return tokens.PeekPrevious().value.ToString().Replace("\\\\", "\\").Replace("\\\"", "\"");
 		}
 
 		return nullptr;
@@ -1471,7 +1484,7 @@ namespace Boxx {
 	inline Optional<String> Mango::ParseName(TokenList<TokenType>& tokens, ParsingInfo& info) {
 		if (tokens.Current().type == TokenType::Name) {
 			tokens.Advance();
-			return tokens.PeekPrevious().value;
+			return tokens.PeekPrevious().value.ToString();
 		}
 		else if (Optional<String> str = ParseRawString(tokens, info)) {
 			return *str;
@@ -1605,6 +1618,32 @@ namespace Boxx {
 			throw MangoDecodeError("Invalid template assignment");
 		}
 	}
+
+	inline Mango RegexProfile::ToMango() const {
+		Mango mango = Mango(MangoType::Map);
+		mango.Add("pattern", pattern);
+		mango.Add("matches", (Long)matches);
+		mango.Add("found", (Long)found);
+		mango.Add("backtracked", (Long)backtracked);
+		mango.Add("limited", (Long)limited);
+		mango.Add("steps", (Long)steps);
+		mango.Add("maxSteps", (Long)maxSteps);
+
+		Mango nodeList = Mango(MangoType::List);
+
+		for (const RegexNodeProfile& node : nodes) {
+			Mango nodeMango = Mango(MangoType::Map);
+			nodeMango.Add("pattern", node.pattern);
+			nodeMango.Add("position", (Long)node.position);
+			nodeMango.Add("entered", (Long)node.entered);
+			nodeMango.Add("backtracked", (Long)node.backtracked);
+			nodeMango.Add("consumed", (Long)node.consumed);
+			nodeList.Add(nodeMango);
+		}
+
+		mango.Add("nodes", nodeList);
+		return mango;
+	}
 }
 
 #endif
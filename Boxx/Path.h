@@ -4,6 +4,7 @@
 #include "Types.h"
 #include "String.h"
 #include "Set.h"
+#include "Glob.h"
 
 ///[Settings] block: indent
 
@@ -42,6 +43,11 @@ namespace Boxx {
 		/// Sets the file extension of the path.
 		static String SetExtension(const String& path, const String& extension);
 
+		/// Checks if a path matches a glob pattern.
+		///[para] The pattern is compiled on each call.
+		/// Use {GlobPattern} or {GlobSet} to match many paths against the same patterns.
+		static bool Glob(const String& pattern, const String& path);
+
 	private:
 		static char ExtSeparator() {
 			return '.';
@@ -172,6 +178,10 @@ namespace Boxx {
 
 		return Path::Combine(Path::GetDirectory(path), file);
 	}
+
+	inline bool Path::Glob(const String& pattern, const String& path) {
+		return GlobPattern(pattern).Match(path);
+	}
 }
 
 #endif
@@ -8,22 +8,73 @@
 #include "Set.h"
 #include "Math.h"
 #include "Pointer.h"
-#include "Stack.h"
 #include "Tuple.h"
 #include "StringBuilder.h"
+#include "StringView.h"
+#include "Buffer.h"
+#include "ThreadPool.h"
 
 #include <functional>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <list>
+#include <memory>
+#include <cstring>
+#include <algorithm>
+
+#if defined(__has_include)
+#if __has_include(<version>)
+#include <version>
+#endif
+#endif
+
+// Static regexes use class types as template arguments and vectors in constant expressions
+#if defined(__cpp_nontype_template_args) && __cpp_nontype_template_args >= 201911L && defined(__cpp_lib_constexpr_vector) && __cpp_lib_constexpr_vector >= 201907L
+#define _BOXX_REGEX_STATIC
+
+#include <array>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64)
+#define _BOXX_REGEX_SSE2
+
+#include <emmintrin.h>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#endif
 
 ///[Settings] block: indent
 
 ///[Namespace] Boxx
 namespace Boxx {
 	struct Match;
+	class MatchContext;
+	struct RegexProfile;
+	class Mango;
+	class RegexSet;
+	class RegexStream;
+
+	#ifdef _BOXX_REGEX_STATIC
+	template <UInt size>
+	struct RegexLiteral;
+
+	template <RegexLiteral pattern>
+	class StaticRegex;
+	#endif
 
 	///[Heading] Regex
 
 	///[Title] Regex
 	/// Class for parsing strings using a regular expression pattern.
+	///[para] Patterns without element matches are matched in linear time by a DFA that is built while matching.
+	/// Other patterns are matched by backtracking.
+	/// This includes repetitions with content that prefers to end empty after it has consumed characters, like a lazy quantifier inside a greedy one.
+	/// Literals and first characters of the pattern are used to skip to positions where a match can start.
 	///[Import] Regex
 	///[Block] Regex
 	class Regex {
@@ -43,20 +94,92 @@ namespace Boxx {
 		/// Find matches in a string.
 		///[Arg] str: The string to find matches in.
 		///[Arg] pos: The position in the string to start at.
+		///[Error] RegexStepError: Thrown if the step limit is reached.
 		///[Returns] Optional<Match>: Contains a value if a match was found.
 		Optional<Boxx::Match> Match(const String& str, const UInt pos = 0) const;
 
+		/// Find matches in a string and stores the match in a context.
+		///[para] Groups are stored as positions in the string and are only copied if requested from the context.
+		/// Matching again with a context that has been used with the same regex does not allocate memory.
+		///[Arg] str: The string to find matches in.
+		///[Arg] context: The context to store the match in.
+		///[Arg] pos: The position in the string to start at.
+		///[Error] RegexStepError: Thrown if the step limit is reached.
+		///[Returns] bool: {true} if a match was found.
+		bool Match(const StringView& str, MatchContext& context, const UInt pos = 0) const;
+
 		/// Find all matches in a string.
 		///[Arg] str: The string to find matches in.
 		///[Arg] pos: The position in the string to start at.
+		///[Error] RegexStepError: Thrown if the step limit is reached.
 		///[Returns] List<Match>: Contains all matches found in the string.
 		List<Boxx::Match> GlobalMatch(const String& str, UInt pos = 0) const;
 
+		/// Find all matches in a string with multiple threads.
+		///[para] The string is split into chunks that are matched by the threads of the pool.
+		/// The matches are the same as the matches found by {GlobalMatch} on a single thread.
+		///[para] Chunks are only matched in parallel if the length of all matches is bounded or if no match can contain a line feed.
+		/// Other patterns and small strings are matched on the calling thread.
+		///[Arg] str: The string to find matches in.
+		///[Arg] pool: The thread pool to match the chunks with.
+		///[Arg] pos: The position in the string to start at.
+		///[Error] RegexStepError: Thrown if the step limit is reached.
+		///[Returns] List<Match>: Contains all matches found in the string.
+		List<Boxx::Match> GlobalMatch(const String& str, ThreadPool& pool, UInt pos = 0) const;
+
 		/// Replaces all matches in a string.
 		///[Arg] str: The string to find matches in.
 		///[Arg] replaceFunc: The function to use for replacement.
+		///[Error] RegexStepError: Thrown if the step limit is reached.
 		String Replace(const String& str, std::function<String(Boxx::Match)> replaceFunc) const;
 
+		/// Replaces all matches in a string.
+		/// The matches are found with multiple threads in the same way as {GlobalMatch}.
+		///[para] The replacement function is only called by the calling thread.
+		///[Arg] str: The string to find matches in.
+		///[Arg] replaceFunc: The function to use for replacement.
+		///[Arg] pool: The thread pool to find the matches with.
+		///[Error] RegexStepError: Thrown if the step limit is reached.
+		String Replace(const String& str, std::function<String(Boxx::Match)> replaceFunc, ThreadPool& pool) const;
+
+		///[Heading] Backtracking
+
+		/// Sets if positions where the pattern failed to match are remembered while backtracking.
+		///[para] Each node of the pattern is only tried once at each position with the same quantifier counts and elements.
+		/// This bounds the time of a match with nested quantifiers at the cost of memory for each failed position.
+		///[para] Only patterns that are not matched by the DFA are matched by backtracking.
+		/// This is off by default.
+		void SetMemoization(const bool memoize);
+
+		/// Checks if positions where the pattern failed to match are remembered while backtracking.
+		bool HasMemoization() const;
+
+		/// Sets the max number of backtracking steps for one match.
+		///[para] A step is taken each time a quantifier or alternative is tried at a position.
+		/// There is no limit if the limit is {0}, which is the default.
+		void SetStepLimit(const ULong limit);
+
+		/// Gets the max number of backtracking steps for one match.
+		ULong StepLimit() const;
+
+		///[Heading] Profiling
+
+		/// Sets if the match calls of the regex are counted.
+		///[para] Each part of the pattern counts how many times it was tried, how many times it failed and how many characters it matched.
+		/// The parts are only counted by matches that backtrack.
+		/// Matches found by the DFA only count the match call.
+		///[para] Enabling profiling clears the previous counts.
+		/// Copies of the regex share the counts.
+		/// This is off by default.
+		void SetProfiling(const bool profile);
+
+		/// Checks if the match calls of the regex are counted.
+		bool HasProfiling() const;
+
+		/// Gets the counts of all match calls since profiling was enabled.
+		///[Returns] RegexProfile: Empty counts if profiling is disabled.
+		RegexProfile Profile() const;
+
 		///[Heading] Static functions
 
 		/// Find matches in a string.
@@ -84,10 +207,47 @@ namespace Boxx {
 		/// Escapes meta characters in a string to make the regex engine interpret the string literally.
 		static String Escape(const String& str);
 
+		///[Heading] Serialization
+
+		/// Writes the compiled pattern to a buffer.
+		///[para] The written pattern can be loaded with {Regex::Deserialize} without parsing the pattern again.
+		///[Arg] buffer: The buffer to write the compiled pattern to.
+		///[Error] RegexPatternError: Thrown if the regex is empty or if the pattern contains element matches.
+		void Serialize(Buffer& buffer) const;
+
+		/// Reads a compiled pattern that was written by {Regex::Serialize}.
+		///[Arg] buffer: The buffer to read the compiled pattern from.
+		///[Error] RegexPatternError: Thrown if the buffer does not contain a valid compiled pattern.
+		///[Error] BufferReadError: Thrown if the buffer does not contain enough bytes to read.
+		static Regex Deserialize(Buffer& buffer);
+
+		///[Heading] Pattern cache
+
+		/// Sets the max number of compiled patterns that are kept by the static functions.
+		///[para] The least recently used pattern is removed if the cache is full.
+		/// Patterns are not kept if the capacity is {0}.
+		///[para] The default capacity is {64}.
+		static void SetCacheCapacity(const UInt capacity);
+
+		/// Gets the max number of compiled patterns that are kept by the static functions.
+		static UInt CacheCapacity();
+
+		/// Gets the number of times a static function found its pattern in the cache.
+		static ULong CacheHits();
+
+		/// Gets the number of times a static function had to compile its pattern.
+		static ULong CacheMisses();
+
+		/// Removes all patterns from the cache and resets the hit and miss counts.
+		static void ClearCache();
+
 		void operator=(const Regex& regex); 
 		void operator=(Regex&& regex) noexcept;
 
 	private:
+		friend class MatchContext;
+		friend class RegexSet;
+		friend class RegexStream;
 
 		struct Pattern {
 			String pattern;
@@ -96,7 +256,9 @@ namespace Boxx {
 		};
 
 		struct RegexNode;
+		struct RootNode;
 		struct MatchInfo;
+		struct ByteSet;
 
 		typedef Pointer<RegexNode> Node;
 		typedef Tuple<Node, Node> NodeLeaf;
@@ -108,13 +270,17 @@ namespace Boxx {
 		static NodeLeaf ParseElementMatch(const Pattern& pattern, UInt& index);
 		static NodeLeaf ParseLiteralString(const Pattern& pattern, UInt& index);
 		static NodeLeaf ParseRawElement(const Pattern& pattern, UInt& index);
+
+		static void Locate(const Node& node, const UInt start, const UInt end);
+		static void ListNodes(RootNode& root);
 		static Optional<Tuple<UInt, UInt, bool>> ParseQuantifier(const Pattern& pattern, UInt& index);
 		static Node ParseString(const Pattern& pattern, UInt& index);
 		static Node ParseRange(const Pattern& pattern, UInt& index);
 		static Node ParseEscape(const Pattern& pattern, UInt& index);
 		static Node ParseSet(const Pattern& pattern, UInt& index);
-		static Node ParseSetRange(const Pattern& pattern, UInt& index);
-		static Node ParseSetEscape(const Pattern& pattern, UInt& index);
+		static bool ParseSetRange(const Pattern& pattern, UInt& index, ByteSet& set);
+		static bool ParseSetEscape(const Pattern& pattern, UInt& index, ByteSet& set);
+		static bool ParseClassEscape(const Pattern& pattern, UInt& index, ByteSet& set);
 		static NodeLeaf ParseGroup(const Pattern& pattern, UInt& index);
 
 		static Optional<char> ParseChar(const Pattern& pattern, UInt& index, const bool skipPost = true);
@@ -130,10 +296,80 @@ namespace Boxx {
 			bool backtrack = false;
 		};
 
+		struct ByteSet {
+			ULong bits[4] = {};
+
+			constexpr void Add(const UByte c) {
+				bits[c >> 6] |= 1ULL << (c & 63);
+			}
+
+			constexpr bool Contains(const UByte c) const {
+				return ((bits[c >> 6] >> (c & 63)) & 1) != 0;
+			}
+
+			constexpr void AddRange(const char start, const char end) {
+				for (UInt c = 0; c < 256; c++) {
+					if (start <= (char)c && (char)c <= end) Add((UByte)c);
+				}
+			}
+
+			constexpr void AddAll(bool (*test)(const char)) {
+				for (UInt c = 0; c < 256; c++) {
+					if (test((char)c)) Add((UByte)c);
+				}
+			}
+
+			constexpr bool IsEmpty() const {
+				return (bits[0] | bits[1] | bits[2] | bits[3]) == 0;
+			}
+		};
+
+		// The ranges of a set of bytes that are used to scan runs of the set 16 bytes at a time
+		struct ByteRanges {
+			UByte low[4] = {};
+			UByte size[4] = {};
+			UInt count = 0;
+
+			static ByteRanges Create(const ByteSet& set);
+			static const char* Skip(const char* begin, const char* const end, const ByteSet& set, const ByteRanges& ranges);
+		};
+
+		// Literals and bytes used to skip positions where no match can start
+		struct Prefilter {
+			String prefix;
+			String required;
+
+			ByteSet first;
+			UByte firstBytes[3] = {};
+			UInt firstCount = 0;
+
+			bool Skips() const;
+			bool Next(const char* const str, const UInt pos, const UInt end, UInt& found) const;
+			bool HasRequired(const char* const str, const UInt pos, const UInt end) const;
+
+			void Write(Buffer& buffer) const;
+			bool Read(Buffer& buffer);
+
+			static Prefilter Create(RegexNode* const node);
+			static bool First(RegexNode* node, RegexNode* const stop, ByteSet& set, bool& known);
+			static const char* FindLiteral(const char* begin, const char* const end, const String& literal);
+			static const char* FindFirst(const char* begin, const char* const end, const ByteSet& set, const UByte* const bytes, const UInt count);
+		};
+
 		struct RegexNode {
 			Node next;
 
-			virtual const char* Match(const char* str, MatchInfo& info) = 0;
+			// The index of the node in the profile and the part of the pattern it was parsed from
+			UInt id = Math::UIntMax();
+			UInt position = 0;
+			UInt length = 0;
+
+			virtual ~RegexNode() {}
+
+			// Matches the node and counts the match if the regex is profiled
+			const char* Match(const char* str, MatchInfo& info);
+
+			virtual const char* MatchNode(const char* str, MatchInfo& info) = 0;
 
 			virtual bool IsPlain() {
 				return next == nullptr || next->IsPlain();
@@ -141,11 +377,18 @@ namespace Boxx {
 		};
 
 		struct RootNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			Prefilter prefilter;
+			bool anchored = false;
+
+			// The pattern and the nodes that are counted by the profile in the order of the pattern
+			String pattern;
+			std::vector<RegexNode*> nodes;
+
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct LeafNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 
 			virtual bool IsPlain() override {
 				return true;
@@ -155,102 +398,69 @@ namespace Boxx {
 		struct StringNode : public RegexNode {
 			String string;
 
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct CharNode : public RegexNode {
 			char c{};
 
-			virtual const char* Match(const char* str, MatchInfo& info) override;
-		};
-
-		struct RangeNode : public RegexNode {
-			char start{}, end{};
-
-			virtual const char* Match(const char* str, MatchInfo& info) override;
-		};
-
-		struct HexNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
-		};
-
-		struct AlphaNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
-		};
-
-		struct AlphaNumNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
-		struct WordNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
-		};
-
-		struct PunctNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
-		};
-
-		struct SpaceNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
-		};
+		// A character in a set of bytes
+		struct ClassNode : public RegexNode {
+			ByteSet set;
 
-		struct WhiteSpaceNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct LineBreakNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct BoundaryNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct AnyNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct StartNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct EndNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct InverseNode : public RegexNode {
 			Node content;
 
-			virtual const char* Match(const char* str, MatchInfo& info) override;
-		};
-
-		struct SetNode : public RegexNode {
-			Set<char> chars;
-			List<Node> nodes;
-
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct EmptyNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct GroupNode : public RegexNode {
 			bool isHidden = true;
 
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct GroupEndNode : public RegexNode {
 			bool isHidden = true;
 
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct SelectNode : public RegexNode {
 			List<Node> nodes;
+			Node end;
 
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 
 			virtual bool IsPlain() override {
 				return false;
@@ -264,7 +474,7 @@ namespace Boxx {
 
 			Node content;
 
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 
 			virtual bool IsPlain() override {
 				return false;
@@ -278,7 +488,7 @@ namespace Boxx {
 
 			Node content;
 
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 
 			virtual bool IsPlain() override {
 				return false;
@@ -292,7 +502,7 @@ namespace Boxx {
 
 			Node content;
 
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 
 			virtual bool IsPlain() override {
 				return false;
@@ -304,7 +514,23 @@ namespace Boxx {
 			UInt max = 0;
 			bool many = true;
 
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
+
+			virtual bool IsPlain() override {
+				return false;
+			}
+		};
+
+		// A quantifier of a character in a set of bytes
+		struct ClassQuantifierNode : public RegexNode {
+			UInt min = 0;
+			UInt max = 0;
+			bool many = true;
+
+			ByteSet set;
+			ByteRanges ranges;
+
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 
 			virtual bool IsPlain() override {
 				return false;
@@ -312,17 +538,29 @@ namespace Boxx {
 		};
 
 		struct ElementNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct ElementEndNode : public RegexNode {
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
 		};
 
 		struct ElementMatchNode : public RegexNode {
 			UInt index = 0;
 
-			virtual const char* Match(const char* str, MatchInfo& info) override;
+			virtual const char* MatchNode(const char* str, MatchInfo& info) override;
+		};
+
+		struct NodeCounts {
+			ULong entered = 0;
+			ULong backtracked = 0;
+			ULong consumed = 0;
+		};
+
+		// A position to continue from if the current path through the instructions fails
+		struct Thread {
+			UInt pc, pos;
+			UInt groups, trail;
 		};
 
 		struct MatchInfo {
@@ -332,107 +570,507 @@ namespace Boxx {
 
 			UInt matchStart{}, matchEnd{};
 
-			List<String> groups;
-			Stack<const char*> groupStack;
+			// The start and end position of each group
+			std::vector<UInt> groups;
+			std::vector<const char*> groupStack;
+
+			std::vector<UInt> quantNums;
+			std::vector<const char*> quantStarts;
+
+			// The number of group positions at the end of each repetition in quantStarts
+			std::vector<UInt> quantGroups;
+
+			// The start of the current repetition of each quantifier
+			std::vector<const char*> quantPositions;
+
+			// The start and end position of each element
+			std::vector<UInt> elements;
+			std::vector<const char*> elementStack;
+
+			// Used to capture groups from the compiled instructions
+			std::vector<Thread> threads;
+			std::vector<UInt> open;
+			std::vector<UInt> trail;
+			std::vector<ULong> visited;
+
+			// Used to stop backtracking after a number of steps
+			ULong steps = 0;
+			ULong stepLimit = 0;
+
+			// The nodes that failed at a position with the same quantifier counts and elements
+			bool memoize = false;
+			std::unordered_set<std::string> failed;
+			std::string key;
+
+			// The counts of each node if the regex is profiled
+			bool profile = false;
+			bool backtracked = false;
+			std::vector<NodeCounts> counts;
+
+			void Clear();
+			void Step();
+			bool Visit(const RegexNode* const node, const char* const str);
+			void Fail(const RegexNode* const node, const char* const str);
+			void Key(const RegexNode* const node, const char* const str);
+			void Consume(const RegexNode* const node, const UInt count);
+		};
 
-			Stack<UInt> quantNums;
-			Stack<bool> quantBacktrack;
+		Node root;
 
-			List<String> elements;
-			Stack<const char*> elementStack;
+		// A pattern compiled to a list of NFA instructions
+		struct Program {
+			enum class Op : UByte {
+				Class,
+				Split,
+				Assert,
+				Match,
+				Save
+			};
+
+			enum class Assert : UByte {
+				Start,
+				End,
+				NotEnd,
+				Boundary,
+				NotLineFeed
+			};
+
+			// The kind of character on each side of a position
+			enum class Category : UByte {
+				None,
+				Word,
+				LineFeed,
+				Other
+			};
+
+			struct Inst {
+				Op op;
+				Assert assert;
+				UInt out;
+				UInt arg;
+			};
+
+			std::vector<Inst> insts;
+			std::vector<ByteSet> sets;
+			UInt start = 0;
+			UInt main = 0;
+			bool anchored = false;
+
+			UInt classCount = 0;
+			UByte byteClass[256] = {};
+			std::vector<UByte> classByte;
+
+			// The pattern of each instruction if the program contains multiple patterns
+			std::vector<UInt> owners;
+			UInt patterns = 0;
+
+			// The index of each split instruction among all split instructions
+			std::vector<UInt> splits;
+			UInt splitCount = 0;
+
+			UInt Emit(const Op op, const UInt out = 0, const UInt arg = 0, const Assert assert = Assert::Start);
+			UInt AddSet(const ByteSet& set);
+			void Finish();
+			void BuildClasses();
+			bool Capture(const char* const str, const UInt start, const UInt pos, const UInt end, const UInt limit, MatchInfo& info) const;
+
+			void Write(Buffer& buffer) const;
+			bool Read(Buffer& buffer);
+
+			static Category CategoryOf(const UByte c);
+			static bool Check(const Assert assert, const Category left, const Category right);
 		};
 
-		Node root;
+		struct Compiler {
+			Program& program;
+			bool reverse;
+			bool supported = true;
+			bool groups = false;
+
+			static const UInt maxInsts = 1 << 14;
+
+			Compiler(Program& program, const bool reverse) : program(program), reverse(reverse) {}
+
+			UInt Emit(const Program::Op op, const UInt out = 0, const UInt arg = 0, const Program::Assert assert = Program::Assert::Start);
+			UInt EmitSet(const ByteSet& set, const UInt out);
+			UInt Chain(RegexNode* node, RegexNode* const stop, UInt cont);
+			UInt Unit(RegexNode* const node, const UInt cont);
+			static bool SetOf(RegexNode* const node, ByteSet& set);
+			bool PrefersEmpty(const UInt loop, const UInt content) const;
+
+			template <class F>
+			UInt Repeat(const UInt min, const UInt max, const bool many, const F& body, const UInt cont);
+		};
+
+		#ifdef _BOXX_REGEX_STATIC
+		template <RegexLiteral pattern>
+		friend class StaticRegex;
+
+		// The number of instructions, sets and literal characters of a pattern that is compiled at compile time
+		struct StaticSizes {
+			UInt forwardInsts = 0;
+			UInt forwardSets = 0;
+			UInt reverseInsts = 0;
+			UInt reverseSets = 0;
+			UInt prefix = 0;
+			UInt required = 0;
+		};
+
+		// The programs and prefilter of a pattern that is compiled at compile time
+		template <StaticSizes sizes>
+		struct StaticEngine {
+			std::array<Program::Inst, sizes.forwardInsts> forwardInsts = {};
+			std::array<ByteSet, sizes.forwardSets> forwardSets = {};
+			std::array<Program::Inst, sizes.reverseInsts> reverseInsts = {};
+			std::array<ByteSet, sizes.reverseSets> reverseSets = {};
+			UInt forwardStart = 0;
+			UInt forwardMain = 0;
+			UInt reverseStart = 0;
+			bool anchored = false;
+			bool groups = false;
+
+			std::array<char, sizes.prefix> prefix = {};
+			std::array<char, sizes.required> required = {};
+			ByteSet first;
+			UByte firstBytes[3] = {};
+			UInt firstCount = 0;
+		};
+
+		// Parses and compiles a pattern in a constant expression to the same programs and prefilter as the parse functions and the compiler
+		// Invalid patterns throw errors which makes them compile errors
+		class StaticCompiler {
+		public:
+			constexpr StaticCompiler(const char* const pattern, const UInt length);
+
+			constexpr StaticSizes Sizes() const;
+
+			template <StaticSizes sizes>
+			constexpr StaticEngine<sizes> Table() const;
+
+		private:
+			enum class Kind : UByte {
+				Empty,
+				Set,
+				String,
+				LineBreak,
+				Start,
+				End,
+				Boundary,
+				Group,
+				Quantifier
+			};
+
+			struct Node {
+				Kind kind = Kind::Empty;
+				ByteSet set;
+
+				// The first character of a string, the expression of a group or the content of a quantifier
+				UInt index = 0;
+				UInt length = 0;
+
+				bool hidden = false;
+				UInt min = 0;
+				UInt max = 0;
+				bool many = true;
+			};
+
+			struct Code {
+				std::vector<Program::Inst> insts;
+				std::vector<ByteSet> sets;
+			};
+
+			static constexpr UInt none = Math::UIntMax();
+
+			const char* pattern;
+			UInt length;
+
+			std::vector<Node> nodes;
+			std::vector<char> chars;
+
+			// The nodes of each alternative of each expression
+			std::vector<std::vector<std::vector<UInt>>> exprs;
+
+			UInt root = 0;
+			bool anchored = false;
+			bool groups = false;
+
+			Code forwardCode;
+			Code reverseCode;
+			bool reverse = false;
+			UInt forwardStart = 0;
+			UInt forwardMain = 0;
+			UInt reverseStart = 0;
+
+			std::vector<char> prefix;
+			std::vector<char> required;
+			ByteSet first;
+			UByte firstBytes[3] = {};
+			UInt firstCount = 0;
+
+			constexpr char At(const UInt index) const;
+			constexpr UInt Add(const Node& node);
+
+			constexpr UInt ParseExpression(UInt& index);
+			constexpr std::vector<UInt> ParseRawExpression(UInt& index);
+			constexpr UInt ParseElement(UInt& index);
+			constexpr UInt ParseLiteralString(UInt& index);
+			constexpr UInt ParseRawElement(UInt& index);
+			constexpr bool ParseQuantifier(UInt& index, UInt& min, UInt& max, bool& many);
+			constexpr UInt ParseString(UInt& index);
+			constexpr UInt ParseRange(UInt& index);
+			constexpr UInt ParseEscape(UInt& index);
+			constexpr UInt ParseSet(UInt& index);
+			constexpr bool ParseSetRange(UInt& index, ByteSet& set);
+			constexpr bool ParseSetEscape(UInt& index, ByteSet& set);
+			constexpr UInt ParseGroup(UInt& index);
+
+			constexpr bool ParseChar(UInt& index, char& c, const bool skipPost = true);
+			constexpr bool ParseSetChar(UInt& index, char& c);
+			constexpr bool ParseInt(UInt& index, UInt& value);
+
+			constexpr void Compile();
+			constexpr Code& Current();
+			constexpr UInt Emit(const Program::Op op, const UInt out = 0, const UInt arg = 0, const Program::Assert assert = Program::Assert::Start);
+			constexpr UInt EmitSet(const ByteSet& set, const UInt out);
+			constexpr UInt Chain(const UInt expr, const UInt cont);
+			constexpr UInt Sequence(const std::vector<UInt>& elements, UInt cont);
+			constexpr UInt Unit(const UInt node, const UInt cont);
+			constexpr UInt Repeat(const UInt node, const UInt cont);
+			constexpr bool PrefersEmpty(const UInt loop, const UInt content);
+
+			constexpr void Literals(const UInt expr, std::vector<char>& run, bool& leading);
+			constexpr void EndLiteral(std::vector<char>& run, bool& leading);
+			constexpr bool First(const UInt expr, bool& known);
+			constexpr bool FirstOf(const UInt node, bool& known);
+		};
+
+		template <StaticSizes sizes>
+		static Regex Load(const StaticEngine<sizes>& engine);
+		#endif
+
+		// A DFA that is built from a program while it is searching
+		class DFA {
+		public:
+			DFA(const Program& program, const bool longest, const Prefilter* const prefilter = nullptr);
+
+			void Forward(const char* const str, const UInt pos, const UInt end, Int& matchEnd, const bool start = true);
+			void Reverse(const char* const str, const UInt pos, const UInt end, const UInt from, Int& matchStart, const bool start = true);
+			void Scan(const char* const str, const UInt pos, const UInt end, const bool first, std::vector<Int>& ends);
+
+			UInt Start(const Program::Category behind);
+
+			// Gets the transition of a state and advances the state
+			Int Next(UInt& state, const UInt input) {
+				const Int value = table[state * stride + input];
+				return value < 0 ? Transition(state, input) : value;
+			}
+
+		private:
+			struct State {
+				Program::Category behind;
+				std::vector<UInt> insts;
+				UInt lowest = 0;
+			};
+
+			const Program& program;
+			bool longest;
+			const Prefilter* prefilter;
+			UInt stride;
+
+			std::vector<State> states;
+			std::unordered_map<std::string, UInt> lookup;
+			// The next state of each transition shifted by 4 bits
+			// The flags are a match, no states left, a prefilter skip and no match in progress
+			std::vector<Int> table;
+			Int starts[4];
+
+			std::vector<UInt> idle;
+			std::vector<UInt> marks;
+			UInt mark = 0;
+			std::vector<UInt> stack;
+			std::vector<UInt> resolved;
+			std::vector<UInt> next;
+
+			// The patterns that match on each transition of a program with multiple patterns
+			std::unordered_map<UInt, std::vector<UInt>> found;
+			std::vector<UInt> cuts;
+
+			static const UInt maxStates = 4096;
+
+			void Clear();
+			UInt Add(const Program::Category behind, const std::vector<UInt>& insts);
+			Int Transition(UInt& state, const UInt input);
+			void Closure(const UInt pc, std::vector<UInt>& list, const bool resolve, const Program::Category left, const Program::Category right);
+			void NextMark();
+		};
+
+		struct Searcher;
+
+		struct Engine {
+			Program forward;
+			Program reverse;
+			Prefilter prefilter;
+			bool groups = false;
+			bool skips = false;
+
+			// The max length of a match or -1 if the length is not bounded
+			Int width = -1;
+
+			// If a match can contain a line feed
+			bool lineFeeds = true;
+
+			// If a match depends on the start position of the search
+			bool searchStart = true;
+
+			std::mutex mutex;
+			Pointer<DFA> forwardDFA;
+			Pointer<DFA> reverseDFA;
+
+			void Finish();
+			void Measure();
+			void Search(const char* const str, const UInt pos, const UInt end, Int& matchStart, Int& matchEnd);
+			void Search(Searcher& searcher, const char* const str, const UInt pos, const UInt end, const bool start, Int& matchStart, Int& matchEnd) const;
+		};
+
+		// The DFAs of one thread
+		struct Searcher {
+			DFA forward;
+			DFA reverse;
+
+			Searcher(const Engine& engine);
+		};
+
+		Pointer<Engine> engine;
+
+		bool memoize = false;
+		ULong stepLimit = 0;
+
+		// The counts of all match calls while the regex is profiled
+		struct Profiler;
+		Pointer<Profiler> profiler;
+
+		// The minimum size of a chunk that is matched by a thread
+		static const UInt minChunkSize = 1 << 16;
+
+		bool Find(const char* const str, const UInt length, const UInt pos, MatchInfo& info, Searcher* const searcher = nullptr, const bool start = true) const;
+		bool FindMatch(const char* const str, const UInt length, const UInt pos, MatchInfo& info, Searcher* const searcher, const bool start) const;
+
+		static UInt NextPos(const Boxx::Match& match);
+
+		// The compiled patterns used by the static functions with the most recently used first
+		struct Cache {
+			typedef std::list<std::pair<std::string, std::shared_ptr<const Regex>>> Entries;
+
+			std::mutex mutex;
+			Entries entries;
+			std::unordered_map<std::string, Entries::iterator> lookup;
+
+			UInt capacity = 64;
+			ULong hits = 0;
+			ULong misses = 0;
+
+			void Trim();
+		};
+
+		static Cache& GetCache();
+		static std::shared_ptr<const Regex> Cached(const String& pattern);
+
+		static Pointer<Engine> Compile(const Node& root);
+		static Boxx::Match CreateMatch(const MatchInfo& info);
 
 		// Meta Characters
 		struct MetaChar {
-			static const char range     = ':';
-			static const char escape    = '%';
-			static const char any       = '.';
-			static const char start     = '^';
-			static const char end       = '$';
-			static const char inverse   = '~';
-			static const char select    = '|';
-			static const char element   = '#';
-			static const char expr      = '!';
-			static const char separator = ',';
-			static const char quote     = '\'';
-
-			static const char manyOpt    = '*';
-			static const char many       = '+';
-			static const char fewOpt     = '/';
-			static const char few        = '-';
-			static const char optional   = '?';
-			static const char quantOpen  = '<';
-			static const char quantClose = '>';
-			static const char quantRange = ':';
-
-			static const char setOpen     = '[';
-			static const char setClose    = ']';
-			static const char groupOpen   = '(';
-			static const char groupClose  = ')';
-			static const char hiddenOpen  = '{';
-			static const char hiddenClose = '}';
-
-			static const char lower     = 'l';
-			static const char upper     = 'u';
-			static const char digit     = 'd';
-			static const char hex       = 'x';
-			static const char alpha     = 'a';
-			static const char alphanum  = 'v';
-			static const char word      = 'w';
-			static const char punct     = 'p';
-			static const char space     = 's';
-			static const char white     = 'n';
-			static const char lineBreak = 'r';
-			static const char bound     = 'b';
-
-			static bool IsMetaChar(const char c) {
-				static const Set<char> metaChars = GetMetaChars();
-				return metaChars.Contains(c);
-			}
-
-			static bool IsSetMetaChar(const char c) {
-				static const Set<char> metaChars = GetSetMetaChars();
-				return metaChars.Contains(c);
-			}
-
-			static bool IsPostChar(const char c) {
-				static const Set<char> chars = GetPostChars();
-				return chars.Contains(c);
-			}
-
-			static bool IsReservedEscape(const char c) {
-				static const Set<char> reservedChars = GetReservedEscapeChars();
-				return reservedChars.Contains(c);
-			}
-
-			static bool IsReservedSetEscape(const char c) {
-				static const Set<char> reservedChars = GetReservedSetEscapeChars();
-				return reservedChars.Contains(c);
-			}
-
-			static bool IsHex(const char c) {
+			static constexpr char range     = ':';
+			static constexpr char escape    = '%';
+			static constexpr char any       = '.';
+			static constexpr char start     = '^';
+			static constexpr char end       = '$';
+			static constexpr char inverse   = '~';
+			static constexpr char select    = '|';
+			static constexpr char element   = '#';
+			static constexpr char expr      = '!';
+			static constexpr char separator = ',';
+			static constexpr char quote     = '\'';
+
+			static constexpr char manyOpt    = '*';
+			static constexpr char many       = '+';
+			static constexpr char fewOpt     = '/';
+			static constexpr char few        = '-';
+			static constexpr char optional   = '?';
+			static constexpr char quantOpen  = '<';
+			static constexpr char quantClose = '>';
+			static constexpr char quantRange = ':';
+
+			static constexpr char setOpen     = '[';
+			static constexpr char setClose    = ']';
+			static constexpr char groupOpen   = '(';
+			static constexpr char groupClose  = ')';
+			static constexpr char hiddenOpen  = '{';
+			static constexpr char hiddenClose = '}';
+
+			static constexpr char lower     = 'l';
+			static constexpr char upper     = 'u';
+			static constexpr char digit     = 'd';
+			static constexpr char hex       = 'x';
+			static constexpr char alpha     = 'a';
+			static constexpr char alphanum  = 'v';
+			static constexpr char word      = 'w';
+			static constexpr char punct     = 'p';
+			static constexpr char space     = 's';
+			static constexpr char white     = 'n';
+			static constexpr char lineBreak = 'r';
+			static constexpr char bound     = 'b';
+
+			static constexpr bool IsMetaChar(const char c) {
+				return
+					c == range || c == escape || c == any || c == start || c == end || c == inverse ||
+					c == select || c == element || c == expr || c == separator || c == quote ||
+					c == manyOpt || c == many || c == fewOpt || c == few || c == optional ||
+					c == quantOpen || c == quantClose || c == quantRange ||
+					c == setOpen || c == setClose || c == groupOpen || c == groupClose || c == hiddenOpen || c == hiddenClose;
+			}
+
+			static constexpr bool IsSetMetaChar(const char c) {
+				return c == range || c == escape || c == setClose;
+			}
+
+			static constexpr bool IsPostChar(const char c) {
+				return
+					c == range || c == quantOpen ||
+					c == many || c == manyOpt || c == few || c == fewOpt || c == optional;
+			}
+
+			static constexpr bool IsReservedEscape(const char c) {
+				return IsReservedSetEscape(c) || c == lineBreak || c == bound || ('0' <= c && c <= '9');
+			}
+
+			static constexpr bool IsReservedSetEscape(const char c) {
+				return
+					c == lower || c == upper || c == digit || c == hex || c == alpha ||
+					c == alphanum || c == word || c == punct || c == space || c == white;
+			}
+
+			static constexpr bool IsHex(const char c) {
 				return 
 					'0' <= c && c <= '9' ||
 					'a' <= c && c <= 'f' ||
 					'A' <= c && c <= 'F';
 			}
 
-			static bool IsAlpha(const char c) {
+			static constexpr bool IsAlpha(const char c) {
 				return 
 					'a' <= c && c <= 'z' ||
 					'A' <= c && c <= 'Z';
 			}
 
-			static bool IsAlphaNum(const char c) {
+			static constexpr bool IsAlphaNum(const char c) {
 				return 
 					'0' <= c && c <= '9' ||
 					'a' <= c && c <= 'z' ||
 					'A' <= c && c <= 'Z';
 			}
 
-			static bool IsWord(const char c) {
+			static constexpr bool IsWord(const char c) {
 				return 
 					'0' <= c && c <= '9' ||
 					'a' <= c && c <= 'z' ||
@@ -440,143 +1078,39 @@ namespace Boxx {
 					c == '_';
 			}
 
-			static bool IsSpace(const char c) {
-				static const Set<char> space = GetSpace();
-				return space.Contains(c);
+			static constexpr bool IsSpace(const char c) {
+				return c == ' ' || c == '\t';
 			}
 
-			static bool IsWhiteSpace(const char c) {
-				static const Set<char> whiteSpace = GetWhiteSpace();
-				return whiteSpace.Contains(c);
+			static constexpr bool IsWhiteSpace(const char c) {
+				return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v';
 			}
 
-			static bool IsPunct(const char c) {
-				static const Set<char> punct = GetPunct();
-				return punct.Contains(c);
+			static constexpr bool IsPunct(const char c) {
+				for (const char* p = "[!\"#$%&'()*+,./:;<=>?@\\^`{|}~-]"; *p; p++) {
+					if (*p == c) return true;
+				}
+
+				return false;
 			}
 
-		private:
-			static Set<char> GetMetaChars() {
-				Set<char> chars;
-				chars.Add(range);
-				chars.Add(escape);
-				chars.Add(any);
-				chars.Add(start);
-				chars.Add(end);
-				chars.Add(inverse);
-				chars.Add(select);
-				chars.Add(element);
-				chars.Add(expr);
-				chars.Add(separator);
-				chars.Add(quote);
-
-				chars.Add(manyOpt);
-				chars.Add(many);
-				chars.Add(fewOpt);
-				chars.Add(few);
-				chars.Add(optional);
-				chars.Add(quantOpen);
-				chars.Add(quantClose);
-				chars.Add(quantRange);
-
-				chars.Add(setOpen);
-				chars.Add(setClose);
-				chars.Add(groupOpen);
-				chars.Add(groupClose);
-				chars.Add(hiddenOpen);
-				chars.Add(hiddenClose);
-				return chars;
-			}
-
-			static Set<char> GetSetMetaChars() {
-				Set<char> chars;
-				chars.Add(range);
-				chars.Add(escape);
-
-				chars.Add(setClose);
-				return chars;
-			}
-
-			static Set<char> GetPostChars() {
-				Set<char> chars;
-				chars.Add(range);
-				chars.Add(quantOpen);
-				chars.Add(many);
-				chars.Add(manyOpt);
-				chars.Add(few);
-				chars.Add(fewOpt);
-				chars.Add(optional);
-				return chars;
-			}
-
-			static Set<char> GetReservedEscapeChars() {
-				Set<char> chars;
-				chars.Add(lower);
-				chars.Add(upper);
-				chars.Add(digit);
-				chars.Add(hex);
-				chars.Add(alpha);
-				chars.Add(alphanum);
-				chars.Add(word);
-				chars.Add(punct);
-				chars.Add(space);
-				chars.Add(white);
-				chars.Add(lineBreak);
-				chars.Add(bound);
-
-				chars.Add('0');
-				chars.Add('1');
-				chars.Add('2');
-				chars.Add('3');
-				chars.Add('4');
-				chars.Add('5');
-				chars.Add('6');
-				chars.Add('7');
-				chars.Add('8');
-				chars.Add('9');
-				return chars;
-			}
-
-			static Set<char> GetReservedSetEscapeChars() {
-				Set<char> chars;
-				chars.Add(lower);
-				chars.Add(upper);
-				chars.Add(digit);
-				chars.Add(hex);
-				chars.Add(alpha);
-				chars.Add(alphanum);
-				chars.Add(word);
-				chars.Add(punct);
-				chars.Add(space);
-				chars.Add(white);
-				return chars;
-			}
-
-			static Set<char> GetSpace() {
-				Set<char> chars;
-				chars.Add(' ');
-				chars.Add('\t');
-				return chars;
-			}
-
-			static Set<char> GetWhiteSpace() {
-				Set<char> chars;
-				chars.Add(' ');
-				chars.Add('\t');
-				chars.Add('\r');
-				chars.Add('\n');
-				chars.Add('\v');
-				return chars;
-			}
-
-			static Set<char> GetPunct() {
-				const String p = "[!\"#$%&'()*+,./:;<=>?@\\^`{|}~-]";
-				Set<char> set = Set<char>(p.Length());
-
-				for (const char c : p)
-					set.Add(c);
-
-				return set;
+			// Adds the characters of a class escape to a set
+			static constexpr bool AddClass(const char c, ByteSet& set) {
+				switch (c) {
+					case digit:    set.AddRange('0', '9'); break;
+					case lower:    set.AddRange('a', 'z'); break;
+					case upper:    set.AddRange('A', 'Z'); break;
+					case hex:      set.AddAll(IsHex); break;
+					case alpha:    set.AddAll(IsAlpha); break;
+					case alphanum: set.AddAll(IsAlphaNum); break;
+					case word:     set.AddAll(IsWord); break;
+					case punct:    set.AddAll(IsPunct); break;
+					case space:    set.AddAll(IsSpace); break;
+					case white:    set.AddAll(IsWhiteSpace); break;
+					default: return false;
+				}
+
+				return true;
 			}
 		};
 	};
@@ -598,428 +1132,4011 @@ namespace Boxx {
 		List<String> groups;
 	};
 
-	///[Title] RegexPatternError
-	/// Used if a regex pattern is invalid.
-	///[Block] RegexPatternError: Error
-	class RegexPatternError : public Error {
+	///[Title] MatchContext
+	/// Contains a regex match found by {Regex.Match}.
+	///[para] The context keeps its memory between matches so it can be reused without allocating memory.
+	///[Warning] The matched string must stay alive and unchanged for as long as the groups of the match are used.
+	///[Block] MatchContext
+	class MatchContext final {
 	public:
-		RegexPatternError() : Error() {}
-		RegexPatternError(const char* const msg) : Error(msg) {}
+		/// Creates an empty context.
+		MatchContext();
 
-		virtual String Name() const override {
-			return "RegexPatternError";
-		}
-	};
+		///[Heading] Methods
 
-	inline char Regex::Pattern::operator[](const UInt i) const {
-		if (i >= pattern.Length()) throw RegexPatternError("Unexpected end of pattern");
-		return pattern[i];
-	}
-	
-	inline Regex::Regex() {
-	
-	}
+		/// Checks if the last match was found.
+		bool IsMatch() const;
 
-	inline Regex::Regex(const String& pattern) {
-		try {
-			UInt i = 0;
-			Pattern p;
-			p.pattern = pattern;
-			root = ParsePattern(p, i);
-		}
-		catch (RegexPatternError e) {
-			throw e;
-		}
-	}
+		/// Gets the index of the string where the pattern was found.
+		UInt Index() const;
 
-	inline Regex::Regex(const Regex& regex) {
-		root = regex.root;
-	}
+		/// Gets the length of the matched substring.
+		UInt Length() const;
 
-	inline Regex::Regex(Regex&& regex) noexcept {
-		root = std::move(regex.root);
-	}
+		/// Gets the number of matched groups.
+		UInt GroupCount() const;
 
-	inline Regex::~Regex() {
+		/// Gets the index of the string where a group starts.
+		///[Arg] group: The index of the group.
+		UInt GroupIndex(const UInt group) const;
 
-	}
+		/// Gets the length of a group.
+		///[Arg] group: The index of the group.
+		UInt GroupLength(const UInt group) const;
 
-	inline Optional<Match> Regex::Match(const String& str, const UInt pos) const {
-		MatchInfo info;
-		info.str   = (const char*)str;
-		info.start = (const char*)str + pos;
-		info.end   = (const char*)str + str.Length();
-		info.matchStart = pos;
+		/// Gets a view of a matched group.
+		///[Arg] group: The index of the group.
+		StringView GroupView(const UInt group) const;
 
-		if (root->Match(info.start, info)) {
-			Boxx::Match match;
-			match.index   = info.matchStart;
-			match.length  = info.matchEnd - info.matchStart;
-			match.groups  = info.groups;
+		/// Copies a matched group to a new string.
+		///[Arg] group: The index of the group.
+		String Group(const UInt group) const;
 
-			if (match.length > 0) {
-				match.match = str.Sub(info.matchStart, info.matchEnd - 1);
-			}
-			else {
-				match.match = "";
-			}
+		/// Creates a match with copies of the matched substring and groups.
+		Boxx::Match ToMatch() const;
 
-			return match;
-		}
-		else {
-			return nullptr;
-		}
-	}
+	private:
+		friend class Regex;
+		friend class RegexSet;
 
-	inline List<Match> Regex::GlobalMatch(const String& str, UInt pos) const {
-		List<Boxx::Match> matches;
+		Regex::MatchInfo info;
+		bool matched = false;
+	};
 
-		while (Optional<Boxx::Match> match = Match(str, pos)) {
-			matches.Add(*match);
-			pos = match->index + match->length;
-		}
+	///[Title] RegexNodeProfile
+	/// Contains the counts of one part of a profiled regex pattern.
+	///[Block] RegexNodeProfile
+	struct RegexNodeProfile {
+		/// The part of the pattern.
+		String pattern;
 
-		return matches;
-	}
+		/// The position of the part in the pattern.
+		UInt position = 0;
 
-	inline String Regex::Replace(const String& str, std::function<String(Boxx::Match)> replaceFunc) const {
-		StringBuilder output;
+		/// The number of times the part was tried.
+		ULong entered = 0;
 
-		UInt pos = 0;
+		/// The number of times the part failed to match.
+		ULong backtracked = 0;
 
-		while (Optional<Boxx::Match> match = Match(str, pos)) {
-			if (match->index > pos) {
-				output += str.Sub(pos, match->index - 1);
-			}
+		/// The number of characters matched by the part.
+		///[para] Groups, alternatives and quantifiers of other parts do not count characters.
+		/// The characters are counted by the parts inside them.
+		ULong consumed = 0;
+	};
 
-			output += replaceFunc(*match);
-			pos = match->index + match->length;
-		}
+	///[Title] RegexProfile
+	/// Contains the counts of the match calls of a profiled {Regex}.
+	///[Block] RegexProfile
+	struct RegexProfile {
+		/// The pattern of the regex.
+		///[para] Empty if the regex was not created from a pattern.
+		String pattern;
 
-		if (pos < str.Length()) {
-			output += str.Sub(pos);
-		}
+		/// The number of match calls.
+		ULong matches = 0;
 
-		return output.ToString();
-	}
+		/// The number of match calls that found a match.
+		ULong found = 0;
 
-	inline Optional<Match> Regex::Match(const String& pattern, const String& str, const UInt pos) {
-		try {
-			return Regex(pattern).Match(str, pos);
-		}
-		catch (RegexPatternError e) {
-			throw e;
-		}
-	}
+		/// The number of match calls that were matched by backtracking.
+		ULong backtracked = 0;
 
-	inline List<Match> Regex::GlobalMatch(const String& pattern, const String& str, const UInt pos) {
-		try {
-			return Regex(pattern).GlobalMatch(str, pos);
-		}
-		catch (RegexPatternError e) {
-			throw e;
-		}
-	}
+		/// The number of match calls that reached the step limit.
+		ULong limited = 0;
 
-	inline String Regex::Replace(const String& pattern, const String& str, std::function<String(Boxx::Match)> replaceFunc) {
-		try {
-			return Regex(pattern).Replace(str, replaceFunc);
-		}
-		catch (RegexPatternError e) {
+		/// The total number of backtracking steps of all match calls.
+		ULong steps = 0;
+
+		/// The max number of backtracking steps of one match call.
+		ULong maxSteps = 0;
+
+		/// The counts of each part of the pattern in the order of the pattern.
+		List<RegexNodeProfile> nodes;
+
+		/// Converts the profile to mango.
+		///[para] Use {MangoEncodeFlags::Json} to encode the profile as json.
+		/// This function is defined in {Mango.h}.
+		Mango ToMango() const;
+	};
+
+	///[Title] RegexSetPolicy
+	/// The policy to use if multiple patterns in a {RegexSet} match at the same position.
+	///[Block] RegexSetPolicy
+	enum class RegexSetPolicy : UByte {
+		/// The first pattern in the set that matches is used.
+		First,
+
+		/// The pattern with the longest match is used.
+		///[para] The first of the patterns is used if multiple matches have the same length.
+		Longest
+	};
+
+	///[Title] RegexSetMatch
+	/// Contains information about a match found by a {RegexSet}.
+	///[Block] RegexSetMatch
+	struct RegexSetMatch {
+		/// The index of the pattern that matched.
+		UInt pattern = 0;
+
+		/// The match of the pattern.
+		Boxx::Match match;
+	};
+
+	///[Title] RegexSet
+	/// A list of regex patterns that are matched together.
+	///[para] The patterns are combined into a single DFA so all patterns are matched in one pass over the string.
+	/// Patterns with element matches are matched by backtracking.
+	///[Block] RegexSet
+	class RegexSet final {
+	public:
+		/// Creates an empty set.
+		RegexSet();
+
+		/// Creates a set from regex patterns.
+		///[Error] RegexPatternError: Thrown if a pattern is invalid.
+		explicit RegexSet(const List<String>& patterns);
+
+		/// Creates a set from regexes.
+		explicit RegexSet(const List<Regex>& patterns);
+
+		RegexSet(const RegexSet& set);
+		RegexSet(RegexSet&& set) noexcept;
+		~RegexSet();
+
+		///[Heading] Methods
+
+		/// Matches the patterns at a position in a string.
+		///[Arg] str: The string to match.
+		///[Arg] pos: The position in the string where the match has to start.
+		///[Arg] policy: The policy to use if multiple patterns match.
+		///[Returns] Optional<RegexSetMatch>: Contains a value if a pattern matched.
+		Optional<RegexSetMatch> MatchAt(const String& str, const UInt pos = 0, const RegexSetPolicy policy = RegexSetPolicy::First) const;
+
+		/// Matches the patterns at a position in a string and stores the match in a context.
+		///[Arg] str: The string to match.
+		///[Arg] context: The context to store the match in.
+		///[Arg] pattern: Set to the index of the pattern that matched.
+		///[Arg] pos: The position in the string where the match has to start.
+		///[Arg] policy: The policy to use if multiple patterns match.
+		///[Returns] bool: {true} if a pattern matched.
+		bool MatchAt(const StringView& str, MatchContext& context, UInt& pattern, const UInt pos = 0, const RegexSetPolicy policy = RegexSetPolicy::First) const;
+
+		/// Finds all patterns that match somewhere in a string.
+		///[Arg] str: The string to find matches in.
+		///[Arg] pos: The position in the string to start at.
+		///[Returns] List<UInt>: The indices of the patterns that matched in order.
+		List<UInt> Matches(const String& str, const UInt pos = 0) const;
+
+		/// Gets the number of patterns in the set.
+		UInt Count() const;
+
+		/// Gets the regex of a pattern.
+		const Regex& operator[](const UInt index) const;
+
+		void operator=(const RegexSet& set);
+		void operator=(RegexSet&& set) noexcept;
+
+	private:
+		// The patterns compiled to one program that is anchored at the start position and one that searches
+		struct Engine {
+			Regex::Program anchored;
+			Regex::Program search;
+
+			std::vector<bool> compiled;
+			std::vector<bool> groups;
+			std::vector<Int> ends;
+
+			std::mutex mutex;
+			Pointer<Regex::DFA> anchoredDFA;
+			Pointer<Regex::DFA> searchDFA;
+		};
+
+		// The anchored DFA of one thread
+		struct Scanner {
+			Pointer<Regex::DFA> anchored;
+			std::vector<Int> ends;
+
+			Scanner(const Engine& engine);
+		};
+
+		friend class Lexer;
+
+		List<Regex> patterns;
+		Pointer<Engine> engine;
+
+		bool MatchAt(const StringView& str, MatchContext& context, UInt& pattern, const UInt pos, const RegexSetPolicy policy, Scanner* const scanner) const;
+		bool Backtrack(const UInt index, const char* const str, const UInt length, const UInt pos, Regex::MatchInfo& info) const;
+
+		static Pointer<Engine> Compile(const List<Regex>& patterns);
+	};
+
+	///[Title] RegexStreamMatch
+	/// Contains information about a match found by a {RegexStream}.
+	///[Block] RegexStreamMatch
+	struct RegexStreamMatch {
+		/// The offset from the start of the stream where the pattern was found.
+		ULong index = 0;
+
+		/// The length of the matched substring.
+		UInt length = 0;
+
+		/// Contains the entire matched substring.
+		String match;
+
+		/// A list of all matched groups.
+		List<String> groups;
+	};
+
+	///[Title] RegexStream
+	/// Finds matches of a regex in input that is written to the stream in chunks.
+	///[para] Matches are found in the same way as {Regex::GlobalMatch} finds them.
+	/// An empty match moves the search forward by one character.
+	///[para] Only the input after the start of a possible match is kept between writes.
+	/// Input of any size can be matched in constant memory as long as the matches are small.
+	///[para] Matches are passed to a function that takes a {const RegexStreamMatch&}.
+	/// The input between matches can be passed to a function that takes a {const char*} and a {UInt} size.
+	///[Block] RegexStream
+	class RegexStream final {
+	public:
+		///[Heading] Constructors
+
+		/// Creates a stream that finds matches of a regex.
+		///[Error] RegexPatternError: Thrown if the regex is empty or if the pattern contains element matches.
+		explicit RegexStream(const Regex& regex);
+
+		RegexStream(const RegexStream& stream) = delete;
+		~RegexStream();
+
+		///[Heading] Methods
+
+		/// Adds input to the stream.
+		/// The matches that can not change with more input are passed to {output}.
+		///M
+		template <class F>
+		void Write(const char* const data, const UInt size, const F& output);
+		///M
+
+		/// Adds input to the stream.
+		/// The matches that can not change with more input are passed to {output}.
+		/// The input that can not be part of a match is passed to {text}.
+		///M
+		template <class F, class T>
+		void Write(const char* const data, const UInt size, const F& output, const T& text);
+		///M
+
+		/// Ends the input and passes the remaining matches to {output}.
+		/// The stream can be used for new input after this.
+		///M
+		template <class F>
+		void Finish(const F& output);
+		///M
+
+		/// Ends the input and passes the remaining matches to {output} and the remaining input between matches to {text}.
+		/// The stream can be used for new input after this.
+		///M
+		template <class F, class T>
+		void Finish(const F& output, const T& text);
+		///M
+
+		/// Gets the number of bytes written to the stream since it was created or finished.
+		ULong Position() const;
+
+		/// Gets the number of bytes that are kept by the stream until more input is written.
+		UInt Pending() const;
+
+	private:
+		Pointer<Regex::Engine> engine;
+		Pointer<Regex::DFA> forward;
+		Pointer<Regex::DFA> reverse;
+
+		// The input from the first byte that is needed by the current search
+		std::string window;
+		ULong offset = 0;
+
+		// Indices in the window
+		UInt search = 0;
+		UInt keep = 0;
+		UInt pos = 0;
+		UInt text = 0;
+
+		UInt state = 0;
+		Int matchEnd = -1;
+		bool stopped = false;
+
+		Regex::MatchInfo info;
+
+		template <class F, class T>
+		void Run(const bool last, const F& output, const T& text);
+
+		void Restart(const UInt start);
+	};
+
+	#ifdef _BOXX_REGEX_STATIC
+	///[Title] RegexLiteral
+	/// A string literal that is used as the pattern of a {StaticRegex}.
+	///[Block] RegexLiteral
+	///M
+	template <UInt size>
+	struct RegexLiteral {
+	///M
+		/// The characters of the pattern followed by a null character.
+		char chars[size] = {};
+
+		/// Creates a literal from a string literal.
+		constexpr RegexLiteral(const char (&pattern)[size]);
+	};
+
+	///[Title] StaticRegex
+	/// A regex with a pattern that is parsed and compiled at compile time.
+	///[para] The pattern has the same syntax as the pattern of a {Regex} and the matches are the same as the matches of a {Regex} with the same pattern.
+	/// The compiled pattern is stored in the program and the regex is created from it the first time it is used.
+	/// No pattern is parsed and no nodes are created at runtime.
+	///[para] Invalid patterns are compile errors.
+	/// Element matches, inverses of more than one character and repetitions with content that prefers to end empty are not supported since they are matched by backtracking.
+	///[para] Requires C++20.
+	///[Block] StaticRegex
+	///M
+	template <RegexLiteral pattern>
+	class StaticRegex final {
+	///M
+	public:
+		///[Heading] Methods
+
+		/// Find matches in a string.
+		///[Arg] str: The string to find matches in.
+		///[Arg] pos: The position in the string to start at.
+		///[Returns] Optional<Match>: Contains a value if a match was found.
+		Optional<Boxx::Match> Match(const String& str, const UInt pos = 0) const;
+
+		/// Find matches in a string and stores the match in a context.
+		///[Arg] str: The string to find matches in.
+		///[Arg] context: The context to store the match in.
+		///[Arg] pos: The position in the string to start at.
+		///[Returns] bool: {true} if a match was found.
+		bool Match(const StringView& str, MatchContext& context, const UInt pos = 0) const;
+
+		/// Find all matches in a string.
+		///[Arg] str: The string to find matches in.
+		///[Arg] pos: The position in the string to start at.
+		///[Returns] List<Match>: Contains all matches found in the string.
+		List<Boxx::Match> GlobalMatch(const String& str, UInt pos = 0) const;
+
+		/// Find all matches in a string with multiple threads in the same way as {Regex::GlobalMatch}.
+		///[Arg] str: The string to find matches in.
+		///[Arg] pool: The thread pool to match the chunks with.
+		///[Arg] pos: The position in the string to start at.
+		///[Returns] List<Match>: Contains all matches found in the string.
+		List<Boxx::Match> GlobalMatch(const String& str, ThreadPool& pool, UInt pos = 0) const;
+
+		/// Replaces all matches in a string.
+		///[Arg] str: The string to find matches in.
+		///[Arg] replaceFunc: The function to use for replacement.
+		String Replace(const String& str, std::function<String(Boxx::Match)> replaceFunc) const;
+
+		/// Replaces all matches in a string with the matches found by multiple threads.
+		///[Arg] str: The string to find matches in.
+		///[Arg] replaceFunc: The function to use for replacement.
+		///[Arg] pool: The thread pool to find the matches with.
+		String Replace(const String& str, std::function<String(Boxx::Match)> replaceFunc, ThreadPool& pool) const;
+
+		/// Gets a regex with the compiled pattern.
+		///[para] The regex is shared by all static regexes with the same pattern.
+		const Regex& ToRegex() const;
+
+	private:
+		// The pattern is compiled twice since the sizes of the programs are needed to store them
+		static constexpr Regex::StaticSizes sizes = Regex::StaticCompiler(pattern.chars, sizeof(pattern.chars) - 1).Sizes();
+		static constexpr Regex::StaticEngine<sizes> engine = Regex::StaticCompiler(pattern.chars, sizeof(pattern.chars) - 1).template Table<sizes>();
+	};
+	#endif
+
+	///[Title] RegexPatternError
+	/// Used if a regex pattern is invalid.
+	///[Block] RegexPatternError: Error
+	class RegexPatternError : public Error {
+	public:
+		RegexPatternError() : Error() {}
+		RegexPatternError(const char* const msg) : Error(msg) {}
+
+		virtual String Name() const override {
+			return "RegexPatternError";
+		}
+	};
+
+	///[Title] RegexStepError
+	/// Used if a match reaches the step limit of a regex.
+	///[Block] RegexStepError: Error
+	class RegexStepError : public Error {
+	public:
+		RegexStepError() : Error() {}
+		RegexStepError(const char* const msg) : Error(msg) {}
+
+		virtual String Name() const override {
+			return "RegexStepError";
+		}
+	};
+
+	struct Regex::Profiler {
+		std::mutex mutex;
+		RegexProfile profile;
+
+		void Add(const MatchInfo& info, const bool found, const bool limited);
+	};
+
+	inline char Regex::Pattern::operator[](const UInt i) const {
+		if (i >= pattern.Length()) throw RegexPatternError("Unexpected end of pattern");
+		return pattern[i];
+	}
+	
+	inline Regex::Regex() {
+	
+	}
+
+	inline Regex::Regex(const String& pattern) {
+		try {
+			UInt i = 0;
+			Pattern p;
+			p.pattern = pattern;
+			root = ParsePattern(p, i);
+			engine = Compile(root);
+		}
+		catch (RegexPatternError e) {
+			throw e;
+		}
+	}
+
+	inline Regex::Regex(const Regex& regex) {
+		root = regex.root;
+		engine = regex.engine;
+		memoize = regex.memoize;
+		stepLimit = regex.stepLimit;
+		profiler = regex.profiler;
+	}
+
+	inline Regex::Regex(Regex&& regex) noexcept {
+		root = std::move(regex.root);
+		engine = std::move(regex.engine);
+		memoize = regex.memoize;
+		stepLimit = regex.stepLimit;
+		profiler = std::move(regex.profiler);
+	}
+
+	inline Regex::~Regex() {
+
+	}
+
+	inline Optional<Match> Regex::Match(const String& str, const UInt pos) const {
+		MatchInfo info;
+
+		if (Find((const char*)str, str.Length(), pos, info)) {
+			return CreateMatch(info);
+		}
+		else {
+			return nullptr;
+		}
+	}
+
+	inline bool Regex::Match(const StringView& str, MatchContext& context, const UInt pos) const {
+		context.matched = Find(str.Data(), str.Length(), pos, context.info);
+		return context.matched;
+	}
+
+	inline List<Match> Regex::GlobalMatch(const String& str, UInt pos) const {
+		List<Boxx::Match> matches;
+		MatchContext context;
+
+		while (Match(str, context, pos)) {
+			matches.Add(context.ToMatch());
+			pos = NextPos(matches.Last());
+		}
+
+		return matches;
+	}
+
+	inline List<Match> Regex::GlobalMatch(const String& str, ThreadPool& pool, UInt pos) const {
+		const UInt length = str.Length();
+
+		if (!engine || engine->forward.anchored || pos >= length) {
+			return GlobalMatch(str, pos);
+		}
+
+		UInt chunks = Math::Min(pool.ThreadCount() * 4, (length - pos) / minChunkSize);
+		const UInt chunkSize = chunks > 0 ? (length - pos) / chunks : 0;
+
+		// The chunks are extended by the max length of a match or split after line feeds
+		const bool bounded = engine->width >= 0 && (UInt)engine->width <= chunkSize;
+
+		if (chunks < 2 || (!bounded && engine->lineFeeds)) {
+			return GlobalMatch(str, pos);
+		}
+
+		const char* const data = (const char*)str;
+
+		// The matches that start in a chunk are found in a view of the string that ends after all those matches
+		List<UInt> starts = List<UInt>(chunks + 1);
+		List<UInt> views  = List<UInt>(chunks);
+		starts.Add(pos);
+
+		for (UInt i = 1; i < chunks; i++) {
+			UInt end = pos + chunkSize * i;
+
+			if (!bounded) {
+				const void* const lineFeed = std::memchr(data + end, '\n', length - end);
+				end = lineFeed ? (UInt)((const char*)lineFeed - data) + 1 : length;
+			}
+
+			if (end <= starts.Last() || end >= length) break;
+			starts.Add(end);
+		}
+
+		// The last chunk also contains matches at the end of the string
+		chunks = starts.Count();
+		starts.Add(length + 1);
+
+		for (UInt i = 0; i < chunks; i++) {
+			if (i == chunks - 1) {
+				views.Add(length);
+			}
+			else if (bounded) {
+				views.Add(Math::Min(starts[i + 1] + (UInt)engine->width, length));
+			}
+			else {
+				views.Add(starts[i + 1]);
+			}
+		}
+
+		std::vector<std::future<List<Boxx::Match>>> results;
+		results.reserve(chunks);
+
+		for (UInt i = 0; i < chunks; i++) {
+			results.push_back(pool.Run([this, data, &starts, &views, i]() {
+				List<Boxx::Match> matches;
+				Searcher searcher = Searcher(*engine);
+				MatchInfo info;
+
+				// The first search continues the search of the previous chunk
+				UInt p = starts[i];
+				bool start = i == 0;
+
+				while (Find(data, views[i], p, info, &searcher, start) && info.matchStart < starts[i + 1]) {
+					matches.Add(CreateMatch(info));
+					p = NextPos(matches.Last());
+					start = true;
+				}
+
+				return matches;
+			}));
+		}
+
+		for (std::future<List<Boxx::Match>>& result : results) {
+			result.wait();
+		}
+
+		// The matches of a chunk are used if they are the same as the matches found by searching from the current position
+		List<Boxx::Match> matches;
+		MatchInfo info;
+
+		for (UInt i = 0; i < chunks; i++) {
+			List<Boxx::Match> found = results[i].get();
+
+			UInt gap = starts[i];
+			UInt k = 0;
+
+			while (true) {
+				while (k < found.Count() && found[k].index < pos) {
+					gap = NextPos(found[k]);
+					k++;
+				}
+
+				// A search from the gap finds the same matches as a search from the current position if no match starts between them
+				const bool continued = k == 0 && i > 0;
+				bool synced;
+
+				if (gap == pos) synced = !engine->searchStart || !continued;
+				else if (gap < pos) synced = !engine->searchStart;
+				else synced = continued;
+
+				if (synced) {
+					if (k >= found.Count()) break;
+
+					matches.Add(std::move(found[k]));
+					pos = gap = NextPos(matches.Last());
+					k++;
+				}
+				else if (Find(data, views[i], pos, info) && info.matchStart < starts[i + 1]) {
+					matches.Add(CreateMatch(info));
+					pos = NextPos(matches.Last());
+				}
+				else {
+					break;
+				}
+			}
+		}
+
+		return matches;
+	}
+
+	inline String Regex::Replace(const String& str, std::function<String(Boxx::Match)> replaceFunc) const {
+		StringBuilder output;
+
+		UInt pos = 0;
+		UInt copied = 0;
+		MatchContext context;
+
+		while (Match(str, context, pos)) {
+			if (context.Index() > copied) {
+				output += str.Sub(copied, context.Index() - 1);
+			}
+
+			output += replaceFunc(context.ToMatch());
+			copied = context.Index() + context.Length();
+			pos = context.Length() > 0 ? copied : copied + 1;
+		}
+
+		if (copied < str.Length()) {
+			output += str.Sub(copied);
+		}
+
+		return output.ToString();
+	}
+
+	inline String Regex::Replace(const String& str, std::function<String(Boxx::Match)> replaceFunc, ThreadPool& pool) const {
+		StringBuilder output;
+		UInt copied = 0;
+
+		for (const Boxx::Match& match : GlobalMatch(str, pool)) {
+			if (match.index > copied) {
+				output += str.Sub(copied, match.index - 1);
+			}
+
+			output += replaceFunc(match);
+			copied = match.index + match.length;
+		}
+
+		if (copied < str.Length()) {
+			output += str.Sub(copied);
+		}
+
+		return output.ToString();
+	}
+
+	inline void Regex::SetMemoization(const bool memoize) {
+		this->memoize = memoize;
+	}
+
+	inline bool Regex::HasMemoization() const {
+		return memoize;
+	}
+
+	inline void Regex::SetStepLimit(const ULong limit) {
+		stepLimit = limit;
+	}
+
+	inline ULong Regex::StepLimit() const {
+		return stepLimit;
+	}
+
+	inline void Regex::SetProfiling(const bool profile) {
+		if (!profile) {
+			profiler = nullptr;
+			return;
+		}
+
+		profiler = new Profiler();
+		if (!root) return;
+
+		const Pointer<RootNode> rootNode = root.Cast<RootNode>();
+		profiler->profile.pattern = rootNode->pattern;
+
+		for (const RegexNode* const node : rootNode->nodes) {
+			RegexNodeProfile nodeProfile;
+			nodeProfile.pattern  = String((const char*)rootNode->pattern + node->position, node->length);
+			nodeProfile.position = node->position;
+			profiler->profile.nodes.Add(nodeProfile);
+		}
+	}
+
+	inline bool Regex::HasProfiling() const {
+		return profiler != nullptr;
+	}
+
+	inline RegexProfile Regex::Profile() const {
+		if (!profiler) return RegexProfile();
+
+		std::lock_guard<std::mutex> lock(profiler->mutex);
+		RegexProfile profile = profiler->profile;
+		profile.nodes = profile.nodes.Copy();
+		return profile;
+	}
+
+	inline UInt Regex::NextPos(const Boxx::Match& match) {
+		// Empty matches advance by one character to not find the same match again
+		return match.length > 0 ? match.index + match.length : match.index + 1;
+	}
+
+	inline Optional<Match> Regex::Match(const String& pattern, const String& str, const UInt pos) {
+		try {
+			return Cached(pattern)->Match(str, pos);
+		}
+		catch (RegexPatternError e) {
+			throw e;
+		}
+	}
+
+	inline List<Match> Regex::GlobalMatch(const String& pattern, const String& str, const UInt pos) {
+		try {
+			return Cached(pattern)->GlobalMatch(str, pos);
+		}
+		catch (RegexPatternError e) {
+			throw e;
+		}
+	}
+
+	inline String Regex::Replace(const String& pattern, const String& str, std::function<String(Boxx::Match)> replaceFunc) {
+		try {
+			return Cached(pattern)->Replace(str, replaceFunc);
+		}
+		catch (RegexPatternError e) {
+			throw e;
+		}
+	}
+
+	inline String Regex::Escape(const String& str) {
+		List<char> chars{str.Length()};
+
+		for (const char c : str) {
+			if (MetaChar::IsMetaChar(c)) {
+				chars.Add(MetaChar::escape);
+				chars.Add(c);
+			}
+			else {
+				chars.Add(c);
+			}
+		}
+
+		return String(chars);
+	}
+
+	inline void Regex::Serialize(Buffer& buffer) const {
+		if (engine == nullptr) throw RegexPatternError("The pattern can not be serialized");
+
+		// Version 1 of the format
+		buffer.Write<String>("BXRE");
+		buffer.Write<UByte>(1);
+		buffer.Write<UByte>(engine->groups ? 1 : 0);
+
+		engine->prefilter.Write(buffer);
+		engine->forward.Write(buffer);
+		engine->reverse.Write(buffer);
+	}
+
+	inline Regex Regex::Deserialize(Buffer& buffer) {
+		if (buffer.ReadString(4) != "BXRE" || buffer.Read<UByte>() != 1) {
+			throw RegexPatternError("Invalid compiled pattern");
+		}
+
+		Pointer<Engine> engine = new Engine();
+		engine->groups = buffer.Read<UByte>() != 0;
+
+		if (!engine->prefilter.Read(buffer) || !engine->forward.Read(buffer) || !engine->reverse.Read(buffer)) {
+			throw RegexPatternError("Invalid compiled pattern");
+		}
+
+		engine->Finish();
+
+		Regex regex;
+		regex.engine = engine;
+		return regex;
+	}
+
+	inline void Regex::SetCacheCapacity(const UInt capacity) {
+		Cache& cache = GetCache();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		cache.capacity = capacity;
+		cache.Trim();
+	}
+
+	inline UInt Regex::CacheCapacity() {
+		Cache& cache = GetCache();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		return cache.capacity;
+	}
+
+	inline ULong Regex::CacheHits() {
+		Cache& cache = GetCache();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		return cache.hits;
+	}
+
+	inline ULong Regex::CacheMisses() {
+		Cache& cache = GetCache();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		return cache.misses;
+	}
+
+	inline void Regex::ClearCache() {
+		Cache& cache = GetCache();
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		cache.entries.clear();
+		cache.lookup.clear();
+		cache.hits = 0;
+		cache.misses = 0;
+	}
+
+	inline void Regex::operator=(const Regex& regex) {
+		root = regex.root;
+		engine = regex.engine;
+		memoize = regex.memoize;
+		stepLimit = regex.stepLimit;
+		profiler = regex.profiler;
+	}
+
+	inline void Regex::operator=(Regex&& regex) noexcept {
+		root = std::move(regex.root);
+		engine = std::move(regex.engine);
+		memoize = regex.memoize;
+		stepLimit = regex.stepLimit;
+		profiler = std::move(regex.profiler);
+	}
+
+	inline Regex::Node Regex::ParsePattern(const Pattern& pattern, UInt& index) {
+		Pointer<RootNode> root = new RootNode();
+		root->next = ParseExpression(pattern, index).value1;
+
+		if (index < pattern.pattern.Length()) throw RegexPatternError("Unexpected character '" + String(pattern[index]) + "'"); 
+
+		if (!root->next) root->next = new LeafNode();
+
+		root->prefilter = Prefilter::Create(root->next.operator->());
+		root->anchored = root->next.Is<StartNode>();
+		root->pattern = pattern.pattern;
+		ListNodes(*root);
+		return root;
+	}
+
+	inline void Regex::Locate(const Node& node, const UInt start, const UInt end) {
+		node->position = start;
+		node->length   = end - start;
+	}
+
+	inline void Regex::ListNodes(RootNode& root) {
+		std::unordered_set<RegexNode*> visited;
+		std::vector<RegexNode*> stack{root.next.operator->()};
+
+		while (!stack.empty()) {
+			RegexNode* const node = stack.back();
+			stack.pop_back();
+
+			if (!node || !visited.insert(node).second) continue;
+			if (node->length > 0) root.nodes.push_back(node);
+
+			stack.push_back(node->next.operator->());
+
+			if (const SelectNode* const select = dynamic_cast<const SelectNode*>(node)) {
+				for (const Node& option : select->nodes) {
+					stack.push_back(option.operator->());
+				}
+			}
+			else if (const QuantifierNode* const quantifier = dynamic_cast<const QuantifierNode*>(node)) {
+				stack.push_back(quantifier->content.operator->());
+			}
+			else if (const PlainQuantifierNode* const quantifier = dynamic_cast<const PlainQuantifierNode*>(node)) {
+				stack.push_back(quantifier->content.operator->());
+			}
+			else if (const InverseNode* const inverse = dynamic_cast<const InverseNode*>(node)) {
+				stack.push_back(inverse->content.operator->());
+			}
+		}
+
+		// Outer parts are listed before the parts inside them
+		std::stable_sort(root.nodes.begin(), root.nodes.end(), [](const RegexNode* const a, const RegexNode* const b) {
+			return a->position != b->position ? a->position < b->position : a->length > b->length;
+		});
+
+		for (UInt i = 0; i < root.nodes.size(); i++) {
+			root.nodes[i]->id = i;
+		}
+	}
+
+	inline Regex::NodeLeaf Regex::ParseExpression(const Pattern& pattern, UInt& index) {
+		const UInt start = index;
+		List<NodeLeaf> nodes;
+
+		NodeLeaf node = ParseRawExpression(pattern, index);
+
+		while (node.value1) {
+			nodes.Add(node);
+
+			if (index >= pattern.pattern.Length() || pattern[index] != MetaChar::select) break;
+
+			index++;
+			node = ParseRawExpression(pattern, index);
+		}
+
+		if (nodes.Count() == 1) return nodes[0];
+
+		Pointer<EmptyNode> empty = new EmptyNode();
+		empty->next = new LeafNode();
+		Pointer<SelectNode> select = new SelectNode();
+		select->end = empty;
+		Locate(select, start, index);
+
+		for (NodeLeaf& exp : nodes) {
+			exp.value2->next = empty;
+			select->nodes.Add(exp.value1);
+		}
+
+		return NodeLeaf(select, empty);
+	}
+
+	inline Regex::NodeLeaf Regex::ParseRawExpression(const Pattern& pattern, UInt& index) {
+		Node root = nullptr;
+		Node element = nullptr;
+
+		NodeLeaf node = ParseElement(pattern, index);
+
+		while (node.value1) {
+			if (element) element->next = node.value1;
+			element = node.value2;
+
+			if (!root) root = node.value1;
+
+			node = ParseElement(pattern, index);
+		}
+
+		if (element) {
+			element->next = new LeafNode();
+			return NodeLeaf(root, element);
+		}
+		else {
+			Pointer<EmptyNode> empty = new EmptyNode();
+			return NodeLeaf(empty, empty);
+		}
+	}
+
+	inline Regex::NodeLeaf Regex::ParseElement(const Pattern& pattern, UInt& index) {
+		const UInt start = index;
+		NodeLeaf element = ParseRawElement(pattern, index);
+		if (!element.value1) return element;
+
+		Locate(element.value1, start, index);
+
+		if (Optional<Tuple<UInt, UInt, bool>> quant = ParseQuantifier(pattern, index)) {
+			ByteSet set;
+
+			if (!element.value1->IsPlain()) {
+				Pointer<QuantifierNode> quantifier = new QuantifierNode();
+				quantifier->min = quant->value1;
+				quantifier->max = quant->value2;
+				quantifier->many = quant->value3;
+
+				Pointer<QuantifierEndNode> qEnd = new QuantifierEndNode();
+				qEnd->min  = quantifier->min;
+				qEnd->max  = quantifier->max;
+				qEnd->many = quantifier->many;
+
+				Pointer<EmptyNode> empty = new EmptyNode();
+
+				quantifier->next    = empty;
+				quantifier->content = element.value1;
+
+				qEnd->next    = empty;
+				qEnd->content = element.value1;
+
+				element.value2->next = qEnd;
+				element.value2 = empty;
+				element.value1 = quantifier;
+			}
+			else if (element.value1.Is<AnyNode>()) {
+				Pointer<AnyQuantifierNode> quantifier = new AnyQuantifierNode();
+				quantifier->min = quant->value1;
+				quantifier->max = quant->value2;
+				quantifier->many = quant->value3;
+
+				element.value1 = quantifier;
+				element.value2 = quantifier;
+			}
+			else if (element.value1 == element.value2 && Compiler::SetOf(element.value1.operator->(), set)) {
+				Pointer<ClassQuantifierNode> quantifier = new ClassQuantifierNode();
+				quantifier->min = quant->value1;
+				quantifier->max = quant->value2;
+				quantifier->many = quant->value3;
+				quantifier->set = set;
+				quantifier->ranges = ByteRanges::Create(set);
+
+				element.value1 = quantifier;
+				element.value2 = quantifier;
+			}
+			else {
+				Pointer<PlainQuantifierNode> quantifier = new PlainQuantifierNode();
+				quantifier->min = quant->value1;
+				quantifier->max = quant->value2;
+				quantifier->many = quant->value3;
+
+				quantifier->content = element.value1;
+				element.value2->next = new LeafNode();
+
+				element.value1 = quantifier;
+				element.value2 = quantifier;
+			}
+
+			Locate(element.value1, start, index);
+		}
+
+		return element;
+	}
+
+	inline Regex::NodeLeaf Regex::ParseElementMatch(const Pattern& pattern, UInt& index) {
+		if (index >= pattern.pattern.Length() || pattern[index] != MetaChar::element) {
+			return NodeLeaf(nullptr, nullptr);
+		}
+
+		index++;
+
+		const UInt start = index;
+		NodeLeaf node = ParseRawElement(pattern, index);
+
+		if (node.value1 == nullptr) {
+			throw RegexPatternError("Element expected after '" + String(MetaChar::element) + "'");
+		}
+
+		Locate(node.value1, start, index);
+
+		Pointer<ElementNode> element = new ElementNode();
+		element->next = node.value1;
+
+		Pointer<ElementEndNode> elementEnd = new ElementEndNode();
+		node.value2->next = elementEnd;
+
+		return NodeLeaf(element, elementEnd);
+	}
+
+	inline Regex::NodeLeaf Regex::ParseLiteralString(const Pattern& pattern, UInt& index) {
+		if (index >= pattern.pattern.Length() || pattern[index] != MetaChar::quote) {
+			return NodeLeaf(nullptr, nullptr);
+		}
+
+		index++;
+
+		UInt ind = index;
+
+		List<char> str;
+
+		while (ind < pattern.pattern.Length()) {
+			if (pattern[ind] == MetaChar::quote) {
+				if (ind + 1 < pattern.pattern.Length() && pattern[ind + 1] == MetaChar::quote) {
+					ind += 2;
+					str.Add(MetaChar::quote);
+					continue;
+				}
+
+				index = ind + 1;
+				Pointer<StringNode> strNode = new StringNode();
+				strNode->string = String(str);
+				return NodeLeaf(strNode, strNode);
+			}
+
+			str.Add(pattern[ind]);
+			ind++;
+		}
+
+		throw RegexPatternError("Literal string must be closed");
+	}
+
+	inline Regex::NodeLeaf Regex::ParseRawElement(const Pattern& pattern, UInt& index) {
+		if (Node range = ParseRange(pattern, index)) {
+			return NodeLeaf(range, range);
+		}
+		else if (Node str = ParseString(pattern, index)) {
+			return NodeLeaf(str, str);
+		}
+		else if (Optional<char> c = ParseChar(pattern, index)) {
+			Pointer<StringNode> node = new StringNode();
+			node->string = String(*c);
+			return NodeLeaf(node, node);
+		}
+
+		if (index >= pattern.pattern.Length()) {
+			return NodeLeaf(nullptr, nullptr);
+		}
+
+		switch (pattern[index]) {
+			case MetaChar::escape: {
+				Node esc = ParseEscape(pattern, index);
+				return NodeLeaf(esc, esc);
+			}
+
+			case MetaChar::any: {
+				index++;
+				Node node = new AnyNode();
+				return NodeLeaf(node, node);
+			}
+
+			case MetaChar::start: {
+				index++;
+				Node node = new StartNode();
+				return NodeLeaf(node, node);
+			}
+
+			case MetaChar::end: {
+				index++;
+				Node node = new EndNode();
+				return NodeLeaf(node, node);
+			}
+
+			case MetaChar::inverse: {
+				index++;
+
+				const UInt start = index;
+				NodeLeaf node = ParseRawElement(pattern, index);
+
+				if (node.value1) {
+					ByteSet set;
+
+					// Inverses of single characters are sets of all other characters
+					if (node.value1 == node.value2 && Compiler::SetOf(node.value1.operator->(), set)) {
+						Pointer<ClassNode> inv = new ClassNode();
+
+						for (UInt i = 0; i < 4; i++) {
+							inv->set.bits[i] = ~set.bits[i];
+						}
+
+						return NodeLeaf(inv, inv);
+					}
+
+					Pointer<InverseNode> inv = new InverseNode();
+					node.value2->next = new LeafNode();
+					inv->content = node.value1;
+					Locate(inv->content, start, index);
+					return NodeLeaf(inv, inv);
+				}
+				else {
+					throw RegexPatternError("Element expected after '" + String(MetaChar::inverse) + "'");
+				}
+			}
+
+			case MetaChar::setOpen: {
+				Node set = ParseSet(pattern, index);
+				return NodeLeaf(set, set);
+			}
+
+			case MetaChar::groupOpen: 
+			case MetaChar::hiddenOpen: {
+				return ParseGroup(pattern, index);
+			}
+
+			case MetaChar::element: {
+				return ParseElementMatch(pattern, index);
+			}
+
+			case MetaChar::quote: {
+				return ParseLiteralString(pattern, index);
+			}
+		}
+
+		return NodeLeaf(nullptr, nullptr);
+	}
+
+	inline Optional<Tuple<UInt, UInt, bool>> Regex::ParseQuantifier(const Pattern& pattern, UInt& index) {
+		if (index >= pattern.pattern.Length()) return nullptr;
+
+		UInt min = 0, max = 0;
+		bool many = true;
+		
+		if (pattern[index] == MetaChar::manyOpt) {
+			min = 0;
+			max = Math::UIntMax();
+			many = true;
+			index++;
+		}
+		else if (pattern[index] == MetaChar::many) {
+			min = 1;
+			max = Math::UIntMax();
+			many = true;
+			index++;
+		}
+		else if (pattern[index] == MetaChar::fewOpt) {
+			min = 0;
+			max = Math::UIntMax();
+			many = false;
+			index++;
+		}
+		else if (pattern[index] == MetaChar::few) {
+			min = 1;
+			max = Math::UIntMax();
+			many = false;
+			index++;
+		}
+		else if (pattern[index] == MetaChar::optional) {
+			min = 0;
+			max = 1;
+			many = true;
+			index++;
+		}
+		else if (pattern[index] == MetaChar::quantOpen) {
+			index++;
+			min = 0;
+			max = Math::UIntMax();
+
+			if (index >= pattern.pattern.Length()) {
+				throw RegexPatternError("Quantifier range expected after '" + String(MetaChar::quantOpen) + "'");
+			}
+
+			if (pattern[index] == MetaChar::quantRange) {
+				index++;
+
+				if (Optional<UInt> num = ParseInt(pattern, index)) {
+					max = *num;
+				}
+				else {
+					throw RegexPatternError("Integer expected after '" + String(MetaChar::quantRange) + "' in quantifier range");
+				}
+			}
+			else if (Optional<UInt> num = ParseInt(pattern, index)) {
+				min = *num;
+
+				if (index < pattern.pattern.Length() && pattern[index] == MetaChar::quantRange) {
+					index++;
+
+					if (Optional<UInt> n = ParseInt(pattern, index)) {
+						max = *n;
+					}
+					else {
+						max = Math::UIntMax();
+					}
+				}
+				else {
+					max = min;
+				}
+			}
+
+			if (min > max) {
+				throw RegexPatternError("Quantifier range is out of order");
+			}
+
+			if (index >= pattern.pattern.Length()) {
+				throw RegexPatternError("'" + String(MetaChar::quantClose) + "' expected to close quantifier");
+			}
+
+			if (pattern[index] == MetaChar::few || pattern[index] == MetaChar::many) {
+				many = pattern[index] == MetaChar::many;
+				index++;
+			}
+
+			if (index >= pattern.pattern.Length() || pattern[index] != MetaChar::quantClose) {
+				throw RegexPatternError("'" + String(MetaChar::quantClose) + "' expected to close quantifier");
+			}
+
+			index++;
+		}
+		else {
+			return nullptr;
+		}
+
+		return Tuple<UInt, UInt, bool>(min, max, many);
+	}
+
+	inline Regex::Node Regex::ParseRange(const Pattern& pattern, UInt& index) {
+		const UInt startIndex = index;
+
+		Optional<char> start = ParseChar(pattern, index);
+		if (!start) return nullptr;
+
+		if (index >= pattern.pattern.Length()) {
+			index = startIndex;
+			return nullptr;
+		}
+
+		if (pattern[index] != MetaChar::range) {
+			index = startIndex;
+			return nullptr;
+		}
+
+		index++;
+
+		if (Optional<char> endChar = ParseChar(pattern, index)) {
+			Pointer<ClassNode> range = new ClassNode();
+			range->set.AddRange(*start, *endChar);
+			return range;
+		}
+		else {
+			throw RegexPatternError("Character expected after '" + String(MetaChar::range) + "' to end range");
+		}
+	}
+
+	inline Regex::Node Regex::ParseString(const Pattern& pattern, UInt& index) {
+		List<char> str;
+		UInt lastIndex = index;
+
+		while (Optional<char> c = ParseChar(pattern, index, false)) {
+			str.Add(*c);
+			lastIndex = index;
+		}
+
+		if (str.IsEmpty()) return nullptr;
+
+		if (str.Count() > 1) {
+			Pointer<StringNode> node = new StringNode();
+			node->string = String(str);
+			return node;
+		}
+		else {
+			Pointer<CharNode> node = new CharNode();
+			node->c = str[0];
+			return node;
+		}
+	}
+
+	inline Regex::Node Regex::ParseEscape(const Pattern& pattern, UInt& index) {
+		if (pattern[index] != MetaChar::escape) return nullptr;
+		index++;
+
+		Pointer<ClassNode> chars = new ClassNode();
+
+		if (ParseClassEscape(pattern, index, chars->set)) {
+			return chars;
+		}
+
+		switch (pattern[index]) {
+			case MetaChar::lineBreak: {
+				index++;
+				return new LineBreakNode();
+			}
+
+			case MetaChar::bound: {
+				index++;
+				return new BoundaryNode();
+			}
+		}
+
+		if (Optional<UInt> num = ParseInt(pattern, index)) {
+			Pointer<ElementMatchNode> match = new ElementMatchNode();
+			match->index = *num;
+			return match;
+		}
+
+		throw RegexPatternError("Invalid escape character '" + String(pattern[index]) + "'");
+	}
+
+	inline Regex::Node Regex::ParseSet(const Pattern& pattern, UInt& index) {
+		if (pattern[index] != MetaChar::setOpen) return nullptr;
+		index++;
+
+		Pointer<ClassNode> set = new ClassNode();
+		bool empty = true;
+
+		while (pattern[index] != MetaChar::setClose) {
+			if (ParseSetRange(pattern, index, set->set)) {
+				empty = false;
+			}
+			else if (Optional<char> c = ParseSetChar(pattern, index)) {
+				set->set.Add((UByte)*c);
+				empty = false;
+			}
+			else if (ParseSetEscape(pattern, index, set->set)) {
+				empty = false;
+			}
+			else {
+				throw RegexPatternError("Unexpected character '" + String(pattern[index]) + "' in character set");
+			}
+		}
+
+		index++;
+
+		// An empty set matches an empty string
+		if (empty) return new EmptyNode();
+		return set;
+	}
+
+	inline bool Regex::ParseSetRange(const Pattern& pattern, UInt& index, ByteSet& set) {
+		const UInt startIndex = index;
+
+		Optional<char> start = ParseSetChar(pattern, index);
+		if (!start) return false;
+
+		if (pattern[index] != MetaChar::range) {
+			index = startIndex;
+			return false;
+		}
+
+		index++;
+
+		if (Optional<char> endChar = ParseSetChar(pattern, index)) {
+			set.AddRange(*start, *endChar);
+			return true;
+		}
+		else {
+			throw RegexPatternError("Character expected after '" + String(MetaChar::range) + "' to end range");
+		}
+	}
+
+	inline bool Regex::ParseSetEscape(const Pattern& pattern, UInt& index, ByteSet& set) {
+		if (pattern[index] != MetaChar::escape) return false;
+		index++;
+
+		if (ParseClassEscape(pattern, index, set)) {
+			return true;
+		}
+
+		throw RegexPatternError("Invalid escape character '" + String(pattern[index]) + "'");
+	}
+
+	inline bool Regex::ParseClassEscape(const Pattern& pattern, UInt& index, ByteSet& set) {
+		if (!MetaChar::AddClass(pattern[index], set)) return false;
+		index++;
+		return true;
+	}
+
+	inline Regex::NodeLeaf Regex::ParseGroup(const Pattern& pattern, UInt& index) {
+		if (pattern[index] != MetaChar::groupOpen && pattern[index] != MetaChar::hiddenOpen) {
+			return NodeLeaf(nullptr, nullptr);
+		}
+
+		bool isHidden = pattern[index] == MetaChar::hiddenOpen;
+
+		Pointer<GroupNode> group = new GroupNode();
+		group->isHidden = isHidden;
+		index++;
+
+		NodeLeaf node = ParseExpression(pattern, index);
+		group->next = node.value1;
+		
+		Pointer<GroupEndNode> groupEnd = new GroupEndNode();
+		groupEnd->isHidden = isHidden;
+		node.value2->next = groupEnd;
+
+		if (isHidden && pattern[index] != MetaChar::hiddenClose) {
+			throw RegexPatternError("'" + String(MetaChar::hiddenClose) + "' expected to close hidden group");
+		}
+
+		if (!isHidden && pattern[index] != MetaChar::groupClose) {
+			throw RegexPatternError("'" + String(MetaChar::groupClose) + "' expected to close group");
+		}
+
+		index++;
+		return NodeLeaf(group, groupEnd);
+	}
+
+	inline Optional<char> Regex::ParseChar(const Pattern& pattern, UInt& index, const bool skipPost) {
+		if (index >= pattern.pattern.Length()) return nullptr;
+
+		char c = pattern[index];
+
+		if (c == MetaChar::escape) {
+			if (index + 1 >= pattern.pattern.Length()) return nullptr;
+			c = pattern[index + 1];
+			if (MetaChar::IsReservedEscape(c)) return nullptr;
+			index++;
+		}
+		else if (MetaChar::IsMetaChar(c)) {
+			return nullptr;
+		}
+		else if (!skipPost && (index + 1 < pattern.pattern.Length() && MetaChar::IsPostChar(pattern[index + 1]))) {
+			return nullptr;
+		}
+
+		index++;
+		return c;
+	}
+
+	inline Optional<char> Regex::ParseSetChar(const Pattern& pattern, UInt& index) {
+		if (index >= pattern.pattern.Length()) return nullptr;
+
+		char c = pattern[index];
+
+		if (c == MetaChar::escape) {
+			if (index + 1 >= pattern.pattern.Length()) return nullptr;
+			c = pattern[index + 1];
+			if (MetaChar::IsReservedSetEscape(c)) return nullptr;
+			index++;
+		}
+		else if (MetaChar::IsSetMetaChar(c)) {
+			return nullptr;
+		}
+
+		index++;
+		return c;
+	}
+
+	inline Optional<UInt> Regex::ParseInt(const Pattern& pattern, UInt& index) {
+		if (index >= pattern.pattern.Length()) return nullptr;
+		
+		UInt startIndex = index;
+
+		while ('0' <= pattern[index] && pattern[index] <= '9') {
+			index++;
+			if (index >= pattern.pattern.Length()) break;
+		}
+
+		if (startIndex == index) return nullptr;
+
+		return pattern.pattern.Sub(startIndex, index - 1).ToUInt();
+	}
+
+	inline const char* Regex::RegexNode::Match(const char* str, MatchInfo& info) {
+		if (!info.profile || id == Math::UIntMax()) return MatchNode(str, info);
+
+		info.counts[id].entered++;
+
+		const char* const c = MatchNode(str, info);
+		if (!c) info.counts[id].backtracked++;
+		return c;
+	}
+
+	inline const char* Regex::RootNode::MatchNode(const char* str, MatchInfo& info) {
+		const UInt end = (UInt)(info.end - info.str);
+
+		if (!anchored && !prefilter.HasRequired(info.str, (UInt)(str - info.str), end)) {
+			return nullptr;
+		}
+
+		do {
+			// Jumps to the next position where a match can start
+			if (!anchored && prefilter.Skips()) {
+				UInt found;
+				if (!prefilter.Next(info.str, (UInt)(str - info.str), end, found)) return nullptr;
+
+				str = info.str + found;
+				info.matchStart = found;
+			}
+
+			if (const char* c = next->Match(str, info)) {
+				return c;
+			}
+
+			// Removes groups left by the failed match
+			info.groups.clear();
+			info.elements.clear();
+
+			str++;
+			info.matchStart++;
+
+			if (str >= info.end) return nullptr;
+		}
+		while (!anchored);
+
+		return nullptr;
+	}
+
+	inline const char* Regex::LeafNode::MatchNode(const char* str, MatchInfo& info) {
+		info.matchEnd = (UInt)(str - info.str);
+		return str;
+	}
+
+	inline const char* Regex::StringNode::MatchNode(const char* str, MatchInfo& info) {
+		if ((UInt)(info.end - str) < string.Length()) {
+			return nullptr;
+		}
+
+		const char* c = str;
+
+		for (UInt i = 0; i < string.Length(); i++, c++) {
+			if (*c != string[i]) return nullptr;
+		}
+
+		info.Consume(this, string.Length());
+		return next->Match(c, info);
+	}
+
+	inline const char* Regex::CharNode::MatchNode(const char* str, MatchInfo& info) {
+		if (str >= info.end || *str != c) {
+			return nullptr;
+		}
+
+		info.Consume(this, 1);
+		return next->Match(str + 1, info);
+	}
+
+	inline const char* Regex::ClassNode::MatchNode(const char* str, MatchInfo& info) {
+		if (str >= info.end || !set.Contains((UByte)*str)) {
+			return nullptr;
+		}
+
+		info.Consume(this, 1);
+		return next->Match(str + 1, info);
+	}
+
+	inline const char* Regex::LineBreakNode::MatchNode(const char* str, MatchInfo& info) {
+		if (str >= info.end) {
+			return nullptr;
+		}
+
+		if (*str == '\r') {
+			if (str + 1 < info.end && *(str + 1) == '\n') { 
+				info.Consume(this, 2);
+				return next->Match(str + 2, info);
+			}
+			else {
+				info.Consume(this, 1);
+				return next->Match(str + 1, info);
+			}
+		}
+		else if (*str == '\n') {
+			info.Consume(this, 1);
+			return next->Match(str + 1, info);
+		}
+
+		return nullptr;
+	}
+
+	inline const char* Regex::BoundaryNode::MatchNode(const char* str, MatchInfo& info) {
+		if (
+			(str == info.start || str == info.end) ||
+			(MetaChar::IsWord(*(str - 1)) && !MetaChar::IsWord(*str)) ||
+			(!MetaChar::IsWord(*(str - 1)) && MetaChar::IsWord(*str))
+		) {
+			return next->Match(str, info);
+		}
+		else {
+			return nullptr;
+		}
+	}
+
+	inline const char* Regex::AnyNode::MatchNode(const char* str, MatchInfo& info) {
+		if (str >= info.end) {
+			return nullptr;
+		}
+
+		info.Consume(this, 1);
+		return next->Match(str + 1, info);
+	}
+
+	inline const char* Regex::StartNode::MatchNode(const char* str, MatchInfo& info) {
+		if (str != info.start) {
+			return nullptr;
+		}
+
+		return next->Match(str, info);
+	}
+
+	inline const char* Regex::EndNode::MatchNode(const char* str, MatchInfo& info) {
+		if (str != info.end) {
+			return nullptr;
+		}
+
+		return next->Match(str, info);
+	}
+
+	inline const char* Regex::InverseNode::MatchNode(const char* str, MatchInfo& info) {
+		if (str >= info.end) {
+			return nullptr;
+		}
+
+		const UInt groupSize   = (UInt)info.groups.size();
+		const UInt elementSize = (UInt)info.elements.size();
+
+		if (content->Match(str, info)) {
+			info.groups.resize(groupSize);
+			info.elements.resize(elementSize);
+			return nullptr;
+		}
+
+		info.Consume(this, 1);
+		return next->Match(str + 1, info);
+	}
+
+	inline const char* Regex::EmptyNode::MatchNode(const char* str, MatchInfo& info) {
+		return next->Match(str, info);
+	}
+
+	inline const char* Regex::GroupNode::MatchNode(const char* str, MatchInfo& info) {
+		const UInt current = (UInt)info.groups.size();
+
+		if (!isHidden) {
+			info.groups.push_back(0);
+			info.groups.push_back(0);
+		}
+
+		if (const char* c = next->Match(str, info)) {
+			if (!isHidden) {
+				info.groups[current]     = (UInt)(str - info.str);
+				info.groups[current + 1] = (UInt)(info.groupStack.back() - info.str);
+				info.groupStack.pop_back();
+			}
+
+			return c;
+		}
+		else {
+			if (!isHidden) info.groups.resize(current);
+			return nullptr;
+		}
+	}
+
+	inline const char* Regex::GroupEndNode::MatchNode(const char* str, MatchInfo& info) {
+		if (const char* c = next->Match(str, info)) {
+			if (!isHidden) {
+				info.groupStack.push_back(str);
+			}
+
+			return c;
+		}
+		
+		return nullptr;
+	}
+
+	inline const char* Regex::SelectNode::MatchNode(const char* str, MatchInfo& info) {
+		if (info.Visit(this, str)) return nullptr;
+
+		const UInt groupSize   = (UInt)info.groups.size();
+		const UInt elementSize = (UInt)info.elements.size();
+
+		for (const Node& node : nodes) {
+			if (const char* c = node->Match(str, info)) {
+				return c;
+			}
+			else {
+				info.groups.resize(groupSize);
+				info.elements.resize(elementSize);
+			}
+		}
+		
+		info.Fail(this, str);
+		return nullptr;
+	}
+
+	inline const char* Regex::QuantifierNode::MatchNode(const char* str, MatchInfo& info) {
+		if (max == 0) {
+			return next->Match(str, info);
+		}
+
+		if (info.Visit(this, str)) return nullptr;
+
+		// The count is only added while matching the content so the rest of the pattern sees the counts of outer quantifiers
+		const auto matchContent = [&]() {
+			info.quantNums.push_back(0);
+			info.quantPositions.push_back(str);
+			const char* const n = content->Match(str, info);
+			info.quantNums.pop_back();
+			info.quantPositions.pop_back();
+			return n;
+		};
+
+		const char* c = nullptr;
+
+		if (many) {
+			if (min > 0) {
+				c = matchContent();
+			}
+			else {
+				c = matchContent();
+
+				if (c == nullptr) {
+					c = next->Match(str, info);
+				}
+			}
+		}
+		else {
+			if (min > 0) {
+				c = matchContent();
+			}
+			else {
+				c = next->Match(str, info);
+
+				if (c == nullptr) {
+					c = matchContent();
+				}
+			}
+		}
+
+		if (c == nullptr) info.Fail(this, str);
+		return c;
+	}
+
+	inline const char* Regex::QuantifierEndNode::MatchNode(const char* str, MatchInfo& info) {
+		if (info.Visit(this, str)) return nullptr;
+
+		const UInt count = info.quantNums.back();
+		const char* const position = info.quantPositions.back();
+
+		// An empty repetition after the min of a quantifier without a max fails the same way as the loop of the compiled program
+		if (str == position && count >= min && max == Math::UIntMax()) {
+			info.Fail(this, str);
+			return nullptr;
+		}
+
+		// Counts above the min of a quantifier without a max are all the same
+		const UInt num = max == Math::UIntMax() && count >= min ? count : count + 1;
+		info.quantNums.back() = num;
+
+		const char* c = nullptr;
+
+		// Removes the count while matching the rest so outer quantifiers see their own count
+		const auto matchNext = [&]() {
+			info.quantNums.pop_back();
+			info.quantPositions.pop_back();
+			const char* const n = next->Match(str, info);
+			info.quantNums.push_back(num);
+			info.quantPositions.push_back(position);
+			return n;
+		};
+
+		const auto matchContent = [&]() {
+			info.quantPositions.back() = str;
+			const char* const n = content->Match(str, info);
+			info.quantPositions.back() = position;
+			return n;
+		};
+
+		if (many) {
+			if (num < min) {
+				c = matchContent();
+			}
+			else if (num < max) {
+				c = matchContent();
+
+				if (c == nullptr) {
+					c = matchNext();
+				}
+			}
+			else {
+				c = matchNext();
+			}
+		}
+		else {
+			if (num < min) {
+				c = matchContent();
+			}
+			else if (num < max) {
+				c = matchNext();
+
+				if (c == nullptr) {
+					c = matchContent();
+				}
+			}
+			else {
+				c = matchNext();
+			}
+		}
+
+		info.quantNums.back() = count;
+
+		if (c == nullptr) info.Fail(this, str);
+		return c;
+	}
+
+	inline const char* Regex::PlainQuantifierNode::MatchNode(const char* str, MatchInfo& info) {
+		if (info.Visit(this, str)) return nullptr;
+
+		const char* const first = str;
+		const UInt groupSize = (UInt)info.groups.size();
+
+		// An empty repetition after the min of a quantifier without a max fails the same way as the loop of the compiled program
+		const auto isEmpty = [&](const char* const start, const char* const end, const UInt num) {
+			return end == start && num >= min && max == Math::UIntMax();
+		};
+
+		if (many) {
+			// The end of each repetition is stored after the ends of outer quantifiers
+			const UInt base = (UInt)info.quantStarts.size();
+			info.quantStarts.push_back(str);
+			info.quantGroups.push_back(groupSize);
+
+			for (UInt num = 0; num < max && str <= info.end; num++) {
+				info.Step();
+
+				const UInt current = (UInt)info.groups.size();
+
+				if (const char* c = content->Match(str, info)) {
+					if (isEmpty(str, c, num)) {
+						info.groups.resize(current);
+						break;
+					}
+
+					str = c;
+					info.quantStarts.push_back(str);
+					info.quantGroups.push_back((UInt)info.groups.size());
+				}
+				else if (num < min) {
+					info.quantStarts.resize(base);
+					info.quantGroups.resize(base);
+					info.groups.resize(groupSize);
+					info.Fail(this, first);
+					return nullptr;
+				}
+				else {
+					break;
+				}
+			}
+
+			while (info.quantStarts.size() - base > min) {
+				const char* const start = info.quantStarts.back();
+				info.groups.resize(info.quantGroups.back());
+				info.quantStarts.pop_back();
+				info.quantGroups.pop_back();
+
+				if (const char* c = next->Match(start, info)) {
+					info.quantStarts.resize(base);
+					info.quantGroups.resize(base);
+					return c;
+				}
+			}
+
+			info.quantStarts.resize(base);
+			info.quantGroups.resize(base);
+		}
+		else {
+			UInt num = 0;
+
+			for (; num < min && str; num++) {
+				info.Step();
+				str = content->Match(str, info);
+			}
+
+			for (; str && num <= max && str <= info.end; num++) {
+				info.Step();
+
+				if (const char* c = next->Match(str, info)) {
+					return c;
+				}
+				
+				if (num >= max) break;
+
+				const char* const start = str;
+				str = content->Match(str, info);
+
+				if (str && isEmpty(start, str, num)) break;
+			}
+		}
+
+		info.groups.resize(groupSize);
+		info.Fail(this, first);
+		return nullptr;
+	}
+
+	inline const char* Regex::AnyQuantifierNode::MatchNode(const char* str, MatchInfo& info) {
+		if (info.Visit(this, str)) return nullptr;
+
+		const char* const first = str;
+
+		if (many) {
+			const char* minPtr = str + min;
+			
+			if ((ULong)info.end - (ULong)str >= (ULong)max) {
+				str += max;
+			}
+			else {
+				str = info.end;
+			}
+
+			while (str >= minPtr) {
+				info.Consume(this, (UInt)(str - first));
+
+				if (const char* c = next->Match(str, info)) {
+					return c;
+				}
+
+				str--;
+			}
+		}
+		else {
+			const char* maxPtr;
+
+			if ((ULong)info.end - (ULong)str >= (ULong)max) {
+				maxPtr = str + max;
+			}
+			else {
+				maxPtr = info.end;
+			}
+
+			str += min;
+
+			while (str <= maxPtr) {
+				info.Consume(this, (UInt)(str - first));
+
+				if (const char* c = next->Match(str, info)) {
+					return c;
+				}
+
+				str++;
+			}
+		}
+
+		info.Fail(this, first);
+		return nullptr;
+	}
+
+	inline const char* Regex::ClassQuantifierNode::MatchNode(const char* str, MatchInfo& info) {
+		if (info.Visit(this, str)) return nullptr;
+
+		const char* const limit = (ULong)info.end - (ULong)str >= (ULong)max ? str + max : info.end;
+		const char* const runEnd = ByteRanges::Skip(str, limit, set, ranges);
+
+		if ((ULong)(runEnd - str) < (ULong)min) {
+			info.Fail(this, str);
+			return nullptr;
+		}
+
+		if (many) {
+			for (const char* c = runEnd;; c--) {
+				info.Consume(this, (UInt)(c - str));
+
+				if (const char* m = next->Match(c, info)) {
+					return m;
+				}
+
+				if (c == str + min) break;
+			}
+		}
+		else {
+			for (const char* c = str + min; c <= runEnd; c++) {
+				info.Consume(this, (UInt)(c - str));
+
+				if (const char* m = next->Match(c, info)) {
+					return m;
+				}
+			}
+		}
+
+		info.Fail(this, str);
+		return nullptr;
+	}
+
+	inline const char* Regex::ElementNode::MatchNode(const char* str, MatchInfo& info) {
+		info.elementStack.push_back(str);
+
+		const char* c = next->Match(str, info);
+
+		info.elementStack.pop_back();
+		return c;
+	}
+
+	inline const char* Regex::ElementEndNode::MatchNode(const char* str, MatchInfo& info) {
+		info.elements.push_back((UInt)(info.elementStack.back() - info.str));
+		info.elements.push_back((UInt)(str - info.str));
+
+		if (const char* c = next->Match(str, info)) {
+			return c;
+		}
+
+		info.elements.pop_back();
+		info.elements.pop_back();
+		return nullptr;
+	}
+
+	inline const char* Regex::ElementMatchNode::MatchNode(const char* str, MatchInfo& info) {
+		if (index * 2 >= info.elements.size()) return nullptr;
+
+		const UInt start  = info.elements[index * 2];
+		const UInt length = info.elements[index * 2 + 1] - start;
+
+		if ((UInt)(info.end - str) < length) {
+			return nullptr;
+		}
+
+		if (std::memcmp(str, info.str + start, length) != 0) {
+			return nullptr;
+		}
+
+		info.Consume(this, length);
+		return next->Match(str + length, info);
+	}
+
+	inline bool Regex::Prefilter::Skips() const {
+		return !prefix.IsEmpty() || firstCount > 0;
+	}
+
+	inline bool Regex::Prefilter::Next(const char* const str, const UInt pos, const UInt end, UInt& found) const {
+		const char* c;
+
+		if (!prefix.IsEmpty()) {
+			c = FindLiteral(str + pos, str + end, prefix);
+		}
+		else if (firstCount == 1) {
+			c = (const char*)std::memchr(str + pos, firstBytes[0], end - pos);
+		}
+		else {
+			c = FindFirst(str + pos, str + end, first, firstBytes, firstCount);
+		}
+
+		if (c == nullptr) return false;
+
+		found = (UInt)(c - str);
+		return true;
+	}
+
+	inline bool Regex::Prefilter::HasRequired(const char* const str, const UInt pos, const UInt end) const {
+		return required.IsEmpty() || FindLiteral(str + pos, str + end, required) != nullptr;
+	}
+
+	inline void Regex::Prefilter::Write(Buffer& buffer) const {
+		buffer.Write<UInt>(prefix.Length(), Endian::Little);
+		buffer.Write<String>(prefix);
+		buffer.Write<UInt>(required.Length(), Endian::Little);
+		buffer.Write<String>(required);
+
+		for (UInt i = 0; i < 4; i++) {
+			buffer.Write<ULong>(first.bits[i], Endian::Little);
+		}
+
+		buffer.WriteBytes(firstBytes, 3);
+		buffer.Write<UInt>(firstCount, Endian::Little);
+	}
+
+	inline bool Regex::Prefilter::Read(Buffer& buffer) {
+		prefix = buffer.ReadString(buffer.Read<UInt>(Endian::Little));
+		required = buffer.ReadString(buffer.Read<UInt>(Endian::Little));
+
+		for (UInt i = 0; i < 4; i++) {
+			first.bits[i] = buffer.Read<ULong>(Endian::Little);
+		}
+
+		for (UInt i = 0; i < 3; i++) {
+			firstBytes[i] = buffer.Read<UByte>();
+		}
+
+		firstCount = buffer.Read<UInt>(Endian::Little);
+		return firstCount <= 256;
+	}
+
+	inline Regex::Prefilter Regex::Prefilter::Create(RegexNode* const node) {
+		Prefilter prefilter;
+		String run;
+		bool leading = true;
+
+		// Finds the literal prefix and the longest literal that is part of all matches
+		for (RegexNode* current = node; current; current = current->next.operator->()) {
+			if (dynamic_cast<LeafNode*>(current) || dynamic_cast<QuantifierEndNode*>(current)) {
+				break;
+			}
+			else if (CharNode* const c = dynamic_cast<CharNode*>(current)) {
+				run += String(c->c);
+			}
+			else if (StringNode* const string = dynamic_cast<StringNode*>(current)) {
+				run += string->string;
+			}
+			else if (
+				!dynamic_cast<GroupNode*>(current) && !dynamic_cast<GroupEndNode*>(current) &&
+				!dynamic_cast<EmptyNode*>(current) && !dynamic_cast<StartNode*>(current) &&
+				!dynamic_cast<BoundaryNode*>(current) && !dynamic_cast<ElementNode*>(current) &&
+				!dynamic_cast<ElementEndNode*>(current)
+			) {
+				if (leading) prefilter.prefix = run;
+				if (run.Length() > prefilter.required.Length()) prefilter.required = run;
+
+				leading = false;
+				run = "";
+
+				// Continues after the end of the select node
+				if (SelectNode* const select = dynamic_cast<SelectNode*>(current)) {
+					current = select->end.operator->();
+					if (!current) break;
+				}
+			}
+		}
+
+		if (leading) prefilter.prefix = run;
+		if (run.Length() > prefilter.required.Length()) prefilter.required = run;
+
+		// The prefix is found before the required literal
+		if (prefilter.required.Length() <= prefilter.prefix.Length()) {
+			prefilter.required = "";
+		}
+
+		bool known = true;
+
+		if (prefilter.prefix.IsEmpty() && !First(node, nullptr, prefilter.first, known) && known) {
+			for (UInt c = 0; c < 256; c++) {
+				if (!prefilter.first.Contains((UByte)c)) continue;
+
+				if (prefilter.firstCount < 3) {
+					prefilter.firstBytes[prefilter.firstCount] = (UByte)c;
+				}
+
+				prefilter.firstCount++;
+			}
+
+			// Skipping is not worth it if most bytes can start a match
+			if (prefilter.firstCount > 64) {
+				prefilter.firstCount = 0;
+			}
+		}
+
+		return prefilter;
+	}
+
+	inline bool Regex::Prefilter::First(RegexNode* node, RegexNode* const stop, ByteSet& set, bool& known) {
+		while (node && node != stop && known) {
+			if (dynamic_cast<LeafNode*>(node) || dynamic_cast<QuantifierEndNode*>(node)) {
+				break;
+			}
+			else if (SelectNode* const select = dynamic_cast<SelectNode*>(node)) {
+				bool empty = false;
+
+				for (const Node& branch : select->nodes) {
+					if (First(branch.operator->(), select->end.operator->(), set, known)) empty = true;
+				}
+
+				if (!empty) return false;
+				node = select->end.operator->();
+				continue;
+			}
+			else if (QuantifierNode* const quantifier = dynamic_cast<QuantifierNode*>(node)) {
+				if (quantifier->max > 0 && !First(quantifier->content.operator->(), nullptr, set, known) && quantifier->min > 0) return false;
+			}
+			else if (PlainQuantifierNode* const quantifier = dynamic_cast<PlainQuantifierNode*>(node)) {
+				if (quantifier->max > 0 && !First(quantifier->content.operator->(), nullptr, set, known) && quantifier->min > 0) return false;
+			}
+			else if (AnyQuantifierNode* const quantifier = dynamic_cast<AnyQuantifierNode*>(node)) {
+				if (quantifier->max > 0) {
+					known = false;
+				}
+			}
+			else if (ClassQuantifierNode* const quantifier = dynamic_cast<ClassQuantifierNode*>(node)) {
+				if (quantifier->max > 0) {
+					for (UInt i = 0; i < 4; i++) {
+						set.bits[i] |= quantifier->set.bits[i];
+					}
+
+					if (quantifier->min > 0) return false;
+				}
+			}
+			else if (StringNode* const string = dynamic_cast<StringNode*>(node)) {
+				// Empty literal strings do not match a character
+				if (string->string.Length() > 0) {
+					set.Add((UByte)string->string[0]);
+					return false;
+				}
+			}
+			else if (dynamic_cast<LineBreakNode*>(node)) {
+				set.Add('\r');
+				set.Add('\n');
+				return false;
+			}
+			else if (dynamic_cast<ElementMatchNode*>(node)) {
+				known = false;
+			}
+			else if (
+				!dynamic_cast<GroupNode*>(node) && !dynamic_cast<GroupEndNode*>(node) &&
+				!dynamic_cast<EmptyNode*>(node) && !dynamic_cast<RootNode*>(node) &&
+				!dynamic_cast<StartNode*>(node) && !dynamic_cast<EndNode*>(node) &&
+				!dynamic_cast<BoundaryNode*>(node) && !dynamic_cast<ElementNode*>(node) &&
+				!dynamic_cast<ElementEndNode*>(node)
+			) {
+				if (!Compiler::SetOf(node, set)) known = false;
+				return false;
+			}
+
+			node = node->next.operator->();
+		}
+
+		return true;
+	}
+
+	inline const char* Regex::Prefilter::FindLiteral(const char* begin, const char* const end, const String& literal) {
+		const UInt length = literal.Length();
+		const char* const chars = (const char*)literal;
+
+		while ((UInt)(end - begin) >= length) {
+			const char* const c = (const char*)std::memchr(begin, chars[0], (end - begin) - length + 1);
+			if (c == nullptr) return nullptr;
+
+			if (std::memcmp(c + 1, chars + 1, length - 1) == 0) return c;
+			begin = c + 1;
+		}
+
+		return nullptr;
+	}
+
+	inline const char* Regex::Prefilter::FindFirst(const char* begin, const char* const end, const ByteSet& set, const UByte* const bytes, const UInt count) {
+		#ifdef _BOXX_REGEX_SSE2
+		// Compares 16 bytes at a time if there are at most 3 bytes to find
+		if (count <= 3) {
+			const __m128i a = _mm_set1_epi8((char)bytes[0]);
+			const __m128i b = _mm_set1_epi8((char)bytes[count > 1 ? 1 : 0]);
+			const __m128i c = _mm_set1_epi8((char)bytes[count > 2 ? 2 : 0]);
+
+			while (end - begin >= 16) {
+				const __m128i block = _mm_loadu_si128((const __m128i*)begin);
+				const __m128i found = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(block, a), _mm_cmpeq_epi8(block, b)), _mm_cmpeq_epi8(block, c));
+				const UInt mask = (UInt)_mm_movemask_epi8(found);
+
+				if (mask != 0) {
+					#ifdef _MSC_VER
+					unsigned long index;
+					_BitScanForward(&index, mask);
+					return begin + index;
+					#else
+					return begin + __builtin_ctz(mask);
+					#endif
+				}
+
+				begin += 16;
+			}
+		}
+		#endif
+
+		for (; begin < end; begin++) {
+			if (set.Contains((UByte)*begin)) return begin;
+		}
+
+		return nullptr;
+	}
+
+	inline Regex::ByteRanges Regex::ByteRanges::Create(const ByteSet& set) {
+		ByteRanges ranges;
+
+		for (UInt c = 0; c < 256;) {
+			if (!set.Contains((UByte)c)) {
+				c++;
+				continue;
+			}
+
+			// Sets with too many ranges are scanned one byte at a time
+			if (ranges.count == 4) {
+				ranges.count = 0;
+				return ranges;
+			}
+
+			const UInt first = c;
+			while (c < 256 && set.Contains((UByte)c)) c++;
+
+			ranges.low[ranges.count]  = (UByte)first;
+			ranges.size[ranges.count] = (UByte)(c - 1 - first);
+			ranges.count++;
+		}
+
+		// Unused ranges repeat the first range
+		for (UInt i = ranges.count; i > 0 && i < 4; i++) {
+			ranges.low[i]  = ranges.low[0];
+			ranges.size[i] = ranges.size[0];
+		}
+
+		return ranges;
+	}
+
+	inline const char* Regex::ByteRanges::Skip(const char* begin, const char* const end, const ByteSet& set, const ByteRanges& ranges) {
+		#ifdef _BOXX_REGEX_SSE2
+		// Tests 16 bytes at a time against each range
+		if (ranges.count > 0) {
+			__m128i low[4], size[4];
+
+			for (UInt i = 0; i < 4; i++) {
+				low[i]  = _mm_set1_epi8((char)ranges.low[i]);
+				size[i] = _mm_set1_epi8((char)ranges.size[i]);
+			}
+
+			while (end - begin >= 16) {
+				const __m128i block = _mm_loadu_si128((const __m128i*)begin);
+				__m128i inside = _mm_setzero_si128();
+
+				for (UInt i = 0; i < 4; i++) {
+					// A byte is in a range if its distance from the low byte is at most the size of the range
+					const __m128i offset = _mm_sub_epi8(block, low[i]);
+					inside = _mm_or_si128(inside, _mm_cmpeq_epi8(_mm_min_epu8(offset, size[i]), offset));
+				}
+
+				const UInt mask = ~(UInt)_mm_movemask_epi8(inside) & 0xFFFF;
+
+				if (mask != 0) {
+					#ifdef _MSC_VER
+					unsigned long index;
+					_BitScanForward(&index, mask);
+					return begin + index;
+					#else
+					return begin + __builtin_ctz(mask);
+					#endif
+				}
+
+				begin += 16;
+			}
+		}
+		#endif
+
+		while (begin < end && set.Contains((UByte)*begin)) {
+			begin++;
+		}
+
+		return begin;
+	}
+
+	inline bool Regex::Find(const char* const str, const UInt length, const UInt pos, MatchInfo& info, Searcher* const searcher, const bool start) const {
+		info.profile = profiler != nullptr;
+		if (!info.profile) return FindMatch(str, length, pos, info, searcher, start);
+
+		info.counts.assign(profiler->profile.nodes.Count(), NodeCounts());
+		info.steps = 0;
+		info.backtracked = false;
+
+		bool found;
+
+		try {
+			found = FindMatch(str, length, pos, info, searcher, start);
+		}
+		catch (const RegexStepError&) {
+			profiler->Add(info, false, true);
+			throw;
+		}
+
+		profiler->Add(info, found, false);
+		return found;
+	}
+
+	inline bool Regex::FindMatch(const char* const str, const UInt length, const UInt pos, MatchInfo& info, Searcher* const searcher, const bool start) const {
+		info.str   = str;
+		info.start = str + pos;
+		info.end   = str + length;
+		info.matchStart = pos;
+		info.matchEnd   = pos;
+		info.Clear();
+
+		if (pos > length) return false;
+
+		if (engine) {
+			Int matchStart, matchEnd;
+
+			if (searcher) {
+				engine->Search(*searcher, str, pos, length, start, matchStart, matchEnd);
+			}
+			else {
+				engine->Search(str, pos, length, matchStart, matchEnd);
+			}
+
+			if (matchStart < 0) return false;
+
+			info.matchStart = (UInt)matchStart;
+			info.matchEnd   = (UInt)matchEnd;
+
+			if (!engine->groups) return true;
+
+			// Groups are captured by running the instructions from the start of the match
+			if (engine->forward.Capture(str, start ? pos : 0, info.matchStart, length, info.matchEnd, info)) return true;
+
+			info.matchStart = pos;
+			info.Clear();
+		}
+
+		info.steps = 0;
+		info.stepLimit = stepLimit;
+		info.memoize = memoize;
+		info.failed.clear();
+		info.backtracked = true;
+
+		return root != nullptr && root->Match(info.start, info) != nullptr;
+	}
+
+	inline void Regex::Cache::Trim() {
+		while (entries.size() > capacity) {
+			lookup.erase(entries.back().first);
+			entries.pop_back();
+		}
+	}
+
+	inline Regex::Cache& Regex::GetCache() {
+		static Cache cache;
+		return cache;
+	}
+
+	inline std::shared_ptr<const Regex> Regex::Cached(const String& pattern) {
+		Cache& cache = GetCache();
+		const std::string key = std::string((const char*)pattern, pattern.Length());
+
+		{
+			std::lock_guard<std::mutex> lock(cache.mutex);
+			const auto found = cache.lookup.find(key);
+
+			if (found != cache.lookup.end()) {
+				cache.hits++;
+				cache.entries.splice(cache.entries.begin(), cache.entries, found->second);
+				return found->second->second;
+			}
+
+			cache.misses++;
+		}
+
+		// The pattern is compiled without locking the cache
+		std::shared_ptr<const Regex> regex = std::make_shared<const Regex>(pattern);
+
+		std::lock_guard<std::mutex> lock(cache.mutex);
+		if (cache.capacity == 0 || cache.lookup.find(key) != cache.lookup.end()) return regex;
+
+		cache.entries.emplace_front(key, regex);
+		cache.lookup[key] = cache.entries.begin();
+		cache.Trim();
+		return regex;
+	}
+
+	inline Match Regex::CreateMatch(const MatchInfo& info) {
+		Boxx::Match match;
+		match.index   = info.matchStart;
+		match.length  = info.matchEnd - info.matchStart;
+		match.groups  = List<String>((UInt)info.groups.size() / 2);
+
+		for (UInt i = 0; i < info.groups.size(); i += 2) {
+			match.groups.Add(String(info.str + info.groups[i], info.groups[i + 1] - info.groups[i]));
+		}
+
+		if (match.length > 0) {
+			match.match = String(info.str + info.matchStart, match.length);
+		}
+		else {
+			match.match = "";
+		}
+
+		return match;
+	}
+
+	inline void Regex::Profiler::Add(const MatchInfo& info, const bool found, const bool limited) {
+		std::lock_guard<std::mutex> lock(mutex);
+
+		profile.matches++;
+		if (found) profile.found++;
+		if (limited) profile.limited++;
+
+		if (info.backtracked) {
+			profile.backtracked++;
+			profile.steps += info.steps;
+			if (info.steps > profile.maxSteps) profile.maxSteps = info.steps;
+		}
+
+		for (UInt i = 0; i < info.counts.size(); i++) {
+			RegexNodeProfile& node = profile.nodes[i];
+			node.entered     += info.counts[i].entered;
+			node.backtracked += info.counts[i].backtracked;
+			node.consumed    += info.counts[i].consumed;
+		}
+	}
+
+	inline void Regex::MatchInfo::Clear() {
+		groups.clear();
+		groupStack.clear();
+		quantNums.clear();
+		quantStarts.clear();
+		quantGroups.clear();
+		quantPositions.clear();
+		elements.clear();
+		elementStack.clear();
+	}
+
+	inline void Regex::MatchInfo::Step() {
+		if (++steps > stepLimit && stepLimit > 0) {
+			throw RegexStepError("The match reached the step limit");
+		}
+	}
+
+	inline bool Regex::MatchInfo::Visit(const RegexNode* const node, const char* const str) {
+		Step();
+
+		if (!memoize) return false;
+
+		Key(node, str);
+		return failed.find(key) != failed.end();
+	}
+
+	inline void Regex::MatchInfo::Fail(const RegexNode* const node, const char* const str) {
+		if (!memoize) return;
+
+		Key(node, str);
+		failed.insert(key);
+	}
+
+	inline void Regex::MatchInfo::Consume(const RegexNode* const node, const UInt count) {
+		if (profile && node->id != Math::UIntMax()) {
+			counts[node->id].consumed += count;
+		}
+	}
+
+	inline void Regex::MatchInfo::Key(const RegexNode* const node, const char* const str) {
+		const UInt pos = (UInt)(str - this->str);
+		const UInt quantCount = (UInt)quantNums.size();
+		const UInt elementCount = (UInt)elements.size();
+
+		key.clear();
+		key.append((const char*)&node, sizeof(node));
+		key.append((const char*)&pos, sizeof(pos));
+		key.append((const char*)&quantCount, sizeof(quantCount));
+		key.append((const char*)quantNums.data(), quantCount * sizeof(UInt));
+
+		// A repetition that started at the position can still be empty
+		for (const char* const position : quantPositions) {
+			key.push_back(position == str ? 1 : 0);
+		}
+
+		key.append((const char*)elements.data(), elementCount * sizeof(UInt));
+	}
+
+	inline MatchContext::MatchContext() {
+
+	}
+
+	inline bool MatchContext::IsMatch() const {
+		return matched;
+	}
+
+	inline UInt MatchContext::Index() const {
+		return info.matchStart;
+	}
+
+	inline UInt MatchContext::Length() const {
+		return info.matchEnd - info.matchStart;
+	}
+
+	inline UInt MatchContext::GroupCount() const {
+		return (UInt)info.groups.size() / 2;
+	}
+
+	inline UInt MatchContext::GroupIndex(const UInt group) const {
+		return info.groups[group * 2];
+	}
+
+	inline UInt MatchContext::GroupLength(const UInt group) const {
+		return info.groups[group * 2 + 1] - info.groups[group * 2];
+	}
+
+	inline StringView MatchContext::GroupView(const UInt group) const {
+		return StringView(info.str + GroupIndex(group), GroupLength(group));
+	}
+
+	inline String MatchContext::Group(const UInt group) const {
+		return String(info.str + GroupIndex(group), GroupLength(group));
+	}
+
+	inline Match MatchContext::ToMatch() const {
+		return Regex::CreateMatch(info);
+	}
+
+	inline RegexSet::RegexSet() {
+		engine = Compile(patterns);
+	}
+
+	inline RegexSet::RegexSet(const List<String>& patterns) {
+		try {
+			this->patterns = List<Regex>(patterns.Count());
+
+			for (const String& pattern : patterns) {
+				this->patterns.Add(Regex(pattern));
+			}
+
+			engine = Compile(this->patterns);
+		}
+		catch (RegexPatternError e) {
 			throw e;
 		}
 	}
 
-	inline String Regex::Escape(const String& str) {
-		List<char> chars{str.Length()};
+	inline RegexSet::RegexSet(const List<Regex>& patterns) {
+		this->patterns = patterns.Copy();
+		engine = Compile(this->patterns);
+	}
+
+	inline RegexSet::RegexSet(const RegexSet& set) {
+		patterns = set.patterns;
+		engine = set.engine;
+	}
+
+	inline RegexSet::RegexSet(RegexSet&& set) noexcept {
+		patterns = std::move(set.patterns);
+		engine = std::move(set.engine);
+	}
+
+	inline RegexSet::~RegexSet() {
+
+	}
+
+	inline Optional<RegexSetMatch> RegexSet::MatchAt(const String& str, const UInt pos, const RegexSetPolicy policy) const {
+		MatchContext context;
+		RegexSetMatch match;
+
+		if (MatchAt(str, context, match.pattern, pos, policy)) {
+			match.match = context.ToMatch();
+			return match;
+		}
+		else {
+			return nullptr;
+		}
+	}
+
+	inline bool RegexSet::MatchAt(const StringView& str, MatchContext& context, UInt& pattern, const UInt pos, const RegexSetPolicy policy) const {
+		return MatchAt(str, context, pattern, pos, policy, nullptr);
+	}
+
+	inline bool RegexSet::MatchAt(const StringView& str, MatchContext& context, UInt& pattern, const UInt pos, const RegexSetPolicy policy, Scanner* const scanner) const {
+		const bool first = policy == RegexSetPolicy::First;
+		UInt best = patterns.Count();
+		Int bestEnd = -1;
+
+		context.matched = false;
+		if (pos > str.Length()) return false;
+
+		const auto choose = [&](const std::vector<Int>& ends) {
+			for (UInt i = 0; i < ends.size(); i++) {
+				if (ends[i] > bestEnd) {
+					best = i;
+					bestEnd = ends[i];
+					if (first) break;
+				}
+			}
+		};
+
+		// A scanner is only used by one thread and does not have to be locked
+		if (scanner && scanner->anchored) {
+			std::fill(scanner->ends.begin(), scanner->ends.end(), -1);
+			scanner->anchored->Scan(str.Data(), pos, str.Length(), first, scanner->ends);
+			choose(scanner->ends);
+		}
+		else if (engine->anchoredDFA) {
+			std::lock_guard<std::mutex> lock(engine->mutex);
+			std::fill(engine->ends.begin(), engine->ends.end(), -1);
+			engine->anchoredDFA->Scan(str.Data(), pos, str.Length(), first, engine->ends);
+			choose(engine->ends);
+		}
+
+		// Tries the patterns that are not part of the DFA
+		for (UInt i = 0; i < patterns.Count(); i++) {
+			if (engine->compiled[i]) continue;
+			if (first && i > best) break;
+
+			if (Backtrack(i, str.Data(), str.Length(), pos, context.info)) {
+				const Int end = (Int)context.info.matchEnd;
+
+				if (first || end > bestEnd || (end == bestEnd && i < best)) {
+					best = i;
+					bestEnd = end;
+					if (first) break;
+				}
+			}
+		}
+
+		if (bestEnd < 0) return false;
+
+		pattern = best;
+		context.matched = true;
+
+		// Patterns that are not part of the DFA capture their groups by backtracking
+		if (!engine->compiled[best]) {
+			return Backtrack(best, str.Data(), str.Length(), pos, context.info);
+		}
+
+		Regex::MatchInfo& info = context.info;
+		info.str   = str.Data();
+		info.start = str.Data() + pos;
+		info.end   = str.Data() + str.Length();
+		info.matchStart = pos;
+		info.matchEnd   = (UInt)bestEnd;
+		info.Clear();
+
+		if (engine->groups[best]) {
+			patterns[best].engine->forward.Capture(info.str, pos, pos, str.Length(), (UInt)bestEnd, info);
+		}
+
+		return true;
+	}
+
+	inline List<UInt> RegexSet::Matches(const String& str, const UInt pos) const {
+		List<UInt> matches;
+		if (pos > str.Length()) return matches;
+
+		std::vector<bool> matched = std::vector<bool>(patterns.Count(), false);
+
+		if (engine->searchDFA) {
+			std::lock_guard<std::mutex> lock(engine->mutex);
+			std::fill(engine->ends.begin(), engine->ends.end(), -1);
+			engine->searchDFA->Scan((const char*)str, pos, str.Length(), false, engine->ends);
+
+			for (UInt i = 0; i < engine->ends.size(); i++) {
+				matched[i] = engine->ends[i] >= 0;
+			}
+		}
+
+		MatchContext context;
+
+		for (UInt i = 0; i < patterns.Count(); i++) {
+			if (!engine->searchDFA || !engine->compiled[i]) {
+				matched[i] = patterns[i].root != nullptr && patterns[i].Match(str, context, pos);
+			}
+
+			if (matched[i]) {
+				matches.Add(i);
+			}
+		}
+
+		return matches;
+	}
+
+	inline UInt RegexSet::Count() const {
+		return patterns.Count();
+	}
+
+	inline const Regex& RegexSet::operator[](const UInt index) const {
+		return patterns[index];
+	}
+
+	inline void RegexSet::operator=(const RegexSet& set) {
+		patterns = set.patterns;
+		engine = set.engine;
+	}
+
+	inline void RegexSet::operator=(RegexSet&& set) noexcept {
+		patterns = std::move(set.patterns);
+		engine = std::move(set.engine);
+	}
+
+	inline bool RegexSet::Backtrack(const UInt index, const char* const str, const UInt length, const UInt pos, Regex::MatchInfo& info) const {
+		info.str   = str;
+		info.start = str + pos;
+		info.end   = str + length;
+		info.matchStart = pos;
+		info.matchEnd   = pos;
+		info.Clear();
+
+		return patterns[index].root != nullptr && patterns[index].root->next->Match(info.start, info) != nullptr;
+	}
+
+	inline RegexSet::Scanner::Scanner(const Engine& engine) {
+		if (engine.anchoredDFA) {
+			anchored = new Regex::DFA(engine.anchored, false);
+		}
+
+		ends = std::vector<Int>(engine.ends.size(), -1);
+	}
+
+	inline Pointer<RegexSet::Engine> RegexSet::Compile(const List<Regex>& patterns) {
+		Pointer<Engine> engine = new Engine();
+		engine->compiled = std::vector<bool>(patterns.Count(), false);
+		engine->groups = std::vector<bool>(patterns.Count(), false);
+		engine->ends = std::vector<Int>(patterns.Count(), -1);
+
+		Regex::Program& anchored = engine->anchored;
+		anchored.patterns = patterns.Count();
+		std::vector<UInt> mains;
+
+		// Copies the compiled instructions of each pattern
+		for (UInt i = 0; i < patterns.Count(); i++) {
+			if (patterns[i].engine == nullptr) continue;
+
+			const Regex::Program& program = patterns[i].engine->forward;
+			const UInt offset = (UInt)anchored.insts.size();
+			std::vector<UInt> sets;
+
+			for (const Regex::ByteSet& set : program.sets) {
+				sets.push_back(anchored.AddSet(set));
+			}
+
+			for (Regex::Program::Inst inst : program.insts) {
+				inst.out += offset;
+
+				if (inst.op == Regex::Program::Op::Split) {
+					inst.arg += offset;
+				}
+				else if (inst.op == Regex::Program::Op::Class) {
+					inst.arg = sets[inst.arg];
+				}
+				else if (inst.op == Regex::Program::Op::Match) {
+					inst.arg = i;
+				}
+
+				anchored.insts.push_back(inst);
+			}
+
+			anchored.owners.resize(anchored.insts.size(), i);
+			engine->compiled[i] = true;
+			engine->groups[i] = patterns[i].engine->groups;
+			mains.push_back(program.main + offset);
+		}
+
+		if (mains.empty()) {
+			return engine;
+		}
+
+		// Tries the patterns in order
+		anchored.start = mains.back();
+
+		for (UInt i = (UInt)mains.size() - 1; i-- > 0;) {
+			anchored.start = anchored.Emit(Regex::Program::Op::Split, mains[i], anchored.start);
+		}
+
+		anchored.main = anchored.start;
+		anchored.owners.resize(anchored.insts.size(), anchored.patterns);
+
+		// Starts a new thread at each position except the end of the string
+		Regex::Program& search = engine->search;
+		search = anchored;
+
+		Regex::ByteSet any;
+		any.bits[0] = any.bits[1] = any.bits[2] = any.bits[3] = ~0ULL;
+
+		const UInt loop = search.Emit(Regex::Program::Op::Split, anchored.start);
+		const UInt notEnd = search.Emit(Regex::Program::Op::Assert, loop, 0, Regex::Program::Assert::NotEnd);
+		search.insts[loop].arg = search.Emit(Regex::Program::Op::Class, notEnd, search.AddSet(any));
+		search.start = loop;
+		search.owners.resize(search.insts.size(), search.patterns);
+
+		anchored.Finish();
+		search.Finish();
+
+		engine->anchoredDFA = new Regex::DFA(anchored, false);
+		engine->searchDFA = new Regex::DFA(search, false);
+		return engine;
+	}
+
+	inline RegexStream::RegexStream(const Regex& regex) {
+		if (regex.engine == nullptr) throw RegexPatternError("The pattern can not be matched as a stream");
+
+		engine  = regex.engine;
+		forward = new Regex::DFA(engine->forward, false, engine->skips ? &engine->prefilter : nullptr);
+		reverse = new Regex::DFA(engine->reverse, true);
+		Restart(0);
+	}
+
+	inline RegexStream::~RegexStream() {
+
+	}
+
+	template <class F>
+	inline void RegexStream::Write(const char* const data, const UInt size, const F& output) {
+		Write(data, size, output, [](const char* const, const UInt) {});
+	}
+
+	template <class F, class T>
+	inline void RegexStream::Write(const char* const data, const UInt size, const F& output, const T& text) {
+		window.append(data, size);
+		Run(false, output, text);
+
+		if (keep > this->text) {
+			text(window.data() + this->text, keep - this->text);
+			this->text = keep;
+		}
+
+		// Removes the input that is no longer needed
+		const UInt first = keep > search ? keep - 1 : search;
+
+		if (first > 0) {
+			window.erase(0, first);
+			offset += first;
+			search  = search > first ? search - first : 0;
+			keep   -= first;
+			pos    -= first;
+			this->text -= first;
+			if (matchEnd >= 0) matchEnd -= (Int)first;
+		}
+	}
+
+	template <class F>
+	inline void RegexStream::Finish(const F& output) {
+		Finish(output, [](const char* const, const UInt) {});
+	}
+
+	template <class F, class T>
+	inline void RegexStream::Finish(const F& output, const T& text) {
+		Run(true, output, text);
+
+		if (this->text < window.size()) {
+			text(window.data() + this->text, (UInt)window.size() - this->text);
+		}
+
+		window.clear();
+		offset = 0;
+		this->text = 0;
+		stopped = false;
+		Restart(0);
+	}
+
+	inline ULong RegexStream::Position() const {
+		return offset + window.size();
+	}
+
+	inline UInt RegexStream::Pending() const {
+		return (UInt)window.size() - text;
+	}
+
+	template <class F, class T>
+	inline void RegexStream::Run(const bool last, const F& output, const T& text) {
+		const char* const str = window.data();
+		const UInt size = (UInt)window.size();
+		const Regex::Program& program = engine->forward;
+
+		while (!stopped) {
+			bool done = false;
+
+			for (; pos < size; pos++) {
+				const Int value = forward->Next(state, program.byteClass[(UByte)str[pos]]);
+
+				if (value & 1) matchEnd = (Int)pos;
+
+				if (value & 2) {
+					done = true;
+					break;
+				}
+
+				// The bytes before the next byte can not be part of a match
+				if ((value & 8) && matchEnd < 0) {
+					keep = pos + 1;
+
+					// Skips to the next position where a match can start
+					if (value & 4) {
+						const Regex::Prefilter& prefilter = engine->prefilter;
+						UInt next;
+
+						// The start of the prefix can be at the end of the input
+						if (!prefilter.Next(str, pos + 1, size, next)) {
+							const UInt tail = prefilter.prefix.IsEmpty() ? 0 : prefilter.prefix.Length() - 1;
+							next = size - pos - 1 > tail ? size - tail : pos + 1;
+						}
+
+						if (next > pos + 1) {
+							keep  = next;
+							state = forward->Start(Regex::Program::CategoryOf((UByte)str[next - 1]));
+							pos   = next - 1;
+							continue;
+						}
+					}
+				}
+
+				state = (UInt)(value >> 4);
+			}
+
+			if (!done && last) {
+				if (forward->Next(state, program.classCount) & 1) matchEnd = (Int)size;
+				done = true;
+			}
+
+			if (!done) break;
+
+			// Anchored patterns stop at the first position without a match
+			if (matchEnd < 0) {
+				stopped = true;
+				break;
+			}
+
+			const UInt end = (UInt)matchEnd;
+			UInt start = search;
+
+			// The search position or the byte before the first byte that can be part of the match
+			const UInt first = keep > search ? keep - 1 : search;
+
+			if (!program.anchored) {
+				Int matchStart;
+				reverse->Reverse(str, first, size, end, matchStart, keep == search);
+				start = (UInt)matchStart;
+			}
+
+			if (start > this->text) {
+				text(str + this->text, start - this->text);
+			}
+
+			RegexStreamMatch match;
+			match.index  = offset + start;
+			match.length = end - start;
+			match.match  = String(str + start, match.length);
+
+			if (engine->groups && program.Capture(str, first, start, size, end, info)) {
+				match.groups = List<String>((UInt)info.groups.size() / 2);
+
+				for (UInt i = 0; i < info.groups.size(); i += 2) {
+					match.groups.Add(String(str + info.groups[i], info.groups[i + 1] - info.groups[i]));
+				}
+			}
+
+			output(match);
+			this->text = end;
+
+			if (end > start) {
+				Restart(end);
+			}
+			else if (end < size) {
+				Restart(end + 1);
+			}
+			else {
+				Restart(end);
+				stopped = true;
+			}
+		}
+
+		// The input after a failed anchored search is not part of a match
+		if (stopped && this->text < size && !last) {
+			text(str + this->text, size - this->text);
+			this->text = size;
+			Restart(size);
+		}
+	}
+
+	inline void RegexStream::Restart(const UInt start) {
+		search = keep = pos = start;
+		state = forward->Start(Regex::Program::Category::None);
+		matchEnd = -1;
+	}
 
-		for (const char c : str) {
-			if (MetaChar::IsMetaChar(c)) {
-				chars.Add(MetaChar::escape);
-				chars.Add(c);
+	inline Pointer<Regex::Engine> Regex::Compile(const Node& root) {
+		if (root == nullptr) return nullptr;
+
+		Pointer<Engine> engine = new Engine();
+		RegexNode* const first = root->next.operator->();
+
+		Compiler forward = Compiler(engine->forward, false);
+		const UInt match = forward.Emit(Program::Op::Match);
+		const UInt main = forward.Chain(first, nullptr, match);
+
+		engine->forward.main = main;
+
+		if (root.Cast<RootNode>()->anchored) {
+			engine->forward.start = main;
+			engine->forward.anchored = true;
+		}
+		else {
+			// Starts a new thread at each position except the end of the string
+			ByteSet any;
+			any.bits[0] = any.bits[1] = any.bits[2] = any.bits[3] = ~0ULL;
+
+			const UInt loop = forward.Emit(Program::Op::Split);
+			const UInt notEnd = forward.Emit(Program::Op::Assert, loop, 0, Program::Assert::NotEnd);
+			const UInt skip = forward.EmitSet(any, notEnd);
+
+			engine->forward.insts[loop].out = main;
+			engine->forward.insts[loop].arg = skip;
+			engine->forward.start = loop;
+		}
+
+		Compiler reverse = Compiler(engine->reverse, true);
+		engine->reverse.start = reverse.Chain(first, nullptr, reverse.Emit(Program::Op::Match));
+		engine->reverse.main = engine->reverse.start;
+
+		if (!forward.supported || !reverse.supported) return nullptr;
+
+		engine->groups = forward.groups;
+
+		if (!engine->forward.anchored) {
+			engine->prefilter = root.Cast<RootNode>()->prefilter;
+		}
+
+		engine->Finish();
+		return engine;
+	}
+
+	inline void Regex::Engine::Finish() {
+		forward.Finish();
+		reverse.Finish();
+
+		// The DFA only skips ahead if the skipping is faster than its own transitions
+		skips = !prefilter.prefix.IsEmpty() || (prefilter.firstCount > 0 && prefilter.firstCount <= 3);
+		forwardDFA = new DFA(forward, false, skips ? &prefilter : nullptr);
+		reverseDFA = new DFA(reverse, true);
+
+		Measure();
+	}
+
+	inline void Regex::Engine::Measure() {
+		const std::vector<Program::Inst>& insts = forward.insts;
+
+		// The width of each instruction or -2 if it is not visited and -3 if it is being visited
+		std::vector<Int> widths(insts.size(), -2);
+		std::vector<UInt> stack;
+		stack.push_back(forward.main);
+
+		bool bounded = true;
+		lineFeeds = false;
+		searchStart = false;
+
+		while (!stack.empty()) {
+			const UInt pc = stack.back();
+			const Program::Inst& inst = insts[pc];
+
+			if (widths[pc] >= -1) {
+				stack.pop_back();
+				continue;
 			}
-			else {
-				chars.Add(c);
+
+			const UInt outs[2] = {inst.out, inst.op == Program::Op::Split ? inst.arg : inst.out};
+			const UInt count = inst.op == Program::Op::Match ? 0 : inst.op == Program::Op::Split ? 2 : 1;
+
+			if (widths[pc] == -2) {
+				widths[pc] = -3;
+
+				if (inst.op == Program::Op::Class && forward.sets[inst.arg].Contains('\n')) {
+					lineFeeds = true;
+				}
+				else if (inst.op == Program::Op::Assert && (inst.assert == Program::Assert::Start || inst.assert == Program::Assert::Boundary)) {
+					searchStart = true;
+				}
+
+				for (UInt i = 0; i < count; i++) {
+					if (widths[outs[i]] == -2) stack.push_back(outs[i]);
+					else if (widths[outs[i]] == -3) bounded = false;
+				}
+
+				continue;
+			}
+
+			Int width = 0;
+
+			for (UInt i = 0; i < count; i++) {
+				if (widths[outs[i]] > width) width = widths[outs[i]];
 			}
+
+			widths[pc] = inst.op == Program::Op::Class ? width + 1 : width;
+			stack.pop_back();
 		}
 
-		return String(chars);
+		width = bounded ? widths[forward.main] : -1;
 	}
 
-	inline void Regex::operator=(const Regex& regex) {
-		root = regex.root;
+	inline void Regex::Program::Finish() {
+		BuildClasses();
+
+		splits = std::vector<UInt>(insts.size(), 0);
+		splitCount = 0;
+
+		for (UInt i = 0; i < insts.size(); i++) {
+			if (insts[i].op == Op::Split) splits[i] = splitCount++;
+		}
 	}
 
-	inline void Regex::operator=(Regex&& regex) noexcept {
-		root = std::move(regex.root);
+	inline bool Regex::Program::Capture(const char* const str, const UInt start, const UInt pos, const UInt end, const UInt limit, MatchInfo& info) const {
+		const ULong width = limit - pos + 1;
+
+		info.Clear();
+		info.threads.clear();
+		info.open.clear();
+		info.trail.clear();
+		info.visited.assign((size_t)((splitCount * width + 63) / 64), 0);
+
+		Thread first;
+		first.pc = main;
+		first.pos = pos;
+		first.groups = first.trail = 0;
+		info.threads.push_back(first);
+
+		while (!info.threads.empty()) {
+			const Thread thread = info.threads.back();
+			info.threads.pop_back();
+
+			// Removes the groups opened after the thread was created and reopens the groups that were closed
+			while (!info.open.empty() && info.open.back() >= thread.groups) {
+				info.open.pop_back();
+			}
+
+			while (info.trail.size() > thread.trail) {
+				if (info.trail.back() < thread.groups) info.open.push_back(info.trail.back());
+				info.trail.pop_back();
+			}
+
+			info.groups.resize(thread.groups);
+
+			UInt pc = thread.pc;
+			UInt p = thread.pos;
+			bool running = true;
+
+			while (running) {
+				const Inst& inst = insts[pc];
+
+				switch (inst.op) {
+					case Op::Class: {
+						running = p < limit && sets[inst.arg].Contains((UByte)str[p]);
+						p++;
+						break;
+					}
+
+					case Op::Split: {
+						// Each split is only tried once at each position since a second try would fail again
+						const ULong bit = splits[pc] * width + (p - pos);
+						running = ((info.visited[(size_t)(bit >> 6)] >> (bit & 63)) & 1) == 0;
+						info.visited[(size_t)(bit >> 6)] |= 1ULL << (bit & 63);
+
+						if (running) {
+							Thread next;
+							next.pc = inst.arg;
+							next.pos = p;
+							next.groups = (UInt)info.groups.size();
+							next.trail = (UInt)info.trail.size();
+							info.threads.push_back(next);
+						}
+
+						break;
+					}
+
+					case Op::Assert: {
+						const Category left  = p == start ? Category::None : CategoryOf((UByte)str[p - 1]);
+						const Category right = p == end   ? Category::None : CategoryOf((UByte)str[p]);
+						running = Check(inst.assert, left, right);
+						break;
+					}
+
+					case Op::Save: {
+						if (inst.arg == 0) {
+							info.open.push_back((UInt)info.groups.size());
+							info.groups.push_back(p);
+							info.groups.push_back(p);
+						}
+						else {
+							info.groups[info.open.back() + 1] = p;
+							info.trail.push_back(info.open.back());
+							info.open.pop_back();
+						}
+
+						break;
+					}
+
+					case Op::Match: {
+						info.matchEnd = p;
+						return true;
+					}
+				}
+
+				pc = inst.out;
+			}
+		}
+
+		info.groups.clear();
+		return false;
 	}
 
-	inline Regex::Node Regex::ParsePattern(const Pattern& pattern, UInt& index) {
-		Pointer<RootNode> root = new RootNode();
-		root->next = ParseExpression(pattern, index).value1;
+	inline void Regex::Program::Write(Buffer& buffer) const {
+		buffer.Write<UInt>(start, Endian::Little);
+		buffer.Write<UInt>(main, Endian::Little);
+		buffer.Write<UByte>(anchored ? 1 : 0);
 
-		if (index < pattern.pattern.Length()) throw RegexPatternError("Unexpected character '" + String(pattern[index]) + "'"); 
+		buffer.Write<UInt>((UInt)insts.size(), Endian::Little);
 
-		if (!root->next) root->next = new LeafNode();
+		for (const Inst& inst : insts) {
+			buffer.Write<UByte>((UByte)inst.op);
+			buffer.Write<UByte>((UByte)inst.assert);
+			buffer.Write<UInt>(inst.out, Endian::Little);
+			buffer.Write<UInt>(inst.arg, Endian::Little);
+		}
 
-		return root;
+		buffer.Write<UInt>((UInt)sets.size(), Endian::Little);
+
+		for (const ByteSet& set : sets) {
+			for (UInt i = 0; i < 4; i++) {
+				buffer.Write<ULong>(set.bits[i], Endian::Little);
+			}
+		}
 	}
 
-	inline Regex::NodeLeaf Regex::ParseExpression(const Pattern& pattern, UInt& index) {
-		List<NodeLeaf> nodes;
+	inline bool Regex::Program::Read(Buffer& buffer) {
+		start = buffer.Read<UInt>(Endian::Little);
+		main  = buffer.Read<UInt>(Endian::Little);
+		anchored = buffer.Read<UByte>() != 0;
 
-		NodeLeaf node = ParseRawExpression(pattern, index);
+		// Each instruction uses 10 bytes and each set uses 32 bytes
+		const UInt instCount = buffer.Read<UInt>(Endian::Little);
+		if (instCount == 0 || instCount > (buffer.Size() - buffer.GetPos()) / 10) return false;
 
-		while (node.value1) {
-			nodes.Add(node);
+		insts = std::vector<Inst>(instCount);
 
-			if (index >= pattern.pattern.Length() || pattern[index] != MetaChar::select) break;
+		for (Inst& inst : insts) {
+			inst.op     = (Op)buffer.Read<UByte>();
+			inst.assert = (Assert)buffer.Read<UByte>();
+			inst.out    = buffer.Read<UInt>(Endian::Little);
+			inst.arg    = buffer.Read<UInt>(Endian::Little);
+		}
+
+		const UInt setCount = buffer.Read<UInt>(Endian::Little);
+		if (setCount > (buffer.Size() - buffer.GetPos()) / 32) return false;
+
+		sets = std::vector<ByteSet>(setCount);
+
+		for (ByteSet& set : sets) {
+			for (UInt i = 0; i < 4; i++) {
+				set.bits[i] = buffer.Read<ULong>(Endian::Little);
+			}
+		}
+
+		if (start >= instCount || main >= instCount) return false;
+
+		for (const Inst& inst : insts) {
+			if (inst.op > Op::Save || inst.assert > Assert::NotLineFeed || inst.out >= instCount) return false;
+			if (inst.op == Op::Split && inst.arg >= instCount) return false;
+			if (inst.op == Op::Class && inst.arg >= setCount) return false;
+			if (inst.op == Op::Save && inst.arg > 1) return false;
+		}
+
+		return true;
+	}
+
+	inline void Regex::Program::BuildClasses() {
+		UInt count = 1;
+		UInt classes[256] = {};
+
+		static const ByteSet word = []() {
+			ByteSet set;
+
+			for (UInt c = 0; c < 256; c++) {
+				if (MetaChar::IsWord((char)c)) set.Add((UByte)c);
+			}
+
+			return set;
+		}();
+
+		ByteSet lineFeed;
+		lineFeed.Add('\n');
+
+		// Splits the classes until no set contains part of a class
+		const auto refine = [&](const ByteSet& set) {
+			Int ids[512];
+			std::fill(ids, ids + count * 2, -1);
+			UInt newCount = 0;
+
+			for (UInt c = 0; c < 256; c++) {
+				const UInt key = classes[c] * 2 + (set.Contains((UByte)c) ? 1 : 0);
+				if (ids[key] < 0) ids[key] = (Int)newCount++;
+				classes[c] = (UInt)ids[key];
+			}
+
+			count = newCount;
+		};
+
+		refine(word);
+		refine(lineFeed);
+
+		for (const ByteSet& set : sets) {
+			refine(set);
+		}
+
+		classCount = count;
+		classByte = std::vector<UByte>(count);
+
+		for (UInt c = 256; c-- > 0;) {
+			byteClass[c] = (UByte)classes[c];
+			classByte[classes[c]] = (UByte)c;
+		}
+	}
+
+	inline Regex::Program::Category Regex::Program::CategoryOf(const UByte c) {
+		if (c == '\n') return Category::LineFeed;
+		if (MetaChar::IsWord((char)c)) return Category::Word;
+		return Category::Other;
+	}
+
+	inline bool Regex::Program::Check(const Assert assert, const Category left, const Category right) {
+		switch (assert) {
+			case Assert::Start:       return left == Category::None;
+			case Assert::End:         return right == Category::None;
+			case Assert::NotEnd:      return right != Category::None;
+			case Assert::NotLineFeed: return right != Category::LineFeed;
+
+			case Assert::Boundary: {
+				return left == Category::None || right == Category::None || (left == Category::Word) != (right == Category::Word);
+			}
+		}
+
+		return false;
+	}
+
+	inline UInt Regex::Program::Emit(const Op op, const UInt out, const UInt arg, const Assert assert) {
+		Inst inst;
+		inst.op = op;
+		inst.assert = assert;
+		inst.out = out;
+		inst.arg = arg;
 
+		insts.push_back(inst);
+		return (UInt)insts.size() - 1;
+	}
+
+	inline UInt Regex::Program::AddSet(const ByteSet& set) {
+		UInt index = 0;
+
+		while (index < sets.size() && std::memcmp(sets[index].bits, set.bits, sizeof(set.bits)) != 0) {
 			index++;
-			node = ParseRawExpression(pattern, index);
 		}
 
-		if (nodes.Count() == 1) return nodes[0];
+		if (index == sets.size()) {
+			sets.push_back(set);
+		}
 
-		Pointer<EmptyNode> empty = new EmptyNode();
-		empty->next = new LeafNode();
-		Pointer<SelectNode> select = new SelectNode();
+		return index;
+	}
 
-		for (NodeLeaf& exp : nodes) {
-			exp.value2->next = empty;
-			select->nodes.Add(exp.value1);
+	inline UInt Regex::Compiler::Emit(const Program::Op op, const UInt out, const UInt arg, const Program::Assert assert) {
+		if (program.insts.size() >= maxInsts) {
+			supported = false;
+			return 0;
 		}
 
-		return NodeLeaf(select, empty);
+		return program.Emit(op, out, arg, assert);
 	}
 
-	inline Regex::NodeLeaf Regex::ParseRawExpression(const Pattern& pattern, UInt& index) {
-		Node root = nullptr;
-		Node element = nullptr;
+	inline UInt Regex::Compiler::EmitSet(const ByteSet& set, const UInt out) {
+		return Emit(Program::Op::Class, out, program.AddSet(set));
+	}
+
+	inline UInt Regex::Compiler::Chain(RegexNode* node, RegexNode* const stop, UInt cont) {
+		std::vector<RegexNode*> units;
+
+		while (node && node != stop && supported) {
+			if (dynamic_cast<LeafNode*>(node) || dynamic_cast<QuantifierEndNode*>(node)) {
+				break;
+			}
+			else if (SelectNode* const select = dynamic_cast<SelectNode*>(node)) {
+				units.push_back(node);
+				node = select->end.operator->();
+			}
+			else if (GroupNode* const group = dynamic_cast<GroupNode*>(node)) {
+				if (!group->isHidden) {
+					groups = true;
+					if (!reverse) units.push_back(node);
+				}
+
+				node = node->next.operator->();
+			}
+			else if (GroupEndNode* const groupEnd = dynamic_cast<GroupEndNode*>(node)) {
+				if (!groupEnd->isHidden && !reverse) units.push_back(node);
+				node = node->next.operator->();
+			}
+			else if (dynamic_cast<EmptyNode*>(node) || dynamic_cast<RootNode*>(node)) {
+				node = node->next.operator->();
+			}
+			else {
+				units.push_back(node);
+				node = node->next.operator->();
+			}
+		}
+
+		// The units are compiled from the end of the match to the start
+		if (reverse) {
+			for (UInt i = 0; i < units.size() && supported; i++) {
+				cont = Unit(units[i], cont);
+			}
+		}
+		else {
+			for (UInt i = (UInt)units.size(); i-- > 0 && supported;) {
+				cont = Unit(units[i], cont);
+			}
+		}
+
+		return cont;
+	}
+
+	inline UInt Regex::Compiler::Unit(RegexNode* const node, const UInt cont) {
+		if (SelectNode* const select = dynamic_cast<SelectNode*>(node)) {
+			std::vector<UInt> branches;
+
+			for (const Node& branch : select->nodes) {
+				branches.push_back(Chain(branch.operator->(), select->end.operator->(), cont));
+			}
+
+			UInt pc = branches.back();
+
+			for (UInt i = (UInt)branches.size() - 1; i-- > 0;) {
+				pc = Emit(Program::Op::Split, branches[i], pc);
+			}
+
+			return pc;
+		}
+		else if (QuantifierNode* const quantifier = dynamic_cast<QuantifierNode*>(node)) {
+			RegexNode* const content = quantifier->content.operator->();
+
+			return Repeat(quantifier->min, quantifier->max, quantifier->many, [this, content](const UInt out) {
+				return Chain(content, nullptr, out);
+			}, cont);
+		}
+		else if (PlainQuantifierNode* const quantifier = dynamic_cast<PlainQuantifierNode*>(node)) {
+			RegexNode* const content = quantifier->content.operator->();
+
+			return Repeat(quantifier->min, quantifier->max, quantifier->many, [this, content](const UInt out) {
+				return Chain(content, nullptr, out);
+			}, cont);
+		}
+		else if (AnyQuantifierNode* const quantifier = dynamic_cast<AnyQuantifierNode*>(node)) {
+			ByteSet any;
+			any.bits[0] = any.bits[1] = any.bits[2] = any.bits[3] = ~0ULL;
+
+			return Repeat(quantifier->min, quantifier->max, quantifier->many, [this, &any](const UInt out) {
+				return EmitSet(any, out);
+			}, cont);
+		}
+		else if (ClassQuantifierNode* const quantifier = dynamic_cast<ClassQuantifierNode*>(node)) {
+			const ByteSet& set = quantifier->set;
+
+			return Repeat(quantifier->min, quantifier->max, quantifier->many, [this, &set](const UInt out) {
+				return EmitSet(set, out);
+			}, cont);
+		}
+		else if (StringNode* const string = dynamic_cast<StringNode*>(node)) {
+			const UInt length = string->string.Length();
+			UInt pc = cont;
+
+			for (UInt i = 0; i < length; i++) {
+				ByteSet set;
+				set.Add((UByte)string->string[reverse ? i : length - i - 1]);
+				pc = EmitSet(set, pc);
+			}
+
+			return pc;
+		}
+		else if (dynamic_cast<LineBreakNode*>(node)) {
+			ByteSet cr, lf;
+			cr.Add('\r');
+			lf.Add('\n');
+
+			// Matches \r\n, \r without a following \n or \n
+			const UInt single = EmitSet(lf, cont);
+			UInt pair;
+
+			if (reverse) {
+				const UInt crEnd = EmitSet(cr, cont);
+				pair = Emit(Program::Op::Split, EmitSet(lf, crEnd), Emit(Program::Op::Assert, crEnd, 0, Program::Assert::NotLineFeed));
+			}
+			else {
+				const UInt after = Emit(Program::Op::Split, EmitSet(lf, cont), Emit(Program::Op::Assert, cont, 0, Program::Assert::NotLineFeed));
+				pair = EmitSet(cr, after);
+			}
+
+			return Emit(Program::Op::Split, pair, single);
+		}
+		else if (dynamic_cast<GroupNode*>(node)) {
+			return Emit(Program::Op::Save, cont, 0);
+		}
+		else if (dynamic_cast<GroupEndNode*>(node)) {
+			return Emit(Program::Op::Save, cont, 1);
+		}
+		else if (dynamic_cast<StartNode*>(node)) {
+			return Emit(Program::Op::Assert, cont, 0, Program::Assert::Start);
+		}
+		else if (dynamic_cast<EndNode*>(node)) {
+			return Emit(Program::Op::Assert, cont, 0, Program::Assert::End);
+		}
+		else if (dynamic_cast<BoundaryNode*>(node)) {
+			return Emit(Program::Op::Assert, cont, 0, Program::Assert::Boundary);
+		}
+
+		ByteSet set;
+
+		if (!SetOf(node, set)) {
+			supported = false;
+			return cont;
+		}
+
+		return EmitSet(set, cont);
+	}
+
+	inline bool Regex::Compiler::SetOf(RegexNode* const node, ByteSet& set) {
+		if (CharNode* const c = dynamic_cast<CharNode*>(node)) {
+			set.Add((UByte)c->c);
+			return true;
+		}
+		else if (StringNode* const string = dynamic_cast<StringNode*>(node)) {
+			if (string->string.Length() != 1) return false;
+			set.Add((UByte)string->string[0]);
+			return true;
+		}
+		else if (ClassNode* const chars = dynamic_cast<ClassNode*>(node)) {
+			for (UInt i = 0; i < 4; i++) {
+				set.bits[i] |= chars->set.bits[i];
+			}
+
+			return true;
+		}
+		else if (dynamic_cast<AnyNode*>(node)) {
+			set.bits[0] = set.bits[1] = set.bits[2] = set.bits[3] = ~0ULL;
+			return true;
+		}
+
+		return false;
+	}
+
+	inline bool Regex::Compiler::PrefersEmpty(const UInt loop, const UInt content) const {
+		const std::vector<Program::Inst>& insts = program.insts;
+
+		// The instructions of the content are emitted after the loop
+		const UInt size = (UInt)insts.size() - loop;
+
+		// Instructions reached from the start of a repetition without (1) and after (2) consuming a character
+		std::vector<UByte> reached(size);
+		std::vector<UInt> stack;
+		stack.push_back(content);
+		stack.push_back(1);
+
+		while (!stack.empty()) {
+			const UByte flag = (UByte)stack.back();
+			stack.pop_back();
+			const UInt pc = stack.back();
+			stack.pop_back();
+
+			if (pc <= loop || (reached[pc - loop] & flag) != 0) continue;
+			reached[pc - loop] |= flag;
+
+			const Program::Inst& inst = insts[pc];
+
+			stack.push_back(inst.out);
+			stack.push_back(inst.op == Program::Op::Class ? 2 : flag);
+
+			if (inst.op == Program::Op::Split) {
+				stack.push_back(inst.arg);
+				stack.push_back(flag);
+			}
+		}
+
+		// Instructions that can end the repetition without consuming a character and instructions that can consume one
+		std::vector<UByte> ends(size), consumes(size);
+
+		const auto endsAt   = [&](const UInt pc) {return pc == loop || (pc > loop && ends[pc - loop] != 0);};
+		const auto consumesAt = [&](const UInt pc) {return pc > loop && consumes[pc - loop] != 0;};
+
+		for (bool changed = true; changed;) {
+			changed = false;
+
+			for (UInt i = size; i-- > 1;) {
+				const Program::Inst& inst = insts[loop + i];
+				const bool split = inst.op == Program::Op::Split;
+
+				if (ends[i] == 0 && inst.op != Program::Op::Class && (endsAt(inst.out) || (split && endsAt(inst.arg)))) {
+					ends[i] = 1;
+					changed = true;
+				}
+
+				if (consumes[i] == 0 && (inst.op == Program::Op::Class || consumesAt(inst.out) || (split && consumesAt(inst.arg)))) {
+					consumes[i] = 1;
+					changed = true;
+				}
+			}
+		}
+
+		// A repetition that ends at such a split prefers ending over consuming, which the program drops in the next repetition
+		for (UInt i = 1; i < size; i++) {
+			const Program::Inst& inst = insts[loop + i];
+
+			if (inst.op == Program::Op::Split && reached[i] == 3 && endsAt(inst.out) && consumesAt(inst.arg)) {
+				return true;
+			}
+		}
 
-		NodeLeaf node = ParseElement(pattern, index);
+		return false;
+	}
 
-		while (node.value1) {
-			if (element) element->next = node.value1;
-			element = node.value2;
+	template <class F>
+	inline UInt Regex::Compiler::Repeat(const UInt min, const UInt max, const bool many, const F& body, const UInt cont) {
+		UInt pc = cont;
 
-			if (!root) root = node.value1;
+		if (max == Math::UIntMax()) {
+			const UInt loop = Emit(Program::Op::Split);
+			const UInt content = body(loop);
+			if (!supported) return cont;
 
-			node = ParseElement(pattern, index);
-		}
+			program.insts[loop].out = many ? content : cont;
+			program.insts[loop].arg = many ? cont : content;
+			pc = loop;
 
-		if (element) {
-			element->next = new LeafNode();
-			return NodeLeaf(root, element);
+			// The program drops a repetition that reaches an instruction a previous repetition reached at the same position
+			// The backtracker only drops empty repetitions, so loops where the two differ are matched by backtracking
+			if (!reverse && PrefersEmpty(loop, content)) {
+				supported = false;
+				return cont;
+			}
 		}
 		else {
-			Pointer<EmptyNode> empty = new EmptyNode();
-			return NodeLeaf(empty, empty);
+			for (UInt i = min; i < max && supported; i++) {
+				const UInt content = body(pc);
+				pc = many ? Emit(Program::Op::Split, content, cont) : Emit(Program::Op::Split, cont, content);
+			}
 		}
-	}
 
-	inline Regex::NodeLeaf Regex::ParseElement(const Pattern& pattern, UInt& index) {
-		NodeLeaf element = ParseRawElement(pattern, index);
+		for (UInt i = 0; i < min && supported; i++) {
+			pc = body(pc);
+		}
 
-		if (Optional<Tuple<UInt, UInt, bool>> quant = ParseQuantifier(pattern, index)) {
-			if (!element.value1->IsPlain()) {
-				Pointer<QuantifierNode> quantifier = new QuantifierNode();
-				quantifier->min = quant->value1;
-				quantifier->max = quant->value2;
-				quantifier->many = quant->value3;
+		return pc;
+	}
 
-				Pointer<QuantifierEndNode> qEnd = new QuantifierEndNode();
-				qEnd->min  = quantifier->min;
-				qEnd->max  = quantifier->max;
-				qEnd->many = quantifier->many;
+	#ifdef _BOXX_REGEX_STATIC
+	constexpr Regex::StaticCompiler::StaticCompiler(const char* const pattern, const UInt length) : pattern(pattern), length(length) {
+		UInt index = 0;
+		root = ParseExpression(index);
 
-				Pointer<EmptyNode> empty = new EmptyNode();
+		if (index < length) throw RegexPatternError("Unexpected character");
 
-				quantifier->next    = empty;
-				quantifier->content = element.value1;
+		const std::vector<UInt>& elements = exprs[root].front();
+		anchored = exprs[root].size() == 1 && !elements.empty() && nodes[elements.front()].kind == Kind::Start;
 
-				qEnd->next    = empty;
-				qEnd->content = element.value1;
+		Compile();
+	}
 
-				element.value2->next = qEnd;
-				element.value2 = empty;
-				element.value1 = quantifier;
-			}
-			else if (element.value1.Is<AnyNode>()) {
-				Pointer<AnyQuantifierNode> quantifier = new AnyQuantifierNode();
-				quantifier->min = quant->value1;
-				quantifier->max = quant->value2;
-				quantifier->many = quant->value3;
+	constexpr Regex::StaticSizes Regex::StaticCompiler::Sizes() const {
+		StaticSizes sizes;
+		sizes.forwardInsts = (UInt)forwardCode.insts.size();
+		sizes.forwardSets  = (UInt)forwardCode.sets.size();
+		sizes.reverseInsts = (UInt)reverseCode.insts.size();
+		sizes.reverseSets  = (UInt)reverseCode.sets.size();
+		sizes.prefix   = (UInt)prefix.size();
+		sizes.required = (UInt)required.size();
+		return sizes;
+	}
 
-				element.value1 = quantifier;
-				element.value2 = quantifier;
-			}
-			else {
-				Pointer<PlainQuantifierNode> quantifier = new PlainQuantifierNode();
-				quantifier->min = quant->value1;
-				quantifier->max = quant->value2;
-				quantifier->many = quant->value3;
+	template <Regex::StaticSizes sizes>
+	constexpr Regex::StaticEngine<sizes> Regex::StaticCompiler::Table() const {
+		StaticEngine<sizes> engine;
+		std::copy(forwardCode.insts.begin(), forwardCode.insts.end(), engine.forwardInsts.begin());
+		std::copy(forwardCode.sets.begin(),  forwardCode.sets.end(),  engine.forwardSets.begin());
+		std::copy(reverseCode.insts.begin(), reverseCode.insts.end(), engine.reverseInsts.begin());
+		std::copy(reverseCode.sets.begin(),  reverseCode.sets.end(),  engine.reverseSets.begin());
+
+		engine.forwardStart = forwardStart;
+		engine.forwardMain  = forwardMain;
+		engine.reverseStart = reverseStart;
+		engine.anchored = anchored;
+		engine.groups = groups;
+
+		std::copy(prefix.begin(), prefix.end(), engine.prefix.begin());
+		std::copy(required.begin(), required.end(), engine.required.begin());
+		engine.first = first;
+		engine.firstCount = firstCount;
+
+		for (UInt i = 0; i < 3; i++) {
+			engine.firstBytes[i] = firstBytes[i];
+		}
 
-				quantifier->content = element.value1;
-				element.value2->next = new LeafNode();
+		return engine;
+	}
 
-				element.value1 = quantifier;
-				element.value2 = quantifier;
-			}
-		}
+	constexpr char Regex::StaticCompiler::At(const UInt index) const {
+		if (index >= length) throw RegexPatternError("Unexpected end of pattern");
+		return pattern[index];
+	}
 
-		return element;
+	constexpr UInt Regex::StaticCompiler::Add(const Node& node) {
+		nodes.push_back(node);
+		return (UInt)nodes.size() - 1;
 	}
 
-	inline Regex::NodeLeaf Regex::ParseElementMatch(const Pattern& pattern, UInt& index) {
-		if (index >= pattern.pattern.Length() || pattern[index] != MetaChar::element) {
-			return NodeLeaf(nullptr, nullptr);
+	constexpr UInt Regex::StaticCompiler::ParseExpression(UInt& index) {
+		std::vector<std::vector<UInt>> alternatives;
+		alternatives.push_back(ParseRawExpression(index));
+
+		while (index < length && pattern[index] == MetaChar::select) {
+			index++;
+			alternatives.push_back(ParseRawExpression(index));
 		}
 
-		index++;
+		exprs.push_back(alternatives);
+		return (UInt)exprs.size() - 1;
+	}
 
-		NodeLeaf node = ParseRawElement(pattern, index);
+	constexpr std::vector<UInt> Regex::StaticCompiler::ParseRawExpression(UInt& index) {
+		std::vector<UInt> elements;
 
-		if (node.value1 == nullptr) {
-			throw RegexPatternError("Element expected after '" + String(MetaChar::element) + "'");
+		for (UInt node = ParseElement(index); node != none; node = ParseElement(index)) {
+			elements.push_back(node);
 		}
 
-		Pointer<ElementNode> element = new ElementNode();
-		element->next = node.value1;
+		return elements;
+	}
 
-		Pointer<ElementEndNode> elementEnd = new ElementEndNode();
-		node.value2->next = elementEnd;
+	constexpr UInt Regex::StaticCompiler::ParseElement(UInt& index) {
+		const UInt element = ParseRawElement(index);
+		if (element == none) return none;
 
-		return NodeLeaf(element, elementEnd);
+		Node quantifier;
+		quantifier.kind = Kind::Quantifier;
+		quantifier.index = element;
+
+		if (!ParseQuantifier(index, quantifier.min, quantifier.max, quantifier.many)) return element;
+		return Add(quantifier);
 	}
 
-	inline Regex::NodeLeaf Regex::ParseLiteralString(const Pattern& pattern, UInt& index) {
-		if (index >= pattern.pattern.Length() || pattern[index] != MetaChar::quote) {
-			return NodeLeaf(nullptr, nullptr);
-		}
+	constexpr UInt Regex::StaticCompiler::ParseLiteralString(UInt& index) {
+		if (index >= length || pattern[index] != MetaChar::quote) return none;
 
 		index++;
 
-		UInt ind = index;
-
-		List<char> str;
+		Node string;
+		string.kind = Kind::String;
+		string.index = (UInt)chars.size();
 
-		while (ind < pattern.pattern.Length()) {
-			if (pattern[ind] == MetaChar::quote) {
-				if (ind + 1 < pattern.pattern.Length() && pattern[ind + 1] == MetaChar::quote) {
-					ind += 2;
-					str.Add(MetaChar::quote);
+		for (UInt i = index; i < length; i++) {
+			if (pattern[i] == MetaChar::quote) {
+				if (i + 1 < length && pattern[i + 1] == MetaChar::quote) {
+					chars.push_back(MetaChar::quote);
+					string.length++;
+					i++;
 					continue;
 				}
 
-				index = ind + 1;
-				Pointer<StringNode> strNode = new StringNode();
-				strNode->string = String(str);
-				return NodeLeaf(strNode, strNode);
+				index = i + 1;
+				return Add(string);
 			}
 
-			str.Add(pattern[ind]);
-			ind++;
+			chars.push_back(pattern[i]);
+			string.length++;
 		}
 
 		throw RegexPatternError("Literal string must be closed");
 	}
 
-	inline Regex::NodeLeaf Regex::ParseRawElement(const Pattern& pattern, UInt& index) {
-		if (Node range = ParseRange(pattern, index)) {
-			return NodeLeaf(range, range);
-		}
-		else if (Node str = ParseString(pattern, index)) {
-			return NodeLeaf(str, str);
-		}
-		else if (Optional<char> c = ParseChar(pattern, index)) {
-			Pointer<StringNode> node = new StringNode();
-			node->string = String(*c);
-			return NodeLeaf(node, node);
-		}
+	constexpr UInt Regex::StaticCompiler::ParseRawElement(UInt& index) {
+		UInt node = ParseRange(index);
+		if (node != none) return node;
 
-		if (index >= pattern.pattern.Length()) {
-			return NodeLeaf(nullptr, nullptr);
+		node = ParseString(index);
+		if (node != none) return node;
+
+		char c = 0;
+
+		if (ParseChar(index, c)) {
+			Node string;
+			string.kind = Kind::String;
+			string.index = (UInt)chars.size();
+			string.length = 1;
+			chars.push_back(c);
+			return Add(string);
 		}
 
+		if (index >= length) return none;
+
+		Node element;
+
 		switch (pattern[index]) {
 			case MetaChar::escape: {
-				Node esc = ParseEscape(pattern, index);
-				return NodeLeaf(esc, esc);
+				return ParseEscape(index);
 			}
 
 			case MetaChar::any: {
 				index++;
-				Node node = new AnyNode();
-				return NodeLeaf(node, node);
+				element.kind = Kind::Set;
+				element.set.bits[0] = element.set.bits[1] = element.set.bits[2] = element.set.bits[3] = ~0ULL;
+				return Add(element);
 			}
 
 			case MetaChar::start: {
 				index++;
-				Node node = new StartNode();
-				return NodeLeaf(node, node);
+				element.kind = Kind::Start;
+				return Add(element);
 			}
 
 			case MetaChar::end: {
 				index++;
-				Node node = new EndNode();
-				return NodeLeaf(node, node);
+				element.kind = Kind::End;
+				return Add(element);
 			}
 
 			case MetaChar::inverse: {
 				index++;
 
-				NodeLeaf node = ParseRawElement(pattern, index);
+				node = ParseRawElement(index);
+				if (node == none) throw RegexPatternError("Element expected after '~'");
 
-				if (node.value1) {
-					Pointer<InverseNode> inv = new InverseNode();
-					node.value2->next = new LeafNode();
-					inv->content = node.value1;
-					return NodeLeaf(inv, inv);
+				// Inverses of single characters are sets of all other characters
+				Node& inverse = nodes[node];
+
+				if (inverse.kind == Kind::String && inverse.length == 1) {
+					inverse.set.Add((UByte)chars[inverse.index]);
 				}
-				else {
-					throw RegexPatternError("Element expected after '" + String(MetaChar::inverse) + "'");
+				else if (inverse.kind != Kind::Set) {
+					throw RegexPatternError("StaticRegex does not support inverses of more than one character");
+				}
+
+				inverse.kind = Kind::Set;
+
+				for (UInt i = 0; i < 4; i++) {
+					inverse.set.bits[i] = ~inverse.set.bits[i];
 				}
+
+				return node;
 			}
 
 			case MetaChar::setOpen: {
-				Node set = ParseSet(pattern, index);
-				return NodeLeaf(set, set);
+				return ParseSet(index);
 			}
 
 			case MetaChar::groupOpen: 
 			case MetaChar::hiddenOpen: {
-				return ParseGroup(pattern, index);
+				return ParseGroup(index);
 			}
 
 			case MetaChar::element: {
-				return ParseElementMatch(pattern, index);
+				throw RegexPatternError("StaticRegex does not support element matches");
 			}
 
 			case MetaChar::quote: {
-				return ParseLiteralString(pattern, index);
+				return ParseLiteralString(index);
 			}
 		}
 
-		return NodeLeaf(nullptr, nullptr);
+		return none;
 	}
 
-	inline Optional<Tuple<UInt, UInt, bool>> Regex::ParseQuantifier(const Pattern& pattern, UInt& index) {
-		if (index >= pattern.pattern.Length()) return nullptr;
+	constexpr bool Regex::StaticCompiler::ParseQuantifier(UInt& index, UInt& min, UInt& max, bool& many) {
+		if (index >= length) return false;
 
-		UInt min = 0, max = 0;
-		bool many = true;
+		many = true;
 		
 		if (pattern[index] == MetaChar::manyOpt) {
 			min = 0;
 			max = Math::UIntMax();
-			many = true;
 			index++;
 		}
 		else if (pattern[index] == MetaChar::many) {
 			min = 1;
 			max = Math::UIntMax();
-			many = true;
 			index++;
 		}
 		else if (pattern[index] == MetaChar::fewOpt) {
@@ -1037,7 +5154,6 @@ namespace Boxx {
 		else if (pattern[index] == MetaChar::optional) {
 			min = 0;
 			max = 1;
-			many = true;
 			index++;
 		}
 		else if (pattern[index] == MetaChar::quantOpen) {
@@ -1045,30 +5161,22 @@ namespace Boxx {
 			min = 0;
 			max = Math::UIntMax();
 
-			if (index >= pattern.pattern.Length()) {
-				throw RegexPatternError("Quantifier range expected after '" + String(MetaChar::quantOpen) + "'");
+			if (index >= length) {
+				throw RegexPatternError("Quantifier range expected after '<'");
 			}
 
 			if (pattern[index] == MetaChar::quantRange) {
 				index++;
 
-				if (Optional<UInt> num = ParseInt(pattern, index)) {
-					max = *num;
-				}
-				else {
-					throw RegexPatternError("Integer expected after '" + String(MetaChar::quantRange) + "' in quantifier range");
+				if (!ParseInt(index, max)) {
+					throw RegexPatternError("Integer expected after ':' in quantifier range");
 				}
 			}
-			else if (Optional<UInt> num = ParseInt(pattern, index)) {
-				min = *num;
-
-				if (index < pattern.pattern.Length() && pattern[index] == MetaChar::quantRange) {
+			else if (ParseInt(index, min)) {
+				if (index < length && pattern[index] == MetaChar::quantRange) {
 					index++;
 
-					if (Optional<UInt> n = ParseInt(pattern, index)) {
-						max = *n;
-					}
-					else {
+					if (!ParseInt(index, max)) {
 						max = Math::UIntMax();
 					}
 				}
@@ -1081,8 +5189,8 @@ namespace Boxx {
 				throw RegexPatternError("Quantifier range is out of order");
 			}
 
-			if (index >= pattern.pattern.Length()) {
-				throw RegexPatternError("'" + String(MetaChar::quantClose) + "' expected to close quantifier");
+			if (index >= length) {
+				throw RegexPatternError("'>' expected to close quantifier");
 			}
 
 			if (pattern[index] == MetaChar::few || pattern[index] == MetaChar::many) {
@@ -1090,875 +5198,1083 @@ namespace Boxx {
 				index++;
 			}
 
-			if (index >= pattern.pattern.Length() || pattern[index] != MetaChar::quantClose) {
-				throw RegexPatternError("'" + String(MetaChar::quantClose) + "' expected to close quantifier");
+			if (index >= length || pattern[index] != MetaChar::quantClose) {
+				throw RegexPatternError("'>' expected to close quantifier");
 			}
 
 			index++;
 		}
 		else {
-			return nullptr;
+			return false;
 		}
 
-		return Tuple<UInt, UInt, bool>(min, max, many);
+		return true;
 	}
 
-	inline Regex::Node Regex::ParseRange(const Pattern& pattern, UInt& index) {
+	constexpr UInt Regex::StaticCompiler::ParseRange(UInt& index) {
 		const UInt startIndex = index;
 
-		Optional<char> start = ParseChar(pattern, index);
-		if (!start) return nullptr;
-
-		if (index >= pattern.pattern.Length()) {
-			index = startIndex;
-			return nullptr;
-		}
+		char start = 0;
+		if (!ParseChar(index, start)) return none;
 
-		if (pattern[index] != MetaChar::range) {
+		if (index >= length || pattern[index] != MetaChar::range) {
 			index = startIndex;
-			return nullptr;
+			return none;
 		}
 
 		index++;
 
-		if (Optional<char> endChar = ParseChar(pattern, index)) {
-			Pointer<RangeNode> range = new RangeNode();
-			range->start = *start;
-			range->end   = *endChar;
-			return range;
-		}
-		else {
-			throw RegexPatternError("Character expected after '" + String(MetaChar::range) + "' to end range");
-		}
-	}
-
-	inline Regex::Node Regex::ParseString(const Pattern& pattern, UInt& index) {
-		List<char> str;
-		UInt lastIndex = index;
+		char end = 0;
 
-		while (Optional<char> c = ParseChar(pattern, index, false)) {
-			str.Add(*c);
-			lastIndex = index;
+		if (!ParseChar(index, end)) {
+			throw RegexPatternError("Character expected after ':' to end range");
 		}
 
-		if (str.IsEmpty()) return nullptr;
-
-		if (str.Count() > 1) {
-			Pointer<StringNode> node = new StringNode();
-			node->string = String(str);
-			return node;
-		}
-		else {
-			Pointer<CharNode> node = new CharNode();
-			node->c = str[0];
-			return node;
-		}
+		Node range;
+		range.kind = Kind::Set;
+		range.set.AddRange(start, end);
+		return Add(range);
 	}
 
-	inline Regex::Node Regex::ParseEscape(const Pattern& pattern, UInt& index) {
-		if (pattern[index] != MetaChar::escape) return nullptr;
-		index++;
-
-		switch (pattern[index]) {
-			case MetaChar::digit: {
-				Pointer<RangeNode> range = new RangeNode();
-				range->start = '0';
-				range->end   = '9';
-				index++;
-
-				return range;
-			}
-
-			case MetaChar::lower: {
-				Pointer<RangeNode> range = new RangeNode();
-				range->start = 'a';
-				range->end   = 'z';
-				index++;
-
-				return range;
-			}
-
-			case MetaChar::upper: {
-				Pointer<RangeNode> range = new RangeNode();
-				range->start = 'A';
-				range->end   = 'Z';
-				index++;
-
-				return range;
-			}
-
-			case MetaChar::hex: {
-				index++;
-				return new HexNode();
-			}
+	constexpr UInt Regex::StaticCompiler::ParseString(UInt& index) {
+		Node string;
+		string.kind = Kind::String;
+		string.index = (UInt)chars.size();
 
-			case MetaChar::alpha: {
-				index++;
-				return new AlphaNode();
-			}
+		char c = 0;
 
-			case MetaChar::alphanum: {
-				index++;
-				return new AlphaNumNode();
-			}
+		while (ParseChar(index, c, false)) {
+			chars.push_back(c);
+			string.length++;
+		}
 
-			case MetaChar::word: {
-				index++;
-				return new WordNode();
-			}
+		if (string.length == 0) return none;
+		return Add(string);
+	}
 
-			case MetaChar::punct: {
-				index++;
-				return new PunctNode();
-			}
+	constexpr UInt Regex::StaticCompiler::ParseEscape(UInt& index) {
+		if (At(index) != MetaChar::escape) return none;
+		index++;
 
-			case MetaChar::space: {
-				index++;
-				return new SpaceNode();
-			}
+		Node escape;
+		escape.kind = Kind::Set;
 
-			case MetaChar::white: {
-				index++;
-				return new WhiteSpaceNode();
-			}
+		if (MetaChar::AddClass(At(index), escape.set)) {
+			index++;
+			return Add(escape);
+		}
 
+		switch (At(index)) {
 			case MetaChar::lineBreak: {
 				index++;
-				return new LineBreakNode();
+				escape.kind = Kind::LineBreak;
+				return Add(escape);
 			}
 
 			case MetaChar::bound: {
 				index++;
-				return new BoundaryNode();
+				escape.kind = Kind::Boundary;
+				return Add(escape);
 			}
 		}
 
-		if (Optional<UInt> num = ParseInt(pattern, index)) {
-			Pointer<ElementMatchNode> match = new ElementMatchNode();
-			match->index = *num;
-			return match;
-		}
-
-		throw RegexPatternError("Invalid escape character '" + String(pattern[index]) + "'");
+		UInt num = 0;
+
+		if (ParseInt(index, num)) {
+			throw RegexPatternError("StaticRegex does not support element matches");
+		}
+
+		throw RegexPatternError("Invalid escape character");
 	}
 
-	inline Regex::Node Regex::ParseSet(const Pattern& pattern, UInt& index) {
-		if (pattern[index] != MetaChar::setOpen) return nullptr;
+	constexpr UInt Regex::StaticCompiler::ParseSet(UInt& index) {
+		if (At(index) != MetaChar::setOpen) return none;
 		index++;
 
-		Pointer<SetNode> set = new SetNode();
+		Node set;
+		set.kind = Kind::Set;
+		bool empty = true;
 
-		while (pattern[index] != MetaChar::setClose) {
-			if (Node node = ParseSetRange(pattern, index)) {
-				node->next = new LeafNode();
-				set->nodes.Add(node);
+		while (At(index) != MetaChar::setClose) {
+			char c = 0;
+
+			if (ParseSetRange(index, set.set)) {
+				empty = false;
 			}
-			else if (Optional<char> c = ParseSetChar(pattern, index)) {
-				set->chars.Add(*c);
+			else if (ParseSetChar(index, c)) {
+				set.set.Add((UByte)c);
+				empty = false;
 			}
-			else if (Node node = ParseSetEscape(pattern, index)) {
-				node->next = new LeafNode();
-				set->nodes.Add(node);
+			else if (ParseSetEscape(index, set.set)) {
+				empty = false;
 			}
 			else {
-				throw RegexPatternError("Unexpected character '" + String(pattern[index]) + "' in character set");
+				throw RegexPatternError("Unexpected character in character set");
 			}
 		}
 
 		index++;
-		return set;
+
+		// An empty set matches an empty string
+		if (empty) set.kind = Kind::Empty;
+		return Add(set);
 	}
 
-	inline Regex::Node Regex::ParseSetRange(const Pattern& pattern, UInt& index) {
+	constexpr bool Regex::StaticCompiler::ParseSetRange(UInt& index, ByteSet& set) {
 		const UInt startIndex = index;
 
-		Optional<char> start = ParseSetChar(pattern, index);
-		if (!start) return nullptr;
+		char start = 0;
+		if (!ParseSetChar(index, start)) return false;
 
-		if (pattern[index] != MetaChar::range) {
+		if (At(index) != MetaChar::range) {
 			index = startIndex;
-			return nullptr;
+			return false;
 		}
 
 		index++;
 
-		if (Optional<char> endChar = ParseSetChar(pattern, index)) {
-			Pointer<RangeNode> range = new RangeNode();
-			range->start = *start;
-			range->end   = *endChar;
-			return range;
-		}
-		else {
-			throw RegexPatternError("Character expected after '" + String(MetaChar::range) + "' to end range");
+		char end = 0;
+
+		if (!ParseSetChar(index, end)) {
+			throw RegexPatternError("Character expected after ':' to end range");
 		}
+
+		set.AddRange(start, end);
+		return true;
 	}
 
-	inline Regex::Node Regex::ParseSetEscape(const Pattern& pattern, UInt& index) {
-		if (pattern[index] != MetaChar::escape) return nullptr;
+	constexpr bool Regex::StaticCompiler::ParseSetEscape(UInt& index, ByteSet& set) {
+		if (At(index) != MetaChar::escape) return false;
 		index++;
 
-		switch (pattern[index]) {
-			case MetaChar::digit: {
-				Pointer<RangeNode> range = new RangeNode();
-				range->start = '0';
-				range->end   = '9';
-				index++;
-
-				return range;
-			}
-
-			case MetaChar::lower: {
-				Pointer<RangeNode> range = new RangeNode();
-				range->start = 'a';
-				range->end   = 'z';
-				index++;
-
-				return range;
-			}
-
-			case MetaChar::upper: {
-				Pointer<RangeNode> range = new RangeNode();
-				range->start = 'A';
-				range->end   = 'Z';
-				index++;
-
-				return range;
-			}
-
-			case MetaChar::hex: {
-				index++;
-				return new HexNode();
-			}
-
-			case MetaChar::alpha: {
-				index++;
-				return new AlphaNode();
-			}
-
-			case MetaChar::alphanum: {
-				index++;
-				return new AlphaNumNode();
-			}
-
-			case MetaChar::word: {
-				index++;
-				return new WordNode();
-			}
-
-			case MetaChar::punct: {
-				index++;
-				return new PunctNode();
-			}
-
-			case MetaChar::space: {
-				index++;
-				return new SpaceNode();
-			}
-
-			case MetaChar::white: {
-				index++;
-				return new WhiteSpaceNode();
-			}
+		if (MetaChar::AddClass(At(index), set)) {
+			index++;
+			return true;
 		}
 
-		throw RegexPatternError("Invalid escape character '" + String(pattern[index]) + "'");
+		throw RegexPatternError("Invalid escape character");
 	}
 
-	inline Regex::NodeLeaf Regex::ParseGroup(const Pattern& pattern, UInt& index) {
-		if (pattern[index] != MetaChar::groupOpen && pattern[index] != MetaChar::hiddenOpen) {
-			return NodeLeaf(nullptr, nullptr);
-		}
-
-		bool isHidden = pattern[index] == MetaChar::hiddenOpen;
+	constexpr UInt Regex::StaticCompiler::ParseGroup(UInt& index) {
+		if (At(index) != MetaChar::groupOpen && At(index) != MetaChar::hiddenOpen) return none;
 
-		Pointer<GroupNode> group = new GroupNode();
-		group->isHidden = isHidden;
+		Node group;
+		group.kind = Kind::Group;
+		group.hidden = At(index) == MetaChar::hiddenOpen;
 		index++;
 
-		NodeLeaf node = ParseExpression(pattern, index);
-		group->next = node.value1;
-		
-		Pointer<GroupEndNode> groupEnd = new GroupEndNode();
-		groupEnd->isHidden = isHidden;
-		node.value2->next = groupEnd;
+		group.index = ParseExpression(index);
 
-		if (isHidden && pattern[index] != MetaChar::hiddenClose) {
-			throw RegexPatternError("'" + String(MetaChar::hiddenClose) + "' expected to close hidden group");
+		if (group.hidden && At(index) != MetaChar::hiddenClose) {
+			throw RegexPatternError("'}' expected to close hidden group");
 		}
 
-		if (!isHidden && pattern[index] != MetaChar::groupClose) {
-			throw RegexPatternError("'" + String(MetaChar::groupClose) + "' expected to close group");
+		if (!group.hidden && At(index) != MetaChar::groupClose) {
+			throw RegexPatternError("')' expected to close group");
 		}
 
 		index++;
-		return NodeLeaf(group, groupEnd);
+		return Add(group);
 	}
 
-	inline Optional<char> Regex::ParseChar(const Pattern& pattern, UInt& index, const bool skipPost) {
-		if (index >= pattern.pattern.Length()) return nullptr;
+	constexpr bool Regex::StaticCompiler::ParseChar(UInt& index, char& c, const bool skipPost) {
+		if (index >= length) return false;
 
-		char c = pattern[index];
+		c = pattern[index];
 
 		if (c == MetaChar::escape) {
-			if (index + 1 >= pattern.pattern.Length()) return nullptr;
+			if (index + 1 >= length) return false;
 			c = pattern[index + 1];
-			if (MetaChar::IsReservedEscape(c)) return nullptr;
+			if (MetaChar::IsReservedEscape(c)) return false;
 			index++;
 		}
 		else if (MetaChar::IsMetaChar(c)) {
-			return nullptr;
+			return false;
 		}
-		else if (!skipPost && (index + 1 < pattern.pattern.Length() && MetaChar::IsPostChar(pattern[index + 1]))) {
-			return nullptr;
+		else if (!skipPost && index + 1 < length && MetaChar::IsPostChar(pattern[index + 1])) {
+			return false;
 		}
 
 		index++;
-		return c;
+		return true;
 	}
 
-	inline Optional<char> Regex::ParseSetChar(const Pattern& pattern, UInt& index) {
-		if (index >= pattern.pattern.Length()) return nullptr;
+	constexpr bool Regex::StaticCompiler::ParseSetChar(UInt& index, char& c) {
+		if (index >= length) return false;
 
-		char c = pattern[index];
+		c = pattern[index];
 
 		if (c == MetaChar::escape) {
-			if (index + 1 >= pattern.pattern.Length()) return nullptr;
+			if (index + 1 >= length) return false;
 			c = pattern[index + 1];
-			if (MetaChar::IsReservedSetEscape(c)) return nullptr;
+			if (MetaChar::IsReservedSetEscape(c)) return false;
 			index++;
 		}
 		else if (MetaChar::IsSetMetaChar(c)) {
-			return nullptr;
+			return false;
 		}
 
 		index++;
-		return c;
+		return true;
 	}
 
-	inline Optional<UInt> Regex::ParseInt(const Pattern& pattern, UInt& index) {
-		if (index >= pattern.pattern.Length()) return nullptr;
-		
-		UInt startIndex = index;
+	constexpr bool Regex::StaticCompiler::ParseInt(UInt& index, UInt& value) {
+		if (index >= length) return false;
+
+		const UInt startIndex = index;
+
+		// The value is saturated in the same way as strtoul
+		unsigned long num = 0;
+		bool overflow = false;
+
+		while (index < length && '0' <= pattern[index] && pattern[index] <= '9') {
+			const unsigned long digit = (unsigned long)(pattern[index] - '0');
+
+			if (num > (~0UL - digit) / 10) {
+				overflow = true;
+			}
+			else {
+				num = num * 10 + digit;
+			}
 
-		while ('0' <= pattern[index] && pattern[index] <= '9') {
 			index++;
-			if (index >= pattern.pattern.Length()) break;
 		}
 
-		if (startIndex == index) return nullptr;
+		if (startIndex == index) return false;
 
-		return pattern.pattern.Sub(startIndex, index - 1).ToUInt();
+		value = (UInt)(overflow ? ~0UL : num);
+		return true;
 	}
 
-	inline const char* Regex::RootNode::Match(const char* str, MatchInfo& info) {
-		bool isStart = next.Is<StartNode>();
+	constexpr void Regex::StaticCompiler::Compile() {
+		reverse = false;
+		const UInt match = Emit(Program::Op::Match);
+		forwardMain = Chain(root, match);
 
-		do {
-			if (const char* c = next->Match(str, info)) {
-				return c;
-			}
+		if (anchored) {
+			forwardStart = forwardMain;
+		}
+		else {
+			// Starts a new thread at each position except the end of the string
+			ByteSet any;
+			any.bits[0] = any.bits[1] = any.bits[2] = any.bits[3] = ~0ULL;
 
-			str++;
-			info.matchStart++;
+			const UInt loop = Emit(Program::Op::Split);
+			const UInt notEnd = Emit(Program::Op::Assert, loop, 0, Program::Assert::NotEnd);
+			const UInt skip = EmitSet(any, notEnd);
 
-			if (str >= info.end) return nullptr;
+			forwardCode.insts[loop].out = forwardMain;
+			forwardCode.insts[loop].arg = skip;
+			forwardStart = loop;
 		}
-		while (!isStart);
 
-		return nullptr;
-	}
+		reverse = true;
+		reverseStart = Chain(root, Emit(Program::Op::Match));
 
-	inline const char* Regex::LeafNode::Match(const char* str, MatchInfo& info) {
-		info.matchEnd = (UInt)(str - info.str);
-		return str;
-	}
+		if (anchored) return;
 
-	inline const char* Regex::StringNode::Match(const char* str, MatchInfo& info) {
-		if ((UInt)(info.end - str) < string.Length()) {
-			return nullptr;
-		}
+		// The prefilter of the pattern is created in the same way as the prefilter of the nodes
+		std::vector<char> run;
+		bool leading = true;
+		Literals(root, run, leading);
 
-		const char* c = str;
+		if (leading) prefix = run;
+		if (run.size() > required.size()) required = run;
 
-		for (UInt i = 0; i < string.Length(); i++, c++) {
-			if (*c != string[i]) return nullptr;
+		if (required.size() <= prefix.size()) {
+			required.clear();
 		}
 
-		return next->Match(c, info);
-	}
+		bool known = true;
 
-	inline const char* Regex::CharNode::Match(const char* str, MatchInfo& info) {
-		if (str >= info.end || *str != c) {
-			return nullptr;
-		}
+		if (prefix.empty() && !First(root, known) && known) {
+			for (UInt c = 0; c < 256; c++) {
+				if (!first.Contains((UByte)c)) continue;
 
-		return next->Match(str + 1, info);
-	}
+				if (firstCount < 3) {
+					firstBytes[firstCount] = (UByte)c;
+				}
 
-	inline const char* Regex::RangeNode::Match(const char* str, MatchInfo& info) {
-		if (str >= info.end) {
-			return nullptr;
-		}
+				firstCount++;
+			}
 
-		if (start <= *str && *str <= end) {
-			return next->Match(str + 1, info);
+			if (firstCount > 64) {
+				firstCount = 0;
+			}
 		}
+	}
 
-		return nullptr;
+	constexpr Regex::StaticCompiler::Code& Regex::StaticCompiler::Current() {
+		return reverse ? reverseCode : forwardCode;
 	}
 
-	inline const char* Regex::HexNode::Match(const char* str, MatchInfo& info) {
-		if (str >= info.end) {
-			return nullptr;
-		}
+	constexpr UInt Regex::StaticCompiler::Emit(const Program::Op op, const UInt out, const UInt arg, const Program::Assert assert) {
+		std::vector<Program::Inst>& insts = Current().insts;
 
-		if (MetaChar::IsHex(*str)) {
-			return next->Match(str + 1, info);
+		if (insts.size() >= Compiler::maxInsts) {
+			throw RegexPatternError("The pattern is too large for StaticRegex");
 		}
 
-		return nullptr;
+		Program::Inst inst;
+		inst.op = op;
+		inst.assert = assert;
+		inst.out = out;
+		inst.arg = arg;
+
+		insts.push_back(inst);
+		return (UInt)insts.size() - 1;
 	}
 
-	inline const char* Regex::AlphaNode::Match(const char* str, MatchInfo& info) {
-		if (str >= info.end) {
-			return nullptr;
+	constexpr UInt Regex::StaticCompiler::EmitSet(const ByteSet& set, const UInt out) {
+		std::vector<ByteSet>& sets = Current().sets;
+		UInt index = 0;
+
+		while (
+			index < sets.size() && (
+				sets[index].bits[0] != set.bits[0] || sets[index].bits[1] != set.bits[1] ||
+				sets[index].bits[2] != set.bits[2] || sets[index].bits[3] != set.bits[3]
+			)
+		) {
+			index++;
 		}
 
-		if (MetaChar::IsAlpha(*str)) {
-			return next->Match(str + 1, info);
+		if (index == sets.size()) {
+			sets.push_back(set);
 		}
 
-		return nullptr;
+		return Emit(Program::Op::Class, out, index);
 	}
 
-	inline const char* Regex::AlphaNumNode::Match(const char* str, MatchInfo& info) {
-		if (str >= info.end) {
-			return nullptr;
+	constexpr UInt Regex::StaticCompiler::Chain(const UInt expr, const UInt cont) {
+		const std::vector<std::vector<UInt>>& alternatives = exprs[expr];
+		if (alternatives.size() == 1) return Sequence(alternatives[0], cont);
+
+		std::vector<UInt> branches;
+
+		for (const std::vector<UInt>& elements : alternatives) {
+			branches.push_back(Sequence(elements, cont));
 		}
 
-		if (MetaChar::IsAlphaNum(*str)) {
-			return next->Match(str + 1, info);
+		UInt pc = branches.back();
+
+		for (UInt i = (UInt)branches.size() - 1; i-- > 0;) {
+			pc = Emit(Program::Op::Split, branches[i], pc);
 		}
 
-		return nullptr;
+		return pc;
 	}
 
-	inline const char* Regex::WordNode::Match(const char* str, MatchInfo& info) {
-		if (str >= info.end) {
-			return nullptr;
+	constexpr UInt Regex::StaticCompiler::Sequence(const std::vector<UInt>& elements, UInt cont) {
+		// The elements are compiled from the end of the match to the start
+		if (reverse) {
+			for (UInt i = 0; i < elements.size(); i++) {
+				cont = Unit(elements[i], cont);
+			}
 		}
-
-		if (MetaChar::IsWord(*str)) {
-			return next->Match(str + 1, info);
+		else {
+			for (UInt i = (UInt)elements.size(); i-- > 0;) {
+				cont = Unit(elements[i], cont);
+			}
 		}
 
-		return nullptr;
+		return cont;
 	}
 
-	inline const char* Regex::PunctNode::Match(const char* str, MatchInfo& info) {
-		if (str >= info.end) {
-			return nullptr;
-		}
+	constexpr UInt Regex::StaticCompiler::Unit(const UInt index, const UInt cont) {
+		const Node node = nodes[index];
 
-		if (MetaChar::IsPunct(*str)) {
-			return next->Match(str + 1, info);
-		}
+		switch (node.kind) {
+			case Kind::Empty: {
+				return cont;
+			}
 
-		return nullptr;
-	}
+			case Kind::Set: {
+				return EmitSet(node.set, cont);
+			}
 
-	inline const char* Regex::SpaceNode::Match(const char* str, MatchInfo& info) {
-		if (str >= info.end) {
-			return nullptr;
-		}
+			case Kind::String: {
+				UInt pc = cont;
 
-		if (MetaChar::IsSpace(*str)) {
-			return next->Match(str + 1, info);
-		}
+				for (UInt i = 0; i < node.length; i++) {
+					ByteSet set;
+					set.Add((UByte)chars[node.index + (reverse ? i : node.length - i - 1)]);
+					pc = EmitSet(set, pc);
+				}
 
-		return nullptr;
-	}
+				return pc;
+			}
 
-	inline const char* Regex::WhiteSpaceNode::Match(const char* str, MatchInfo& info) {
-		if (str >= info.end) {
-			return nullptr;
-		}
+			case Kind::LineBreak: {
+				ByteSet cr, lf;
+				cr.Add('\r');
+				lf.Add('\n');
 
-		if (MetaChar::IsWhiteSpace(*str)) {
-			return next->Match(str + 1, info);
-		}
+				// Matches \r\n, \r without a following \n or \n
+				const UInt single = EmitSet(lf, cont);
+				UInt pair = 0;
 
-		return nullptr;
-	}
+				if (reverse) {
+					const UInt crEnd = EmitSet(cr, cont);
+					const UInt crlf = EmitSet(lf, crEnd);
+					pair = Emit(Program::Op::Split, crlf, Emit(Program::Op::Assert, crEnd, 0, Program::Assert::NotLineFeed));
+				}
+				else {
+					const UInt crlf = EmitSet(lf, cont);
+					const UInt after = Emit(Program::Op::Split, crlf, Emit(Program::Op::Assert, cont, 0, Program::Assert::NotLineFeed));
+					pair = EmitSet(cr, after);
+				}
 
-	inline const char* Regex::LineBreakNode::Match(const char* str, MatchInfo& info) {
-		if (str >= info.end) {
-			return nullptr;
-		}
+				return Emit(Program::Op::Split, pair, single);
+			}
 
-		if (*str == '\r') {
-			if (str + 1 < info.end && *(str + 1) == '\n') { 
-				return next->Match(str + 2, info);
+			case Kind::Start: {
+				return Emit(Program::Op::Assert, cont, 0, Program::Assert::Start);
 			}
-			else {
-				return next->Match(str + 1, info);
+
+			case Kind::End: {
+				return Emit(Program::Op::Assert, cont, 0, Program::Assert::End);
+			}
+
+			case Kind::Boundary: {
+				return Emit(Program::Op::Assert, cont, 0, Program::Assert::Boundary);
+			}
+
+			case Kind::Group: {
+				if (node.hidden) return Chain(node.index, cont);
+
+				groups = true;
+				if (reverse) return Chain(node.index, cont);
+
+				return Emit(Program::Op::Save, Chain(node.index, Emit(Program::Op::Save, cont, 1)), 0);
+			}
+
+			case Kind::Quantifier: {
+				return Repeat(index, cont);
 			}
-		}
-		else if (*str == '\n') {
-			return next->Match(str + 1, info);
 		}
 
-		return nullptr;
+		return cont;
 	}
 
-	inline const char* Regex::BoundaryNode::Match(const char* str, MatchInfo& info) {
-		if (
-			(str == info.start || str == info.end) ||
-			(MetaChar::IsWord(*(str - 1)) && !MetaChar::IsWord(*str)) ||
-			(!MetaChar::IsWord(*(str - 1)) && MetaChar::IsWord(*str))
-		) {
-			return next->Match(str, info);
+	constexpr UInt Regex::StaticCompiler::Repeat(const UInt index, const UInt cont) {
+		const Node node = nodes[index];
+		UInt pc = cont;
+
+		if (node.max == Math::UIntMax()) {
+			const UInt loop = Emit(Program::Op::Split);
+			const UInt content = Unit(node.index, loop);
+
+			std::vector<Program::Inst>& insts = Current().insts;
+			insts[loop].out = node.many ? content : cont;
+			insts[loop].arg = node.many ? cont : content;
+			pc = loop;
+
+			if (!reverse && PrefersEmpty(loop, content)) {
+				throw RegexPatternError("StaticRegex does not support repetitions with content that prefers to end empty");
+			}
 		}
 		else {
-			return nullptr;
+			for (UInt i = node.min; i < node.max; i++) {
+				const UInt content = Unit(node.index, pc);
+				pc = node.many ? Emit(Program::Op::Split, content, cont) : Emit(Program::Op::Split, cont, content);
+			}
+		}
+
+		for (UInt i = 0; i < node.min; i++) {
+			pc = Unit(node.index, pc);
 		}
+
+		return pc;
 	}
 
-	inline const char* Regex::AnyNode::Match(const char* str, MatchInfo& info) {
-		if (str >= info.end) {
-			return nullptr;
+	constexpr bool Regex::StaticCompiler::PrefersEmpty(const UInt loop, const UInt content) {
+		const std::vector<Program::Inst>& insts = Current().insts;
+
+		// The instructions of the content are emitted after the loop
+		const UInt size = (UInt)insts.size() - loop;
+
+		// Instructions reached from the start of a repetition without (1) and after (2) consuming a character
+		std::vector<UByte> reached(size);
+		std::vector<UInt> stack;
+		stack.push_back(content);
+		stack.push_back(1);
+
+		while (!stack.empty()) {
+			const UByte flag = (UByte)stack.back();
+			stack.pop_back();
+			const UInt pc = stack.back();
+			stack.pop_back();
+
+			if (pc <= loop || (reached[pc - loop] & flag) != 0) continue;
+			reached[pc - loop] |= flag;
+
+			const Program::Inst& inst = insts[pc];
+
+			stack.push_back(inst.out);
+			stack.push_back(inst.op == Program::Op::Class ? 2 : flag);
+
+			if (inst.op == Program::Op::Split) {
+				stack.push_back(inst.arg);
+				stack.push_back(flag);
+			}
+		}
+
+		// Instructions that can end the repetition without consuming a character and instructions that can consume one
+		std::vector<UByte> ends(size), consumes(size);
+
+		const auto endsAt   = [&](const UInt pc) {return pc == loop || (pc > loop && ends[pc - loop] != 0);};
+		const auto consumesAt = [&](const UInt pc) {return pc > loop && consumes[pc - loop] != 0;};
+
+		for (bool changed = true; changed;) {
+			changed = false;
+
+			for (UInt i = size; i-- > 1;) {
+				const Program::Inst& inst = insts[loop + i];
+				const bool split = inst.op == Program::Op::Split;
+
+				if (ends[i] == 0 && inst.op != Program::Op::Class && (endsAt(inst.out) || (split && endsAt(inst.arg)))) {
+					ends[i] = 1;
+					changed = true;
+				}
+
+				if (consumes[i] == 0 && (inst.op == Program::Op::Class || consumesAt(inst.out) || (split && consumesAt(inst.arg)))) {
+					consumes[i] = 1;
+					changed = true;
+				}
+			}
 		}
 
-		return next->Match(str + 1, info);
-	}
+		// A repetition that ends at such a split prefers ending over consuming, which the program drops in the next repetition
+		for (UInt i = 1; i < size; i++) {
+			const Program::Inst& inst = insts[loop + i];
 
-	inline const char* Regex::StartNode::Match(const char* str, MatchInfo& info) {
-		if (str != info.start) {
-			return nullptr;
+			if (inst.op == Program::Op::Split && reached[i] == 3 && endsAt(inst.out) && consumesAt(inst.arg)) {
+				return true;
+			}
 		}
 
-		return next->Match(str, info);
+		return false;
 	}
 
-	inline const char* Regex::EndNode::Match(const char* str, MatchInfo& info) {
-		if (str != info.end) {
-			return nullptr;
+	constexpr void Regex::StaticCompiler::Literals(const UInt expr, std::vector<char>& run, bool& leading) {
+		if (exprs[expr].size() > 1) {
+			EndLiteral(run, leading);
+			return;
 		}
 
-		return next->Match(str, info);
-	}
+		for (const UInt index : exprs[expr][0]) {
+			const Node& node = nodes[index];
+
+			switch (node.kind) {
+				case Kind::Group: {
+					Literals(node.index, run, leading);
+					break;
+				}
 
-	inline const char* Regex::InverseNode::Match(const char* str, MatchInfo& info) {
-		const UInt groupSize   = info.groups.Count();
-		const UInt elementSize = info.elements.Count();
+				case Kind::String: {
+					for (UInt i = 0; i < node.length; i++) {
+						run.push_back(chars[node.index + i]);
+					}
 
-		if (content->Match(str, info)) {
-			if (groupSize < info.groups.Count()) {
-				info.groups.RemoveAt(groupSize, info.groups.Count() - groupSize);
-			}
+					break;
+				}
 
-			if (elementSize < info.elements.Count()) {
-				info.elements.RemoveAt(elementSize, info.elements.Count() - elementSize);
-			}
+				case Kind::Empty:
+				case Kind::Start:
+				case Kind::Boundary: {
+					break;
+				}
 
-			return nullptr;
+				default: {
+					EndLiteral(run, leading);
+					break;
+				}
+			}
 		}
-
-		return next->Match(str + 1, info);
 	}
 
-	inline const char* Regex::EmptyNode::Match(const char* str, MatchInfo& info) {
-		return next->Match(str, info);
+	constexpr void Regex::StaticCompiler::EndLiteral(std::vector<char>& run, bool& leading) {
+		if (leading) prefix = run;
+		if (run.size() > required.size()) required = run;
+
+		leading = false;
+		run.clear();
 	}
 
-	inline const char* Regex::SetNode::Match(const char* str, MatchInfo& info) {
-		if (chars.IsEmpty() && nodes.IsEmpty()) {
-			return next->Match(str, info);
-		}
+	constexpr bool Regex::StaticCompiler::First(const UInt expr, bool& known) {
+		const std::vector<std::vector<UInt>>& alternatives = exprs[expr];
+		bool empty = false;
 
-		if (str >= info.end) return nullptr;
+		for (const std::vector<UInt>& elements : alternatives) {
+			bool alternative = true;
 
-		bool found = chars.Contains(*str);
+			for (const UInt node : elements) {
+				if (!known) break;
 
-		if (!found) {
-			for (Node node : nodes) {
-				if (node->Match(str, info)) {
-					found = true;
+				if (!FirstOf(node, known)) {
+					alternative = false;
 					break;
 				}
 			}
-		}
 
-		if (!found) return nullptr;
+			if (alternative) empty = true;
+		}
 
-		return next->Match(str + 1, info);
+		return empty;
 	}
 
-	inline const char* Regex::GroupNode::Match(const char* str, MatchInfo& info) {
-		UInt current = 0;
+	constexpr bool Regex::StaticCompiler::FirstOf(const UInt index, bool& known) {
+		const Node& node = nodes[index];
 
-		if (!isHidden) {
-			current = info.groups.Count();
-			info.groups.Add("");
-		}
+		switch (node.kind) {
+			case Kind::Set: {
+				for (UInt i = 0; i < 4; i++) {
+					first.bits[i] |= node.set.bits[i];
+				}
 
-		if (const char* c = next->Match(str, info)) {
-			if (!isHidden) {
-				info.groups[current] = String(str, (UInt)(info.groupStack.Pop() - str));
+				return false;
 			}
 
-			return c;
-		}
-		else {
-			if (!isHidden) info.groups.RemoveLast();
-			return nullptr;
-		}
-	}
+			case Kind::String: {
+				// Empty literal strings do not match a character
+				if (node.length == 0) return true;
 
-	inline const char* Regex::GroupEndNode::Match(const char* str, MatchInfo& info) {
-		if (const char* c = next->Match(str, info)) {
-			if (!isHidden) {
-				info.groupStack.Push(str);
+				first.Add((UByte)chars[node.index]);
+				return false;
 			}
 
-			return c;
-		}
-		
-		return nullptr;
-	}
+			case Kind::LineBreak: {
+				first.Add('\r');
+				first.Add('\n');
+				return false;
+			}
 
-	inline const char* Regex::SelectNode::Match(const char* str, MatchInfo& info) {
-		const UInt groupSize   = info.groups.Count();
-		const UInt elementSize = info.elements.Count();
+			case Kind::Group: {
+				return First(node.index, known);
+			}
 
-		for (Node node : nodes) {
-			if (const char* c = node->Match(str, info)) {
-				return c;
+			case Kind::Quantifier: {
+				return !(node.max > 0 && !FirstOf(node.index, known) && node.min > 0);
 			}
-			else {
-				if (groupSize < info.groups.Count()) {
-					info.groups.RemoveAt(groupSize, info.groups.Count() - groupSize);
-				}
 
-				if (elementSize < info.elements.Count()) {
-					info.elements.RemoveAt(elementSize, info.elements.Count() - elementSize);
-				}
+			default: {
+				return true;
 			}
 		}
-		
-		return nullptr;
 	}
+	#endif
+
+	inline Regex::DFA::DFA(const Program& program, const bool longest, const Prefilter* const prefilter) : program(program), longest(longest), prefilter(prefilter) {
+		stride = program.classCount + 1;
+		marks = std::vector<UInt>(program.insts.size(), 0);
+		cuts = std::vector<UInt>(program.patterns + 1, 0);
+
+		// The instructions left after skipping a character while no match is in progress
+		if (prefilter || (!longest && !program.anchored && program.owners.empty())) {
+			const Program::Inst& skip = program.insts[program.insts[program.start].arg];
+			NextMark();
+			Closure(skip.out, idle, false, Program::Category::None, Program::Category::None);
+		}
 
-	inline const char* Regex::QuantifierNode::Match(const char* str, MatchInfo& info) {
-		info.quantNums.Push(0);
-		const char* c = nullptr;
+		Clear();
+	}
 
-		if (many) {
-			if (min > 0) {
-				c = content->Match(str, info);
+	inline void Regex::DFA::Forward(const char* const str, const UInt pos, const UInt end, Int& matchEnd, const bool start) {
+		matchEnd = -1;
+		UInt i = pos;
+
+		if (prefilter && !prefilter->Next(str, pos, end, i)) return;
+
+		UInt state = Start(i > pos || !start ? Program::CategoryOf((UByte)str[i - 1]) : Program::Category::None);
+
+		for (; i < end; i++) {
+			const UInt input = program.byteClass[(UByte)str[i]];
+			Int value = table[state * stride + input];
+
+			if (value < 0) {
+				value = Transition(state, input);
 			}
-			else {
-				c = content->Match(str, info);
 
-				if (c == nullptr) {
-					c = next->Match(str, info);
+			if (value & 7) {
+				if (value & 1) matchEnd = (Int)i;
+				if (value & 2) return;
+
+				// Skips to the next position where a match can start
+				if (value & 4) {
+					UInt next;
+					if (!prefilter->Next(str, i + 1, end, next)) return;
+
+					if (next > i + 1) {
+						state = Start(Program::CategoryOf((UByte)str[next - 1]));
+						i = next - 1;
+						continue;
+					}
 				}
 			}
+
+			state = (UInt)(value >> 4);
 		}
-		else {
-			if (min > 0) {
-				c = content->Match(str, info);
+
+		Int value = table[state * stride + program.classCount];
+
+		if (value < 0) {
+			value = Transition(state, program.classCount);
+		}
+
+		if (value & 1) matchEnd = (Int)end;
+	}
+
+	inline void Regex::DFA::Reverse(const char* const str, const UInt pos, const UInt end, const UInt from, Int& matchStart, const bool start) {
+		matchStart = -1;
+		UInt state = Start(from < end ? Program::CategoryOf((UByte)str[from]) : Program::Category::None);
+
+		for (UInt i = from; i > pos; i--) {
+			const UInt input = program.byteClass[(UByte)str[i - 1]];
+			Int value = table[state * stride + input];
+
+			if (value < 0) {
+				value = Transition(state, input);
 			}
-			else {
-				c = next->Match(str, info);
 
-				if (c == nullptr) {
-					c = content->Match(str, info);
-				}
+			if (value & 3) {
+				if (value & 1) matchStart = (Int)i;
+				if (value & 2) return;
 			}
+
+			state = (UInt)(value >> 4);
 		}
 
-		info.quantNums.Pop();
-		return c;
+		// Matches can not start at the position if it is not the start of the search
+		if (!start) return;
+
+		Int value = table[state * stride + program.classCount];
+
+		if (value < 0) {
+			value = Transition(state, program.classCount);
+		}
+
+		if (value & 1) matchStart = (Int)pos;
 	}
 
-	inline const char* Regex::QuantifierEndNode::Match(const char* str, MatchInfo& info) {
-		info.quantNums.Set(info.quantNums.Peek() + 1);
-		const char* c = nullptr;
+	inline void Regex::DFA::Scan(const char* const str, const UInt pos, const UInt end, const bool first, std::vector<Int>& ends) {
+		UInt best = program.patterns;
+		UInt state = Start(Program::Category::None);
 
-		if (many) {
-			if (info.quantNums.Peek() < min) {
-				c = content->Match(str, info);
+		for (UInt i = pos;; i++) {
+			// Stops if only patterns after the first matched pattern are left
+			if (first && best < states[state].lowest) return;
+
+			const UInt input = i < end ? program.byteClass[(UByte)str[i]] : program.classCount;
+			Int value = table[state * stride + input];
+
+			if (value < 0) {
+				value = Transition(state, input);
 			}
-			else if (info.quantNums.Peek() < max) {
-				c = content->Match(str, info);
 
-				if (c == nullptr) {
-					c = next->Match(str, info);
+			if (value & 1) {
+				for (const UInt pattern : found[state * stride + input]) {
+					ends[pattern] = (Int)i;
+					if (pattern < best) best = pattern;
 				}
 			}
-			else {
-				c = next->Match(str, info);
-			}
+
+			if ((value & 2) || i >= end) return;
+
+			state = (UInt)(value >> 4);
 		}
-		else {
-			if (info.quantNums.Peek() < min) {
-				c = content->Match(str, info);
-			}
-			else if (info.quantNums.Peek() < max) {
-				c = next->Match(str, info);
+	}
 
-				if (c == nullptr) {
-					c = content->Match(str, info);
-				}
+	inline void Regex::DFA::Clear() {
+		states.clear();
+		lookup.clear();
+		table.clear();
+		found.clear();
+
+		for (UInt i = 0; i < 4; i++) {
+			starts[i] = -1;
+		}
+
+		// State 0 is the dead state
+		Add(Program::Category::None, std::vector<UInt>());
+	}
+
+	inline UInt Regex::DFA::Add(const Program::Category behind, const std::vector<UInt>& insts) {
+		std::string key = std::string(1, (char)behind);
+		key.append((const char*)insts.data(), insts.size() * sizeof(UInt));
+
+		const auto found = lookup.find(key);
+		if (found != lookup.end()) return found->second;
+
+		const UInt index = (UInt)states.size();
+		lookup[key] = index;
+
+		State state;
+		state.behind = behind;
+		state.insts = insts;
+		state.lowest = program.patterns;
+
+		if (!program.owners.empty()) {
+			for (const UInt pc : insts) {
+				if (program.owners[pc] < state.lowest) state.lowest = program.owners[pc];
 			}
-			else {
-				c = next->Match(str, info);
+		}
+
+		states.push_back(std::move(state));
+		table.resize(states.size() * stride, -1);
+		return index;
+	}
+
+	inline UInt Regex::DFA::Start(const Program::Category behind) {
+		if (starts[(UInt)behind] < 0) {
+			if (states.size() >= maxStates) {
+				Clear();
 			}
+
+			next.clear();
+			NextMark();
+			Closure(program.start, next, false, behind, behind);
+			starts[(UInt)behind] = (Int)Add(behind, next);
 		}
 
-		info.quantNums.Set(info.quantNums.Peek() - 1);
-		return c;
+		return (UInt)starts[(UInt)behind];
 	}
 
-	inline const char* Regex::PlainQuantifierNode::Match(const char* str, MatchInfo& info) {
-		if (many) {
-			Stack<const char*> starts;
-			starts.Push(str);
+	inline Int Regex::DFA::Transition(UInt& state, const UInt input) {
+		// Clears the cache if it is full and keeps only the current state
+		if (states.size() >= maxStates) {
+			State current = std::move(states[state]);
+			Clear();
+			state = Add(current.behind, current.insts);
+		}
 
-			for (UInt num = 0; num < max && str <= info.end; num++) {
-				if (const char* c = content->Match(str, info)) {
-					str = c;
-					starts.Push(str);
-				}
-				else if (num < min) {
-					return nullptr;
+		const bool end = input == program.classCount;
+		const Program::Category behind = states[state].behind;
+		const Program::Category ahead = end ? Program::Category::None : Program::CategoryOf(program.classByte[input]);
+		const Program::Category left  = longest ? ahead : behind;
+		const Program::Category right = longest ? behind : ahead;
+
+		resolved.clear();
+		NextMark();
+
+		for (const UInt pc : states[state].insts) {
+			Closure(pc, resolved, true, left, right);
+		}
+
+		next.clear();
+		NextMark();
+
+		bool matched = false;
+		const bool multiple = !program.owners.empty();
+		std::vector<UInt> patterns;
+
+		for (const UInt pc : resolved) {
+			const Program::Inst& inst = program.insts[pc];
+
+			// Threads after the match of a pattern have a lower priority than the match
+			if (multiple && cuts[program.owners[pc]] == mark) continue;
+
+			if (inst.op == Program::Op::Match) {
+				matched = true;
+
+				if (multiple) {
+					cuts[inst.arg] = mark;
+					patterns.push_back(inst.arg);
 				}
-				else {
+				else if (!longest) {
 					break;
 				}
 			}
-
-			while (starts.Count() > min) {
-				if (str = next->Match(starts.Pop(), info)) {
-					return str;
-				}
+			else if (!end && program.sets[inst.arg].Contains(program.classByte[input])) {
+				Closure(inst.out, next, false, left, right);
 			}
+		}
 
-			return nullptr;
+		const UInt index = next.empty() ? 0 : Add(ahead, next);
+		const bool waiting = !matched && !next.empty() && next == idle;
+		const Int value = (Int)(index << 4) | (matched ? 1 : 0) | (next.empty() ? 2 : 0) | (waiting && prefilter ? 4 : 0) | (waiting ? 8 : 0);
+		table[state * stride + input] = value;
+
+		if (multiple && matched) {
+			found[state * stride + input] = std::move(patterns);
 		}
-		else {
-			UInt num = 0;
 
-			for (; num < min; num++) {
-				str = content->Match(str, info);
+		return value;
+	}
 
-				if (str == nullptr) {
-					return nullptr;
+	inline void Regex::DFA::Closure(const UInt pc, std::vector<UInt>& list, const bool resolve, const Program::Category left, const Program::Category right) {
+		stack.push_back(pc);
+
+		while (!stack.empty()) {
+			const UInt current = stack.back();
+			stack.pop_back();
+
+			if (marks[current] == mark) continue;
+			marks[current] = mark;
+
+			const Program::Inst& inst = program.insts[current];
+
+			switch (inst.op) {
+				case Program::Op::Split: {
+					stack.push_back(inst.arg);
+					stack.push_back(inst.out);
+					break;
 				}
-			}
 
-			for (; num <= max && str <= info.end; num++) {
-				if (const char* c = next->Match(str, info)) {
-					return c;
+				case Program::Op::Save: {
+					stack.push_back(inst.out);
+					break;
 				}
-				
-				if (num >= max) return nullptr;
 
-				str = content->Match(str, info);
+				case Program::Op::Assert: {
+					// Assertions are resolved once the next character is known
+					if (!resolve) {
+						list.push_back(current);
+					}
+					else if (Program::Check(inst.assert, left, right)) {
+						stack.push_back(inst.out);
+					}
 
-				if (str == nullptr) {
-					return nullptr;
+					break;
+				}
+
+				default: {
+					list.push_back(current);
+					break;
 				}
 			}
+		}
+	}
 
-			return nullptr;
+	inline void Regex::DFA::NextMark() {
+		if (++mark == 0) {
+			std::fill(marks.begin(), marks.end(), 0);
+			std::fill(cuts.begin(), cuts.end(), 0);
+			mark = 1;
 		}
 	}
 
-	inline const char* Regex::AnyQuantifierNode::Match(const char* str, MatchInfo& info) {
-		if (many) {
-			const char* minPtr = str + min;
-			
-			if ((ULong)info.end - (ULong)str >= (ULong)max) {
-				str += max;
-			}
-			else {
-				str = info.end;
-			}
+	inline void Regex::Engine::Search(const char* const str, const UInt pos, const UInt end, Int& matchStart, Int& matchEnd) {
+		std::lock_guard<std::mutex> lock(mutex);
+		matchEnd = -1;
 
-			while (str >= minPtr) {
-				if (const char* c = next->Match(str, info)) {
-					return c;
-				}
+		if (prefilter.HasRequired(str, pos, end)) {
+			forwardDFA->Forward(str, pos, end, matchEnd);
+		}
 
-				str--;
-			}
+		if (matchEnd < 0) {
+			matchStart = -1;
+		}
+		else if (forward.anchored) {
+			matchStart = (Int)pos;
+		}
+		else {
+			reverseDFA->Reverse(str, pos, end, (UInt)matchEnd, matchStart);
+		}
+	}
 
-			return nullptr;
+	inline void Regex::Engine::Search(Searcher& searcher, const char* const str, const UInt pos, const UInt end, const bool start, Int& matchStart, Int& matchEnd) const {
+		matchEnd = -1;
+
+		if (prefilter.HasRequired(str, pos, end)) {
+			searcher.forward.Forward(str, pos, end, matchEnd, start);
+		}
+
+		if (matchEnd < 0) {
+			matchStart = -1;
+		}
+		else if (forward.anchored) {
+			matchStart = (Int)pos;
+		}
+		else if (start) {
+			searcher.reverse.Reverse(str, pos, end, (UInt)matchEnd, matchStart);
 		}
 		else {
-			const char* maxPtr;
+			// The byte before the position is only used to check the start of the match
+			searcher.reverse.Reverse(str, pos - 1, end, (UInt)matchEnd, matchStart, false);
+		}
+	}
 
-			if ((ULong)info.end - (ULong)str >= (ULong)max) {
-				maxPtr = str + max;
-			}
-			else {
-				maxPtr = info.end;
-			}
+	inline Regex::Searcher::Searcher(const Engine& engine) : forward(engine.forward, false, engine.skips ? &engine.prefilter : nullptr), reverse(engine.reverse, true) {
+		
+	}
 
-			str += min;
+	#ifdef _BOXX_REGEX_STATIC
+	template <Regex::StaticSizes sizes>
+	inline Regex Regex::Load(const StaticEngine<sizes>& table) {
+		Pointer<Engine> engine = new Engine();
+		engine->groups = table.groups;
 
-			while (str <= maxPtr) {
-				if (const char* c = next->Match(str, info)) {
-					return c;
-				}
+		engine->forward.insts = std::vector<Program::Inst>(table.forwardInsts.begin(), table.forwardInsts.end());
+		engine->forward.sets  = std::vector<ByteSet>(table.forwardSets.begin(), table.forwardSets.end());
+		engine->forward.start = table.forwardStart;
+		engine->forward.main  = table.forwardMain;
+		engine->forward.anchored = table.anchored;
 
-				str++;
-			}
+		engine->reverse.insts = std::vector<Program::Inst>(table.reverseInsts.begin(), table.reverseInsts.end());
+		engine->reverse.sets  = std::vector<ByteSet>(table.reverseSets.begin(), table.reverseSets.end());
+		engine->reverse.start = table.reverseStart;
+		engine->reverse.main  = table.reverseStart;
 
-			return nullptr;
-		}
-	}
+		if (sizes.prefix > 0) engine->prefilter.prefix = String(table.prefix.data(), sizes.prefix);
+		if (sizes.required > 0) engine->prefilter.required = String(table.required.data(), sizes.required);
 
-	inline const char* Regex::ElementNode::Match(const char* str, MatchInfo& info) {
-		info.elementStack.Push(str);
+		engine->prefilter.first = table.first;
+		engine->prefilter.firstCount = table.firstCount;
 
-		const char* c = next->Match(str, info);
+		for (UInt i = 0; i < 3; i++) {
+			engine->prefilter.firstBytes[i] = table.firstBytes[i];
+		}
 
-		info.elementStack.Pop();
-		return c;
-	}
+		engine->Finish();
 
-	inline const char* Regex::ElementEndNode::Match(const char* str, MatchInfo& info) {
-		const char* start = info.elementStack.Peek();
-		info.elements.Add(String(start, (UInt)(str - start)));
+		Regex regex;
+		regex.engine = engine;
+		return regex;
+	}
 
-		if (const char* c = next->Match(str, info)) {
-			return c;
+	template <UInt size>
+	constexpr RegexLiteral<size>::RegexLiteral(const char (&pattern)[size]) {
+		for (UInt i = 0; i < size; i++) {
+			chars[i] = pattern[i];
 		}
+	}
 
-		info.elements.RemoveLast();
-		return nullptr;
+	template <RegexLiteral pattern>
+	inline Optional<Match> StaticRegex<pattern>::Match(const String& str, const UInt pos) const {
+		return ToRegex().Match(str, pos);
 	}
 
-	inline const char* Regex::ElementMatchNode::Match(const char* str, MatchInfo& info) {
-		if (index >= info.elements.Count()) return nullptr;
+	template <RegexLiteral pattern>
+	inline bool StaticRegex<pattern>::Match(const StringView& str, MatchContext& context, const UInt pos) const {
+		return ToRegex().Match(str, context, pos);
+	}
 
-		const String element = info.elements[index];
+	template <RegexLiteral pattern>
+	inline List<Match> StaticRegex<pattern>::GlobalMatch(const String& str, UInt pos) const {
+		return ToRegex().GlobalMatch(str, pos);
+	}
 
-		if ((UInt)(info.end - element) < element.Length()) {
-			return nullptr;
-		}
+	template <RegexLiteral pattern>
+	inline List<Match> StaticRegex<pattern>::GlobalMatch(const String& str, ThreadPool& pool, UInt pos) const {
+		return ToRegex().GlobalMatch(str, pool, pos);
+	}
 
-		const char* c = str;
+	template <RegexLiteral pattern>
+	inline String StaticRegex<pattern>::Replace(const String& str, std::function<String(Boxx::Match)> replaceFunc) const {
+		return ToRegex().Replace(str, replaceFunc);
+	}
 
-		for (UInt i = 0; i < element.Length(); i++, c++) {
-			if (*c != element[i]) return nullptr;
-		}
+	template <RegexLiteral pattern>
+	inline String StaticRegex<pattern>::Replace(const String& str, std::function<String(Boxx::Match)> replaceFunc, ThreadPool& pool) const {
+		return ToRegex().Replace(str, replaceFunc, pool);
+	}
 
-		return next->Match(c, info);
+	template <RegexLiteral pattern>
+	inline const Regex& StaticRegex<pattern>::ToRegex() const {
+		static const Regex regex = Regex::Load(engine);
+		return regex;
 	}
+	#endif
 }
 
 #endif
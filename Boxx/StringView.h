@@ -0,0 +1,234 @@
+#ifndef _BOXX_STRINGVIEW_HEADER
+#define _BOXX_STRINGVIEW_HEADER
+
+#include <cstring>
+#include "Types.h"
+#include "String.h"
+#include "Optional.h"
+
+///[Settings] block: indent
+
+///[Namespace] Boxx
+namespace Boxx {
+	///[Title] StringView
+	/// A view of a sequence of characters owned by something else.
+	///[Warning] The view does not own the characters.
+	/// The characters must stay alive and unchanged for as long as the view is used.
+	///[Block] StringView
+	class StringView final {
+	public:
+		///[Heading] Constructors
+
+		/// Creates an empty view.
+		StringView();
+
+		/// Creates a view of a null terminated {char} array.
+		StringView(const char* const str);
+
+		/// Creates a view of a specific number of chars from a {char} array.
+		StringView(const char* const str, const UInt length);
+
+		/// Creates a view of a string.
+		StringView(const String& str);
+
+		StringView(const StringView& view);
+		~StringView();
+
+		///[Heading] Methods
+
+		/// Gets the size of the view.
+		UInt Length() const;
+
+		/// Checks if the view is empty.
+		bool IsEmpty() const;
+
+		/// Gets a view of a part of the view.
+		///[Arg] start: The starting index for the part.
+		StringView Sub(UInt start) const;
+
+		/// Gets a view of a part of the view.
+		///[para] The view is empty if {start} is after {end} or after the end of the view.
+		///[Arg] start: The starting index for the part.
+		///[Arg] end: The ending index for the part.
+		/// The part ends at the end of the view if {end} is after it.
+		StringView Sub(UInt start, UInt end) const;
+
+		/// Finds the position of the specified character.
+		///[Arg] start: The position to start the search at.
+		///[Returns] Optional<UInt>: The position of the view where {c} was found.
+		///[para] Does not contain a value if {c} was not found.
+		Optional<UInt> Find(const char c, const UInt start = 0) const;
+
+		/// Copies the characters of the view to a new string.
+		String ToString() const;
+
+		/// Gets a pointer to the first character of the view.
+		///[Warning] The characters are not null terminated.
+		const char* Data() const;
+
+		///[Heading] Operators
+
+		void operator=(const StringView& view);
+
+		/// Compares two views to check if they contain the same characters.
+		bool operator==(const StringView& view) const;
+
+		/// Compares two views to check if they do not contain the same characters.
+		bool operator!=(const StringView& view) const;
+
+		/// Compares the view with a null terminated {char} array to check if they contain the same characters.
+		bool operator==(const char* const str) const;
+
+		/// Compares the view with a null terminated {char} array to check if they do not contain the same characters.
+		bool operator!=(const char* const str) const;
+
+		/// Gets the character at the specified position of the view.
+		char operator[](const UInt i) const;
+
+		/// Copies the characters of the view to a new string.
+		operator String() const;
+
+		///[Heading] Iterators
+
+		/// Iterates over each {char} in the view.
+		///[Code] for (char c : view)
+		const char* begin() const;
+		const char* end() const;
+
+	private:
+		const char* str;
+		UInt len;
+	};
+
+	inline StringView::StringView() {
+		str = "";
+		len = 0;
+	}
+
+	inline StringView::StringView(const char* const str) {
+		this->str = str;
+		len = (UInt)std::strlen(str);
+	}
+
+	inline StringView::StringView(const char* const str, const UInt length) {
+		this->str = str;
+		len = length;
+	}
+
+	inline StringView::StringView(const String& str) {
+		this->str = (const char*)str;
+		len = str.Length();
+	}
+
+	inline StringView::StringView(const StringView& view) {
+		str = view.str;
+		len = view.len;
+	}
+
+	inline StringView::~StringView() {
+
+	}
+
+	inline UInt StringView::Length() const {
+		return len;
+	}
+
+	inline bool StringView::IsEmpty() const {
+		return len == 0;
+	}
+
+	inline StringView StringView::Sub(UInt start) const {
+		if (start > len) start = len;
+		return StringView(str + start, len - start);
+	}
+
+	inline StringView StringView::Sub(UInt start, UInt end) const {
+		if (len == 0 || start >= len || end < start) {
+			return StringView(str + (start < len ? start : len), 0);
+		}
+
+		if (end >= len) end = len - 1;
+		return StringView(str + start, end - start + 1);
+	}
+
+	inline Optional<UInt> StringView::Find(const char c, const UInt start) const {
+		if (start >= len) return nullptr;
+
+		if (const char* const found = (const char*)std::memchr(str + start, c, len - start)) {
+			return (UInt)(found - str);
+		}
+
+		return nullptr;
+	}
+
+	inline String StringView::ToString() const {
+		return String(str, len);
+	}
+
+	inline const char* StringView::Data() const {
+		return str;
+	}
+
+	inline void StringView::operator=(const StringView& view) {
+		str = view.str;
+		len = view.len;
+	}
+
+	inline bool StringView::operator==(const StringView& view) const {
+		return len == view.len && std::memcmp(str, view.str, len) == 0;
+	}
+
+	inline bool StringView::operator!=(const StringView& view) const {
+		return !operator==(view);
+	}
+
+	inline bool StringView::operator==(const char* const str) const {
+		return operator==(StringView(str));
+	}
+
+	inline bool StringView::operator!=(const char* const str) const {
+		return !operator==(str);
+	}
+
+	inline char StringView::operator[](const UInt i) const {
+		return str[i];
+	}
+
+	inline StringView::operator String() const {
+		return String(str, len);
+	}
+
+	inline const char* StringView::begin() const {
+		return str;
+	}
+
+	inline const char* StringView::end() const {
+		return str + len;
+	}
+
+	inline bool operator==(const char* const str, const StringView& view) {
+		return view == str;
+	}
+
+	inline bool operator!=(const char* const str, const StringView& view) {
+		return view != str;
+	}
+
+	inline bool operator==(const String& str, const StringView& view) {
+		return view == StringView(str);
+	}
+
+	inline bool operator==(const StringView& view, const String& str) {
+		return view == StringView(str);
+	}
+
+	inline bool operator!=(const String& str, const StringView& view) {
+		return view != StringView(str);
+	}
+
+	inline bool operator!=(const StringView& view, const String& str) {
+		return view != StringView(str);
+	}
+}
+
+#endif
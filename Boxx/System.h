@@ -6,13 +6,31 @@
 #include "Array.h"
 #include "List.h"
 #include "Error.h"
+#include "File.h"
+#include "Pointer.h"
+#include "Glob.h"
 
 #include <filesystem>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <atomic>
+
+#ifdef BOXX_LINUX
+#include <sys/stat.h>
+#endif
 
 ///[Settings] block: indent
 
 ///[Namespace] Boxx
 namespace Boxx {
+	class DirectoryWalker;
+	struct WalkEntry;
+	struct WalkOptions;
+
 	///[Heading] Static Classes
 
 	///[Title] System
@@ -48,6 +66,167 @@ namespace Boxx {
 
 		/// Gets a list of all directories in the specified directory.
 		static List<String> GetDirectoriesInDirectory(const String& directory);
+
+		/// Walks through all files in a directory and its subdirectories.
+		/// Subdirectories are scanned in parallel while the entries are being iterated over.
+		///[para] The order of the entries is not specified.
+		///[Error] FileNotFoundError: Thrown if the directory was not found.
+		///[Code] for (const WalkEntry& entry : System::Walk(directory))
+		static DirectoryWalker Walk(const String& directory, const WalkOptions& options);
+
+		/// Walks through all files in a directory and its subdirectories.
+		static DirectoryWalker Walk(const String& directory);
+
+		/// Walks through all files in a directory and its subdirectories and calls a function for each entry.
+		/// Subdirectories are scanned in parallel but the function is only called from the calling thread.
+		///[para] The order of the entries is not specified.
+		///[Error] FileNotFoundError: Thrown if the directory was not found.
+		static void Walk(const String& directory, const WalkOptions& options, const std::function<void(const WalkEntry&)>& func);
+	};
+
+	///[Title] WalkEntry
+	/// Contains info about a file or directory found by {System::Walk}.
+	///[Block] WalkEntry
+	struct WalkEntry {
+		/// The path of the entry starting with the directory that is walked.
+		String path;
+
+		/// The path of the entry relative to the directory that is walked.
+		String relativePath;
+
+		/// {true} if the entry is a directory.
+		bool isDirectory{};
+
+		/// The size of the file in bytes.
+		///[para] Only set if {WalkOptions::stat} is {true}.
+		ULong size{};
+
+		/// The time of the last modification of the entry.
+		///[para] Only set if {WalkOptions::stat} is {true}.
+		std::filesystem::file_time_type lastModified{};
+	};
+
+	///[Title] WalkOptions
+	/// Options for {System::Walk}.
+	///[Block] WalkOptions
+	struct WalkOptions {
+		/// The file extensions to include without the {.}.
+		///[para] Files with any extension are included if the list is empty.
+		List<String> extensions;
+
+		/// Glob patterns that the relative paths of the files are matched against.
+		/// Patterns without a {/} are matched against the file names.
+		/// See {GlobPattern} for the pattern syntax.
+		///[para] Files are included if they match any of the patterns.
+		/// All files are included if the list is empty.
+		List<String> patterns;
+
+		/// Includes the directories as entries.
+		bool directories = false;
+
+		/// Reads the size and modification time of each entry.
+		bool stat = false;
+
+		/// Walks through symbolic links to directories.
+		///[para] A directory reached through several links is walked once for each link.
+		/// A link to a directory that contains the link is included as an entry but is not walked through so link cycles end.
+		bool followSymlinks = false;
+
+		/// The maximum depth of subdirectories to walk through.
+		/// {0} only includes the entries of the directory itself.
+		UInt maxDepth = 0xFFFFFFFF;
+
+		/// The number of threads to scan directories with.
+		/// Uses one thread for each hardware thread if {0}.
+		UInt threads = 0;
+	};
+
+	///[Title] DirectoryWalker
+	/// Walks through a directory in parallel.
+	/// Created by {System::Walk}.
+	///[para] Entries are scanned ahead of the iteration and kept in a queue of limited size.
+	/// The scanning threads wait if the queue is full so large directory trees are never held in memory.
+	///[Block] DirectoryWalker
+	class DirectoryWalker final {
+	public:
+		DirectoryWalker(const String& directory, const WalkOptions& options);
+		DirectoryWalker(const DirectoryWalker& walker);
+		DirectoryWalker(DirectoryWalker&& walker) noexcept;
+		~DirectoryWalker();
+
+		///[Heading] Methods
+
+		/// Gets the next entry.
+		///[Returns] bool: {false} if there are no more entries.
+		bool Next(WalkEntry& entry);
+
+		void operator=(const DirectoryWalker& walker);
+		void operator=(DirectoryWalker&& walker) noexcept;
+
+		///[Heading] Iterators
+
+		class Iterator {
+		public:
+			Iterator();
+			Iterator(DirectoryWalker* const walker);
+			~Iterator() {}
+
+			const WalkEntry& operator*() const;
+			Iterator& operator++();
+			bool operator!=(const Iterator& iterator) const;
+
+		private:
+			DirectoryWalker* walker;
+			WalkEntry entry;
+		};
+
+		/// Iterates over all entries.
+		///[Code] for (const WalkEntry& entry : walker)
+		Iterator begin();
+		Iterator end();
+
+	private:
+		struct Directory {
+			String path;
+			String relativePath;
+			UInt depth;
+
+#ifdef BOXX_LINUX
+			// The device and inode of the directory and its parents if symbolic links are followed
+			std::vector<std::pair<ULong, ULong>> ancestors;
+#else
+			// The canonical path of the directory and its parents if symbolic links are followed
+			std::vector<std::string> ancestors;
+#endif
+		};
+
+		struct State {
+			WalkOptions options;
+			GlobSet patterns;
+
+			std::vector<Directory> directories;
+			std::deque<WalkEntry> entries;
+			UInt scanning = 0;
+			std::atomic<bool> stopped{false};
+
+			std::mutex mutex;
+			std::condition_variable workCondition;
+			std::condition_variable entryCondition;
+			std::vector<std::thread> threads;
+
+			~State();
+		};
+
+		static const UInt queueSize = 1 << 12;
+		static const UInt batchSize = 1 << 8;
+
+		Pointer<State> state;
+
+		static void Work(State* const state);
+		static void Scan(State* const state, const Directory& directory);
+		static bool Enter(Directory& directory);
+		static void Publish(State* const state, std::vector<WalkEntry>& batch);
+		static bool IsIncluded(const State* const state, const char* const name, const UInt length, const String& relativePath);
 	};
 
 	inline void System::Execute(const String& command) {
@@ -105,6 +284,304 @@ namespace Boxx {
 
 		return dirs;
 	}
+
+	inline DirectoryWalker System::Walk(const String& directory, const WalkOptions& options) {
+		return DirectoryWalker(directory, options);
+	}
+
+	inline DirectoryWalker System::Walk(const String& directory) {
+		return DirectoryWalker(directory, WalkOptions());
+	}
+
+	inline void System::Walk(const String& directory, const WalkOptions& options, const std::function<void(const WalkEntry&)>& func) {
+		DirectoryWalker walker = DirectoryWalker(directory, options);
+		WalkEntry entry;
+
+		while (walker.Next(entry)) {
+			func(entry);
+		}
+	}
+
+	inline DirectoryWalker::DirectoryWalker(const String& directory, const WalkOptions& options) {
+		if (!System::DirectoryExists(directory)) {
+			throw FileNotFoundError("Could not find directory: " + directory);
+		}
+
+		state = new State();
+		state->options = options;
+
+		// The workers only read the lists so they must not be shared with the caller
+		state->options.extensions = options.extensions.Copy();
+		state->options.patterns = options.patterns.Copy();
+		state->patterns = GlobSet(state->options.patterns);
+
+		Directory root;
+		root.path = directory;
+		root.depth = 0;
+		state->directories.push_back(root);
+
+		UInt threads = options.threads;
+
+		if (threads == 0) {
+			threads = std::thread::hardware_concurrency();
+			if (threads == 0) threads = 1;
+		}
+
+		State* const s = (State*)state;
+
+		for (UInt i = 0; i < threads; i++) {
+			state->threads.emplace_back([s]() {
+				Work(s);
+			});
+		}
+	}
+
+	inline DirectoryWalker::DirectoryWalker(const DirectoryWalker& walker) {
+		state = walker.state;
+	}
+
+	inline DirectoryWalker::DirectoryWalker(DirectoryWalker&& walker) noexcept {
+		state = std::move(walker.state);
+	}
+
+	inline DirectoryWalker::~DirectoryWalker() {
+
+	}
+
+	inline DirectoryWalker::State::~State() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopped = true;
+		}
+
+		workCondition.notify_all();
+		entryCondition.notify_all();
+
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+	}
+
+	inline bool DirectoryWalker::Next(WalkEntry& entry) {
+		if (state == nullptr) return false;
+
+		std::unique_lock<std::mutex> lock(state->mutex);
+
+		state->entryCondition.wait(lock, [this]() {
+			return !state->entries.empty() || (state->directories.empty() && state->scanning == 0);
+		});
+
+		if (state->entries.empty()) return false;
+
+		entry = std::move(state->entries.front());
+		state->entries.pop_front();
+
+		if (state->entries.size() == queueSize - 1) {
+			state->workCondition.notify_all();
+		}
+
+		return true;
+	}
+
+	inline void DirectoryWalker::operator=(const DirectoryWalker& walker) {
+		state = walker.state;
+	}
+
+	inline void DirectoryWalker::operator=(DirectoryWalker&& walker) noexcept {
+		state = std::move(walker.state);
+	}
+
+	inline DirectoryWalker::Iterator DirectoryWalker::begin() {
+		return Iterator(this);
+	}
+
+	inline DirectoryWalker::Iterator DirectoryWalker::end() {
+		return Iterator();
+	}
+
+	inline void DirectoryWalker::Work(State* const state) {
+		while (true) {
+			Directory directory;
+
+			{
+				std::unique_lock<std::mutex> lock(state->mutex);
+
+				state->workCondition.wait(lock, [state]() {
+					return state->stopped || !state->directories.empty() || state->scanning == 0;
+				});
+
+				if (state->stopped || state->directories.empty()) return;
+
+				directory = std::move(state->directories.back());
+				state->directories.pop_back();
+				state->scanning++;
+			}
+
+			// Links back to a parent directory are not walked through so link cycles end
+			if (!state->options.followSymlinks || Enter(directory)) {
+				Scan(state, directory);
+			}
+
+			{
+				std::lock_guard<std::mutex> lock(state->mutex);
+				state->scanning--;
+
+				if (state->scanning == 0 && state->directories.empty()) {
+					state->workCondition.notify_all();
+					state->entryCondition.notify_all();
+				}
+			}
+		}
+	}
+
+	inline void DirectoryWalker::Scan(State* const state, const Directory& directory) {
+		const WalkOptions& options = state->options;
+
+		std::vector<WalkEntry> batch;
+		std::vector<Directory> subdirectories;
+		std::error_code error;
+
+		std::filesystem::directory_iterator iterator = std::filesystem::directory_iterator((const char*)directory.path, error);
+
+		const bool separator = directory.path.Length() > 0 && (directory.path[directory.path.Length() - 1] == '/' || directory.path[directory.path.Length() - 1] == '\\');
+
+		for (; !error && iterator != std::filesystem::directory_iterator(); iterator.increment(error)) {
+			const std::filesystem::directory_entry& file = *iterator;
+			const bool isDirectory = file.is_directory(error);
+			if (!isDirectory && !file.is_regular_file(error)) continue;
+
+			const std::string filename = file.path().filename().string();
+			const String relativePath = directory.relativePath.IsEmpty() ? String(filename.c_str()) : directory.relativePath + "/" + filename.c_str();
+
+			if (!isDirectory && !IsIncluded(state, filename.c_str(), (UInt)filename.size(), relativePath)) continue;
+
+			WalkEntry entry;
+			entry.path = separator ? directory.path + filename.c_str() : directory.path + "/" + filename.c_str();
+			entry.relativePath = relativePath;
+			entry.isDirectory = isDirectory;
+
+			if (isDirectory && directory.depth < options.maxDepth && (options.followSymlinks || !file.is_symlink(error))) {
+				Directory subdirectory;
+				subdirectory.path = entry.path;
+				subdirectory.relativePath = entry.relativePath;
+				subdirectory.depth = directory.depth + 1;
+				subdirectory.ancestors = directory.ancestors;
+				subdirectories.push_back(std::move(subdirectory));
+			}
+
+			if (isDirectory && !options.directories) continue;
+
+			if (options.stat) {
+				if (!isDirectory) entry.size = file.file_size(error);
+				entry.lastModified = file.last_write_time(error);
+			}
+
+			batch.push_back(std::move(entry));
+
+			if (batch.size() >= batchSize) {
+				Publish(state, batch);
+				if (state->stopped) return;
+			}
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(state->mutex);
+
+			for (Directory& subdirectory : subdirectories) {
+				state->directories.push_back(std::move(subdirectory));
+			}
+		}
+
+		if (!subdirectories.empty()) {
+			state->workCondition.notify_all();
+		}
+
+		Publish(state, batch);
+	}
+
+	inline bool DirectoryWalker::Enter(Directory& directory) {
+#ifdef BOXX_LINUX
+		struct stat info;
+		if (stat((const char*)directory.path, &info) != 0) return true;
+
+		const std::pair<ULong, ULong> id = std::pair<ULong, ULong>((ULong)info.st_dev, (ULong)info.st_ino);
+#else
+		std::error_code error;
+		const std::string id = std::filesystem::canonical((const char*)directory.path, error).string();
+		if (error) return true;
+#endif
+
+		for (const auto& ancestor : directory.ancestors) {
+			if (ancestor == id) return false;
+		}
+
+		directory.ancestors.push_back(id);
+		return true;
+	}
+
+	inline void DirectoryWalker::Publish(State* const state, std::vector<WalkEntry>& batch) {
+		if (batch.empty()) return;
+
+		std::unique_lock<std::mutex> lock(state->mutex);
+
+		state->workCondition.wait(lock, [state]() {
+			return state->stopped || state->entries.size() < queueSize;
+		});
+
+		for (WalkEntry& entry : batch) {
+			state->entries.push_back(std::move(entry));
+		}
+
+		batch.clear();
+		state->entryCondition.notify_one();
+	}
+
+	inline bool DirectoryWalker::IsIncluded(const State* const state, const char* const name, const UInt length, const String& relativePath) {
+		const WalkOptions& options = state->options;
+
+		if (!options.extensions.IsEmpty()) {
+			bool found = false;
+
+			for (const String& ext : options.extensions) {
+				const UInt extLength = ext.Length();
+
+				if (length > extLength && name[length - extLength - 1] == '.' && std::memcmp(name + length - extLength, (const char*)ext, extLength) == 0) {
+					found = true;
+					break;
+				}
+			}
+
+			if (!found) return false;
+		}
+
+		return state->patterns.IsEmpty() || state->patterns.Match(relativePath);
+	}
+
+	inline DirectoryWalker::Iterator::Iterator() {
+		walker = nullptr;
+	}
+
+	inline DirectoryWalker::Iterator::Iterator(DirectoryWalker* const walker) : walker(walker) {
+		if (!walker->Next(entry)) {
+			this->walker = nullptr;
+		}
+	}
+
+	inline DirectoryWalker::Iterator& DirectoryWalker::Iterator::operator++() {
+		if (!walker->Next(entry)) {
+			walker = nullptr;
+		}
+
+		return *this;
+	}
+
+	inline const WalkEntry& DirectoryWalker::Iterator::operator*() const {
+		return entry;
+	}
+
+	inline bool DirectoryWalker::Iterator::operator!=(const Iterator& iterator) const {
+		return walker != iterator.walker;
+	}
 }
 
 #endif
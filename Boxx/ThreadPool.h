@@ -0,0 +1,153 @@
+#ifndef _BOXX_THREADPOOL_HEADER
+#define _BOXX_THREADPOOL_HEADER
+
+#include "Types.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <functional>
+#include <memory>
+#include <queue>
+#include <vector>
+
+///[Settings] block: indent
+
+///[Namespace] Boxx
+namespace Boxx {
+	///[Heading] Threads
+
+	///[Title] ThreadPool
+	/// A pool of worker threads that run queued tasks.
+	///[Block] ThreadPool
+	class ThreadPool final {
+	public:
+		///[Heading] Constructors
+
+		/// Creates a thread pool.
+		///[Arg] threads: The number of worker threads.
+		/// Uses one thread for each hardware thread if {0}.
+		explicit ThreadPool(const UInt threads = 0);
+
+		ThreadPool(const ThreadPool& pool) = delete;
+
+		/// Waits for all queued tasks to finish before the threads are stopped.
+		~ThreadPool();
+
+		///[Heading] Methods
+
+		/// Adds a task to the queue.
+		///[Returns] std::future: Contains the return value of the task when the task is done.
+		/// Any exception thrown by the task is rethrown by the future.
+		///M
+		template <class F>
+		auto Run(F task) -> std::future<decltype(task())>;
+		///M
+
+		/// Gets the number of worker threads.
+		UInt ThreadCount() const;
+
+		void operator=(const ThreadPool& pool) = delete;
+
+		///[Heading] Static Functions
+
+		/// Gets a shared thread pool with one thread for each hardware thread.
+		static ThreadPool& Default();
+
+		/// Gets a small shared thread pool for tasks that spend most of their time waiting on I/O.
+		static ThreadPool& IO();
+
+	private:
+		std::vector<std::thread> threads;
+		std::queue<std::function<void()>> tasks;
+		std::mutex mutex;
+		std::condition_variable condition;
+		bool stopping = false;
+
+		void Work();
+	};
+
+	inline ThreadPool::ThreadPool(const UInt threads) {
+		UInt count = threads;
+
+		if (count == 0) {
+			count = std::thread::hardware_concurrency();
+			if (count == 0) count = 1;
+		}
+
+		for (UInt i = 0; i < count; i++) {
+			this->threads.emplace_back([this]() {
+				Work();
+			});
+		}
+	}
+
+	inline ThreadPool::~ThreadPool() {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			stopping = true;
+		}
+
+		condition.notify_all();
+
+		for (std::thread& thread : threads) {
+			thread.join();
+		}
+	}
+
+	template <class F>
+	inline auto ThreadPool::Run(F task) -> std::future<decltype(task())> {
+		typedef decltype(task()) R;
+
+		std::shared_ptr<std::packaged_task<R()>> packaged = std::make_shared<std::packaged_task<R()>>(std::move(task));
+		std::future<R> future = packaged->get_future();
+
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			tasks.emplace([packaged]() {
+				(*packaged)();
+			});
+		}
+
+		condition.notify_one();
+		return future;
+	}
+
+	inline UInt ThreadPool::ThreadCount() const {
+		return (UInt)threads.size();
+	}
+
+	inline ThreadPool& ThreadPool::Default() {
+		static ThreadPool pool;
+		return pool;
+	}
+
+	inline ThreadPool& ThreadPool::IO() {
+		static ThreadPool pool(4);
+		return pool;
+	}
+
+	inline void ThreadPool::Work() {
+		while (true) {
+			std::function<void()> task;
+
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+
+				condition.wait(lock, [this]() {
+					return stopping || !tasks.empty();
+				});
+
+				if (tasks.empty()) return;
+
+				task = std::move(tasks.front());
+				tasks.pop();
+			}
+
+			task();
+		}
+	}
+}
+
+#endif
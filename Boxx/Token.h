@@ -5,15 +5,21 @@
 #include "String.h"
 #include "List.h"
 #include "Regex.h"
+#include "StringView.h"
+#include "Pointer.h"
 
 ///[Settings] block: indent
 
 ///[Namespace] Boxx
 namespace Boxx {
+	class Lexer;
+
 	///[Heading] Lexing
 
 	///[Title] Token
 	/// Contains info about a token.
+	///[para] The token views the lexed string and does not copy it.
+	/// The views of tokens in a {TokenList} stay valid as long as the list or a copy of it exists.
 	///[Block] Token
 	///M
 	template <class T>
@@ -22,23 +28,28 @@ namespace Boxx {
 		/// The type of the token.
 		T type{};
 
-		/// Contains the matched string for the token.
-		String value;
+		/// A view of the matched string for the token.
+		///[para] Use {StringView::ToString} to copy the value.
+		StringView value;
 
-		/// Contains the raw matched string for the token.
-		String rawValue;
+		/// A view of the raw matched string for the token.
+		StringView rawValue;
 
 		/// The line number for the token.
 		UInt line{};
 
+		/// The column of the first character of the token.
+		UInt column{};
+
 		Token() {}
 
 		/// Creates a token.
-		Token(const T type, const String& value, const String& rawValue, const UInt line = 0) {
+		Token(const T type, const StringView& value, const StringView& rawValue, const UInt line = 0, const UInt column = 0) {
 			this->type = type;
 			this->value = value;
 			this->rawValue = rawValue;
 			this->line = line;
+			this->column = column;
 		}
 	};
 
@@ -92,7 +103,7 @@ namespace Boxx {
 
 		/// Gets the current token.
 		///[Error] TokenListError: Thrown if the current position is outside the list.
-		Token<T> Current() const;
+		const Token<T>& Current() const;
 
 		/// Advances to the next token.
 		void Advance();
@@ -101,23 +112,24 @@ namespace Boxx {
 		void Advance(const UInt steps);
 
 		/// Advances to the next token and returns it.
-		Token<T> Next();
+		///[Error] TokenListError: Thrown if the position is outside the list.
+		const Token<T>& Next();
 
 		/// Get the next token without advancing.
 		///[Error] TokenListError: Thrown if the position is outside the list.
-		Token<T> PeekNext() const;
+		const Token<T>& PeekNext() const;
 
 		/// Get the token {steps} steps ahead without advancing.
 		///[Error] TokenListError: Thrown if the position is outside the list.
-		Token<T> PeekNext(const UInt steps) const;
+		const Token<T>& PeekNext(const UInt steps) const;
 
 		/// Gets the previous token.
 		///[Error] TokenListError: Thrown if the position is outside the list.
-		Token<T> PeekPrevious() const;
+		const Token<T>& PeekPrevious() const;
 
 		/// Gets the token {steps} steps back.
 		///[Error] TokenListError: Thrown if the position is outside the list.
-		Token<T> PeekPrevious(const UInt steps) const;
+		const Token<T>& PeekPrevious(const UInt steps) const;
 
 		/// Gets the current position in the token list.
 		UInt GetPos() const;
@@ -138,8 +150,13 @@ namespace Boxx {
 		void operator=(TokenList<T>&& list) noexcept;
 
 	private:
+		friend class Lexer;
+
 		List<Token<T>> list;
 		UInt pos = 0;
+
+		// The lexed string that is viewed by the tokens
+		Pointer<String> source;
 	};
 
 	///[Title] TokenListError
@@ -169,12 +186,14 @@ namespace Boxx {
 	inline TokenList<T>::TokenList(const TokenList<T>& list) {
 		this->list = list.list;
 		this->pos = list.pos;
+		this->source = list.source;
 	}
 
 	template <class T>
 	inline TokenList<T>::TokenList(TokenList<T>&& list) noexcept {
 		this->list = std::move(list.list);
 		this->pos = list.pos;
+		this->source = std::move(list.source);
 	}
 
 	template <class T>
@@ -183,7 +202,7 @@ namespace Boxx {
 	}
 
 	template <class T>
-	inline Token<T> TokenList<T>::Current() const {
+	inline const Token<T>& TokenList<T>::Current() const {
 		if (pos >= Size()) throw TokenListError("Token position out of range");
 		return list[pos];
 	}
@@ -199,32 +218,32 @@ namespace Boxx {
 	}
 
 	template <class T>
-	inline Token<T> TokenList<T>::Next() {
+	inline const Token<T>& TokenList<T>::Next() {
 		Advance();
 		return Current();
 	}
 
 	template <class T>
-	inline Token<T> TokenList<T>::PeekNext() const {
+	inline const Token<T>& TokenList<T>::PeekNext() const {
 		if (pos + 1 >= Size()) throw TokenListError("Token position out of range");
 		return list[pos + 1];
 	}
 
 	template <class T>
-	inline Token<T> TokenList<T>::PeekNext(const UInt steps) const {
+	inline const Token<T>& TokenList<T>::PeekNext(const UInt steps) const {
 		if (pos + steps >= Size()) throw TokenListError("Token position out of range");
 		return list[pos + steps];
 	}
 
 	template <class T>
-	inline Token<T> TokenList<T>::PeekPrevious() const {
+	inline const Token<T>& TokenList<T>::PeekPrevious() const {
 		if ((Long)pos - 1 < 0) throw TokenListError("Token position out of range");
 		return list[pos - 1];
 	}
 
 	template <class T>
-	inline Token<T> TokenList<T>::PeekPrevious(const UInt steps) const {
-		if ((Long)pos - steps) throw TokenListError("Token position out of range");
+	inline const Token<T>& TokenList<T>::PeekPrevious(const UInt steps) const {
+		if ((Long)pos - steps < 0) throw TokenListError("Token position out of range");
 		return list[pos - steps];
 	}
 
@@ -257,12 +276,14 @@ namespace Boxx {
 	inline void TokenList<T>::operator=(const TokenList<T>& list) {
 		this->list = list.list;
 		this->pos = list.pos;
+		this->source = list.source;
 	}
 
 	template <class T>
 	inline void TokenList<T>::operator=(TokenList<T>&& list) noexcept {
 		this->list = std::move(list.list);
 		this->pos = list.pos;
+		this->source = std::move(list.source);
 	}
 }
 